@@ -0,0 +1,386 @@
+#include "stdafx.h"
+#include "EAgentSystem.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define ELITE_AGENTS_SSE
+#endif
+
+namespace
+{
+	// The kernels are written once against these, AVX when the build enables it (/arch:AVX), SSE2 otherwise, plain floats as a fallback
+#if defined(__AVX__)
+	typedef __m256 SimdFloat;
+	const int SimdWidth = 8;
+	inline SimdFloat SimdLoad(const float* p) { return _mm256_loadu_ps(p); }
+	inline void SimdStore(float* p, SimdFloat v) { _mm256_storeu_ps(p, v); }
+	inline SimdFloat SimdSet(float f) { return _mm256_set1_ps(f); }
+	inline SimdFloat SimdAdd(SimdFloat a, SimdFloat b) { return _mm256_add_ps(a, b); }
+	inline SimdFloat SimdSub(SimdFloat a, SimdFloat b) { return _mm256_sub_ps(a, b); }
+	inline SimdFloat SimdMul(SimdFloat a, SimdFloat b) { return _mm256_mul_ps(a, b); }
+	inline SimdFloat SimdDiv(SimdFloat a, SimdFloat b) { return _mm256_div_ps(a, b); }
+	inline SimdFloat SimdMin(SimdFloat a, SimdFloat b) { return _mm256_min_ps(a, b); }
+	inline SimdFloat SimdMax(SimdFloat a, SimdFloat b) { return _mm256_max_ps(a, b); }
+	inline SimdFloat SimdSqrt(SimdFloat a) { return _mm256_sqrt_ps(a); }
+	inline SimdFloat SimdAbs(SimdFloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+	inline SimdFloat SimdLess(SimdFloat a, SimdFloat b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	inline SimdFloat SimdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) { return _mm256_blendv_ps(b, a, mask); }
+	inline SimdFloat SimdFlipSign(SimdFloat a, SimdFloat mask) { return _mm256_xor_ps(a, _mm256_and_ps(mask, _mm256_set1_ps(-0.f))); }
+#elif defined(ELITE_AGENTS_SSE)
+	typedef __m128 SimdFloat;
+	const int SimdWidth = 4;
+	inline SimdFloat SimdLoad(const float* p) { return _mm_loadu_ps(p); }
+	inline void SimdStore(float* p, SimdFloat v) { _mm_storeu_ps(p, v); }
+	inline SimdFloat SimdSet(float f) { return _mm_set1_ps(f); }
+	inline SimdFloat SimdAdd(SimdFloat a, SimdFloat b) { return _mm_add_ps(a, b); }
+	inline SimdFloat SimdSub(SimdFloat a, SimdFloat b) { return _mm_sub_ps(a, b); }
+	inline SimdFloat SimdMul(SimdFloat a, SimdFloat b) { return _mm_mul_ps(a, b); }
+	inline SimdFloat SimdDiv(SimdFloat a, SimdFloat b) { return _mm_div_ps(a, b); }
+	inline SimdFloat SimdMin(SimdFloat a, SimdFloat b) { return _mm_min_ps(a, b); }
+	inline SimdFloat SimdMax(SimdFloat a, SimdFloat b) { return _mm_max_ps(a, b); }
+	inline SimdFloat SimdSqrt(SimdFloat a) { return _mm_sqrt_ps(a); }
+	inline SimdFloat SimdAbs(SimdFloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+	inline SimdFloat SimdLess(SimdFloat a, SimdFloat b) { return _mm_cmplt_ps(a, b); }
+	inline SimdFloat SimdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+	inline SimdFloat SimdFlipSign(SimdFloat a, SimdFloat mask) { return _mm_xor_ps(a, _mm_and_ps(mask, _mm_set1_ps(-0.f))); }
+#else
+	typedef float SimdFloat;
+	const int SimdWidth = 1;
+	inline SimdFloat SimdLoad(const float* p) { return *p; }
+	inline void SimdStore(float* p, SimdFloat v) { *p = v; }
+	inline SimdFloat SimdSet(float f) { return f; }
+	inline SimdFloat SimdAdd(SimdFloat a, SimdFloat b) { return a + b; }
+	inline SimdFloat SimdSub(SimdFloat a, SimdFloat b) { return a - b; }
+	inline SimdFloat SimdMul(SimdFloat a, SimdFloat b) { return a * b; }
+	inline SimdFloat SimdDiv(SimdFloat a, SimdFloat b) { return a / b; }
+	inline SimdFloat SimdMin(SimdFloat a, SimdFloat b) { return a < b ? a : b; }
+	inline SimdFloat SimdMax(SimdFloat a, SimdFloat b) { return a > b ? a : b; }
+	inline SimdFloat SimdSqrt(SimdFloat a) { return sqrtf(a); }
+	inline SimdFloat SimdAbs(SimdFloat a) { return fabsf(a); }
+	inline SimdFloat SimdLess(SimdFloat a, SimdFloat b) { return a < b ? 1.f : 0.f; }
+	inline SimdFloat SimdSelect(SimdFloat mask, SimdFloat a, SimdFloat b) { return mask != 0.f ? a : b; }
+	inline SimdFloat SimdFlipSign(SimdFloat a, SimdFloat mask) { return mask != 0.f ? -a : a; }
+#endif
+
+	// Arrays are padded to this, the widest kernel never needs a scalar tail
+	const int AgentPadding = 8;
+
+	// Seek is arrive with a slow radius so small that every agent is outside it
+	const float NoSlowDown = 1e30f;
+
+	// atan2 as a polynomial on [0, 1] plus octant fix ups, at most 2e-4 radians off
+	inline SimdFloat SimdAtan2(SimdFloat y, SimdFloat x)
+	{
+		const SimdFloat absX = SimdAbs(x);
+		const SimdFloat absY = SimdAbs(y);
+		const SimdFloat a = SimdDiv(SimdMin(absX, absY), SimdMax(SimdMax(absX, absY), SimdSet(1e-30f)));
+		const SimdFloat s = SimdMul(a, a);
+		SimdFloat r = SimdSet(-0.0464964749f);
+		r = SimdAdd(SimdMul(r, s), SimdSet(0.15931422f));
+		r = SimdSub(SimdMul(r, s), SimdSet(0.327622764f));
+		r = SimdAdd(SimdMul(SimdMul(r, s), a), a);
+		r = SimdSelect(SimdLess(absX, absY), SimdSub(SimdSet(1.57079637f), r), r);
+		r = SimdSelect(SimdLess(x, SimdSet(0.f)), SimdSub(SimdSet(3.14159274f), r), r);
+		return SimdFlipSign(r, SimdLess(y, SimdSet(0.f)));
+	}
+
+	float LerpAngle(float from, float to, float alpha)
+	{
+		const float pi = static_cast<float>(E_PI);
+		float delta = to - from;
+		while (delta > pi)
+			delta -= 2.f * pi;
+		while (delta < -pi)
+			delta += 2.f * pi;
+		return from + delta * alpha;
+	}
+}
+
+namespace Elite
+{
+	AgentSystem::AgentSystem(AgentSimulation simulation, float neighbourCellSize)
+		: m_Simulation(simulation)
+		, m_Neighbours(neighbourCellSize)
+	{
+	}
+
+	int AgentSystem::AddAgent(const Vector2& position, float radius, float maxSpeed)
+	{
+		const int agent = m_NrOfAgents;
+		Resize(m_NrOfAgents + 1);
+
+		m_PositionsX[agent] = m_PreviousX[agent] = m_TargetsX[agent] = position.x;
+		m_PositionsY[agent] = m_PreviousY[agent] = m_TargetsY[agent] = position.y;
+		m_Radii[agent] = radius;
+		m_MaxSpeeds[agent] = maxSpeed;
+
+		if (m_Simulation == AgentSimulation::eKinematic)
+		{
+			m_MaxRadius = radius > m_MaxRadius ? radius : m_MaxRadius;
+			m_AreNeighboursSorted = false;
+			return agent;
+		}
+
+		//Same body as a BaseAgent
+		const RigidBodyDefine define = RigidBodyDefine(0.01f, 0.1f, eDynamic, false);
+		m_pBodies[agent] = new RigidBody(define, Transform(position, ZeroVector2));
+		EPhysicsCircleShape shape;
+		shape.radius = radius;
+		m_pBodies[agent]->AddShape(&shape);
+		return agent;
+	}
+
+	void AgentSystem::RemoveAgent(int agent)
+	{
+		assert(agent >= 0 && agent < m_NrOfAgents && "<AgentSystem::RemoveAgent>: invalid agent");
+		SAFE_DELETE(m_pBodies[agent]);
+		m_AreNeighboursSorted = false;
+
+		const int last = m_NrOfAgents - 1;
+		if (agent != last)
+			MoveAgent(last, agent);
+		m_pBodies[last] = nullptr;
+		Resize(last);
+	}
+
+	void AgentSystem::Clear()
+	{
+		for (RigidBody*& pBody : m_pBodies)
+			SAFE_DELETE(pBody);
+		m_AreNeighboursSorted = false;
+		m_MaxRadius = 0.f;
+		Resize(0);
+		ClearPaths();
+	}
+
+	void AgentSystem::SetAllTargets(const Vector2& target)
+	{
+		std::fill(m_TargetsX.begin(), m_TargetsX.begin() + m_NrOfAgents, target.x);
+		std::fill(m_TargetsY.begin(), m_TargetsY.begin() + m_NrOfAgents, target.y);
+	}
+
+	void AgentSystem::SetPath(int agent, const std::vector<Vector2>& path)
+	{
+		assert(agent >= 0 && agent < m_NrOfAgents && "<AgentSystem::SetPath>: invalid agent");
+		m_PathWaypoints[agent] = static_cast<int>(m_WaypointsX.size());
+		for (const Vector2& waypoint : path)
+		{
+			m_WaypointsX.push_back(waypoint.x);
+			m_WaypointsY.push_back(waypoint.y);
+		}
+		m_PathEnds[agent] = static_cast<int>(m_WaypointsX.size());
+	}
+
+	void AgentSystem::ClearPaths()
+	{
+		m_WaypointsX.clear();
+		m_WaypointsY.clear();
+		std::fill(m_PathEnds.begin(), m_PathEnds.end(), 0);
+		std::fill(m_PathWaypoints.begin(), m_PathWaypoints.end(), 0);
+	}
+
+	void AgentSystem::Seek()
+	{
+		std::fill(m_InvSlowRadii.begin(), m_InvSlowRadii.end(), NoSlowDown);
+		std::fill(m_ArrivalRadii.begin(), m_ArrivalRadii.end(), 0.f);
+		Steer();
+	}
+
+	void AgentSystem::Arrive(float slowRadius, float arrivalRadius)
+	{
+		assert(slowRadius > 0.f && "<AgentSystem::Arrive>: slow radius has to be positive");
+		std::fill(m_InvSlowRadii.begin(), m_InvSlowRadii.end(), 1.f / slowRadius);
+		std::fill(m_ArrivalRadii.begin(), m_ArrivalRadii.end(), arrivalRadius);
+		Steer();
+	}
+
+	void AgentSystem::FollowPath(float waypointRadius, float slowRadius, float arrivalRadius)
+	{
+		assert(slowRadius > 0.f && "<AgentSystem::FollowPath>: slow radius has to be positive");
+
+		//Picking the waypoint branches per agent, it only writes the targets and parameters the kernel reads
+		const float waypointRadiusSq = waypointRadius * waypointRadius;
+		for (int agent = 0; agent < m_NrOfAgents; ++agent)
+		{
+			int& waypoint = m_PathWaypoints[agent];
+			const int end = m_PathEnds[agent];
+			if (waypoint < end)
+			{
+				const float dx = m_WaypointsX[waypoint] - m_PositionsX[agent];
+				const float dy = m_WaypointsY[waypoint] - m_PositionsY[agent];
+				if (waypoint + 1 < end && dx * dx + dy * dy <= waypointRadiusSq)
+					++waypoint;
+
+				m_TargetsX[agent] = m_WaypointsX[waypoint];
+				m_TargetsY[agent] = m_WaypointsY[waypoint];
+			}
+
+			const bool isLast = waypoint + 1 >= end;
+			m_InvSlowRadii[agent] = isLast ? 1.f / slowRadius : NoSlowDown;
+			m_ArrivalRadii[agent] = isLast ? arrivalRadius : 0.f;
+		}
+		Steer();
+	}
+
+	void AgentSystem::Steer()
+	{
+		const SimdFloat zero = SimdSet(0.f);
+		const SimdFloat one = SimdSet(1.f);
+		const SimdFloat epsilon = SimdSet(1e-6f);
+
+		const int size = static_cast<int>(m_PositionsX.size());
+		for (int i = 0; i < size; i += SimdWidth)
+		{
+			const SimdFloat dx = SimdSub(SimdLoad(&m_TargetsX[i]), SimdLoad(&m_PositionsX[i]));
+			const SimdFloat dy = SimdSub(SimdLoad(&m_TargetsY[i]), SimdLoad(&m_PositionsY[i]));
+			const SimdFloat distance = SimdSqrt(SimdAdd(SimdMul(dx, dx), SimdMul(dy, dy)));
+
+			//Full speed outside the slow radius, slower inside of it and stopped within the arrival radius
+			SimdFloat speed = SimdMul(SimdLoad(&m_MaxSpeeds[i]), SimdMin(SimdMul(distance, SimdLoad(&m_InvSlowRadii[i])), one));
+			speed = SimdSelect(SimdLess(distance, SimdLoad(&m_ArrivalRadii[i])), zero, speed);
+
+			const SimdFloat scale = SimdDiv(speed, SimdMax(distance, epsilon));
+			const SimdFloat velocityX = SimdMul(dx, scale);
+			const SimdFloat velocityY = SimdMul(dy, scale);
+			SimdStore(&m_VelocitiesX[i], velocityX);
+			SimdStore(&m_VelocitiesY[i], velocityY);
+
+			//Face the velocity, standing agents keep their orientation
+			const SimdFloat orientation = SimdAtan2(SimdSub(zero, velocityX), velocityY);
+			SimdStore(&m_Orientations[i], SimdSelect(SimdLess(epsilon, speed), orientation, SimdLoad(&m_Orientations[i])));
+		}
+	}
+
+	void AgentSystem::WriteToBodies() const
+	{
+		assert(m_Simulation == AgentSimulation::ePhysics && "<AgentSystem::WriteToBodies>: kinematic agents have no bodies");
+		for (int agent = 0; agent < m_NrOfAgents; ++agent)
+		{
+			RigidBody* pBody = m_pBodies[agent];
+			pBody->SetLinearVelocity({ m_VelocitiesX[agent], m_VelocitiesY[agent] });
+			pBody->SetTransform(Transform({ m_PositionsX[agent], m_PositionsY[agent] }, { m_Orientations[agent], m_Orientations[agent] }));
+		}
+	}
+
+	void AgentSystem::ReadFromBodies()
+	{
+		assert(m_Simulation == AgentSimulation::ePhysics && "<AgentSystem::ReadFromBodies>: kinematic agents have no bodies");
+		for (int agent = 0; agent < m_NrOfAgents; ++agent)
+		{
+			m_PreviousX[agent] = m_PositionsX[agent];
+			m_PreviousY[agent] = m_PositionsY[agent];
+			m_PreviousOrientations[agent] = m_Orientations[agent];
+
+			RigidBody* pBody = m_pBodies[agent];
+			const Vector2 position = pBody->GetPosition();
+			m_PositionsX[agent] = position.x;
+			m_PositionsY[agent] = position.y;
+			m_Orientations[agent] = pBody->GetRotation().x;
+		}
+	}
+
+	void AgentSystem::Integrate(float dt)
+	{
+		assert(m_Simulation == AgentSimulation::eKinematic && "<AgentSystem::Integrate>: physics agents are moved by the physics world");
+		std::copy(m_PositionsX.begin(), m_PositionsX.end(), m_PreviousX.begin());
+		std::copy(m_PositionsY.begin(), m_PositionsY.end(), m_PreviousY.begin());
+		std::copy(m_Orientations.begin(), m_Orientations.end(), m_PreviousOrientations.begin());
+
+		const SimdFloat step = SimdSet(dt);
+		const int size = static_cast<int>(m_PositionsX.size());
+		for (int i = 0; i < size; i += SimdWidth)
+		{
+			SimdStore(&m_PositionsX[i], SimdAdd(SimdLoad(&m_PositionsX[i]), SimdMul(SimdLoad(&m_VelocitiesX[i]), step)));
+			SimdStore(&m_PositionsY[i], SimdAdd(SimdLoad(&m_PositionsY[i]), SimdMul(SimdLoad(&m_VelocitiesY[i]), step)));
+		}
+
+		//Sorting again is only needed when agents crossed a cell border
+		m_Neighbours.Update(m_PositionsX.data(), m_PositionsY.data(), m_NrOfAgents);
+		m_AreNeighboursSorted = true;
+	}
+
+	void AgentSystem::Separate(float strength)
+	{
+		assert(m_Simulation == AgentSimulation::eKinematic && "<AgentSystem::Separate>: physics agents are separated by their contacts");
+		assert(strength > 0.f && strength <= 1.f && "<AgentSystem::Separate>: strength has to be in ]0, 1]");
+		if (!m_AreNeighboursSorted)
+		{
+			m_Neighbours.Rebuild(m_PositionsX.data(), m_PositionsY.data(), m_NrOfAgents);
+			m_AreNeighboursSorted = true;
+		}
+
+		for (int agent = 0; agent < m_NrOfAgents; ++agent)
+		{
+			//Positions move while we go, a pair sees the other's correction right away.
+			//The grid keeps the positions of before, pairs that only overlap after a correction are found next tick.
+			const Vector2 position{ m_PositionsX[agent], m_PositionsY[agent] };
+			m_Neighbours.ForEachInRadius(position, m_Radii[agent] + m_MaxRadius, [&](int other, float)
+			{
+				if (other <= agent)
+					return;
+
+				const float dx = m_PositionsX[agent] - m_PositionsX[other];
+				const float dy = m_PositionsY[agent] - m_PositionsY[other];
+				const float minDistance = m_Radii[agent] + m_Radii[other];
+				const float distanceSquared = dx * dx + dy * dy;
+				if (distanceSquared >= minDistance * minDistance)
+					return;
+
+				//Both agents take half of the correction, agents on the same spot get pushed apart along x
+				const float distance = sqrtf(distanceSquared);
+				const float correction = (minDistance - distance) * strength * 0.5f;
+				const float normalX = distance > 1e-6f ? dx / distance : 1.f;
+				const float normalY = distance > 1e-6f ? dy / distance : 0.f;
+				m_PositionsX[agent] += normalX * correction;
+				m_PositionsY[agent] += normalY * correction;
+				m_PositionsX[other] -= normalX * correction;
+				m_PositionsY[other] -= normalY * correction;
+			});
+		}
+	}
+
+	void AgentSystem::Render(float alpha, const Color& color) const
+	{
+		//All bodies on one depth and all arrows on the next, instead of two slices per agent
+		const float bodyDepth = DEBUGRENDERER2D->NextDepthSlice();
+		const float arrowDepth = DEBUGRENDERER2D->NextDepthSlice();
+		for (int agent = 0; agent < m_NrOfAgents; ++agent)
+		{
+			const Vector2 position{ m_PreviousX[agent] + (m_PositionsX[agent] - m_PreviousX[agent]) * alpha,
+				m_PreviousY[agent] + (m_PositionsY[agent] - m_PreviousY[agent]) * alpha };
+			DEBUGRENDERER2D->DrawSolidCircleInstance(position, m_Radii[agent], color, bodyDepth);
+			DEBUGRENDERER2D->DrawArrowInstance(position, m_Radii[agent], LerpAngle(m_PreviousOrientations[agent], m_Orientations[agent], alpha), { 0,0,0,1 }, arrowDepth);
+		}
+	}
+
+	void AgentSystem::Resize(int nrOfAgents)
+	{
+		m_NrOfAgents = nrOfAgents;
+		const size_t size = static_cast<size_t>((nrOfAgents + AgentPadding - 1) / AgentPadding * AgentPadding);
+
+		std::vector<float>* arrays[] = { &m_PositionsX, &m_PositionsY, &m_PreviousX, &m_PreviousY, &m_VelocitiesX, &m_VelocitiesY,
+			&m_TargetsX, &m_TargetsY, &m_Radii, &m_MaxSpeeds, &m_Orientations, &m_PreviousOrientations, &m_InvSlowRadii, &m_ArrivalRadii };
+		for (std::vector<float>* pArray : arrays)
+		{
+			pArray->resize(size, 0.f);
+			//padding behaves like an agent that stands still on its target
+			std::fill(pArray->begin() + nrOfAgents, pArray->end(), 0.f);
+		}
+		m_pBodies.resize(nrOfAgents, nullptr);
+		m_PathEnds.resize(nrOfAgents, 0);
+		m_PathWaypoints.resize(nrOfAgents, 0);
+	}
+
+	void AgentSystem::MoveAgent(int from, int to)
+	{
+		std::vector<float>* arrays[] = { &m_PositionsX, &m_PositionsY, &m_PreviousX, &m_PreviousY, &m_VelocitiesX, &m_VelocitiesY,
+			&m_TargetsX, &m_TargetsY, &m_Radii, &m_MaxSpeeds, &m_Orientations, &m_PreviousOrientations, &m_InvSlowRadii, &m_ArrivalRadii };
+		for (std::vector<float>* pArray : arrays)
+			(*pArray)[to] = (*pArray)[from];
+		m_pBodies[to] = m_pBodies[from];
+		m_PathEnds[to] = m_PathEnds[from];
+		m_PathWaypoints[to] = m_PathWaypoints[from];
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../../EliteGeometry/EPointHashGrid.h"
+
+namespace Elite
+{
+	// ePhysics: every agent has a dynamic RigidBody, velocities and orientations go to physics in one pass (WriteToBodies)
+	// and positions come back in one pass after the step (ReadFromBodies).
+	// eKinematic: agents never enter the physics world, Integrate moves them along their velocities and
+	// Separate pushes overlapping agents apart, found through a PointHashGrid instead of broadphase and contacts.
+	enum class AgentSimulation { ePhysics, eKinematic };
+
+	// Agents stored as a structure of arrays: one contiguous array per field, so the steering kernels below
+	// process 8 (AVX) or 4 (SSE) agents per instruction. Arrays are padded to a multiple of 8, the padding is never written back.
+	class AgentSystem final
+	{
+	public:
+		// the cell size of the neighbour grid should be about the diameter of an agent, or the cell size of the GridGraph they walk on
+		explicit AgentSystem(AgentSimulation simulation = AgentSimulation::ePhysics, float neighbourCellSize = 2.f);
+		~AgentSystem() { Clear(); }
+		AgentSystem(const AgentSystem&) = delete;
+		AgentSystem& operator=(const AgentSystem&) = delete;
+
+		// returns the index of the agent, targets start at its position
+		int AddAgent(const Vector2& position, float radius, float maxSpeed);
+		// the last agent takes the place of the removed one
+		void RemoveAgent(int agent);
+		void Clear();
+
+		AgentSimulation GetSimulation() const { return m_Simulation; }
+		int GetNrOfAgents() const { return m_NrOfAgents; }
+		Vector2 GetPosition(int agent) const { return { m_PositionsX[agent], m_PositionsY[agent] }; }
+		Vector2 GetVelocity(int agent) const { return { m_VelocitiesX[agent], m_VelocitiesY[agent] }; }
+		float GetOrientation(int agent) const { return m_Orientations[agent]; }
+		float GetRadius(int agent) const { return m_Radii[agent]; }
+
+		void SetTarget(int agent, const Vector2& target) { m_TargetsX[agent] = target.x; m_TargetsY[agent] = target.y; }
+		void SetAllTargets(const Vector2& target);
+		// waypoints are kept in one flat array shared by all agents, ClearPaths frees them all at once
+		void SetPath(int agent, const std::vector<Vector2>& path);
+		void ClearPaths();
+
+		//--- Steering Kernels ---
+		// write the desired velocity of every agent, orientations follow the velocity
+		void Seek();
+		void Arrive(float slowRadius, float arrivalRadius);
+		// agents with a path steer to their current waypoint and move on once they're within waypointRadius of it,
+		// they arrive at the last one, agents without a path arrive at their target
+		void FollowPath(float waypointRadius, float slowRadius, float arrivalRadius);
+
+		//--- Physics ---
+		void WriteToBodies() const;
+		// also keeps the previous state for interpolation
+		void ReadFromBodies();
+
+		//--- Kinematic ---
+		// takes the place of the physics step: keeps the previous state and moves every agent along its velocity
+		void Integrate(float dt);
+		// moves overlapping agents apart, strength is the part of every overlap resolved by one call (0, 1]
+		void Separate(float strength);
+
+		// circle and arrow instances, in between the last two ticks
+		void Render(float alpha, const Color& color) const;
+
+	private:
+		int m_NrOfAgents = 0;
+		std::vector<float> m_PositionsX, m_PositionsY;
+		std::vector<float> m_PreviousX, m_PreviousY;
+		std::vector<float> m_VelocitiesX, m_VelocitiesY;
+		std::vector<float> m_TargetsX, m_TargetsY;
+		std::vector<float> m_Radii, m_MaxSpeeds;
+		std::vector<float> m_Orientations, m_PreviousOrientations;
+		std::vector<float> m_InvSlowRadii, m_ArrivalRadii; // per agent kernel parameters
+		std::vector<RigidBody*> m_pBodies;
+
+		AgentSimulation m_Simulation;
+		PointHashGrid m_Neighbours; // kinematic only, sorted by Integrate
+		bool m_AreNeighboursSorted = false; // false again once agents are added or removed
+		float m_MaxRadius = 0.f;
+
+		std::vector<float> m_WaypointsX, m_WaypointsY;
+		std::vector<int> m_PathEnds; // one past the last waypoint, equal to m_PathWaypoints when there's no path
+		std::vector<int> m_PathWaypoints; // current waypoint
+
+		void Resize(int nrOfAgents);
+		void MoveAgent(int from, int to);
+		void Steer(); // desired velocities and orientations from the targets and kernel parameters
+	};
+}
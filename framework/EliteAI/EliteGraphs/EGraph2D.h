@@ -9,6 +9,7 @@
 #include "EIGraph.h"
 #include "EGraphConnectionTypes.h"
 #include "EGraphNodeTypes.h"
+#include "../../EliteGeometry/ESpatialHashGrid.h"
 #include <iomanip>
 
 namespace Elite
@@ -29,6 +30,14 @@ namespace Elite
 
 		void SetNodesColor(const vector<GraphNode2D*>& nodes, const Color& color);
 
+		virtual int GetNearestNodeInComponent(int idx, int component) const override;
+
+		// calls func(idx) for every node and func(from, to) for every connection whose bounds overlap the area, connections of undirected graphs once
+		template<class T_Function>
+		void ForEachNodeInArea(const Rect& area, const T_Function& func) const;
+		template<class T_Function>
+		void ForEachConnectionInArea(const Rect& area, const T_Function& func) const;
+
 	private:
 		// functions
 		void OnLeftMouseButtonPressed(const MouseData& mouseData);
@@ -38,11 +47,24 @@ namespace Elite
 		int GetNodeIdxAtPosition(const Vector2& pos) const;
 		T_ConnectionType* GetConnectionAtPosition(const Vector2& pos) const;
 
+		// Spatial index: rebuilt when the structure version of the graph changes, a dragged node is moved in it every frame
+		void UpdateSpatialIndex() const;
+		void MoveNodeInSpatialIndex(int idx);
+		Rect GetNodeBounds(int idx) const;
+		Rect GetConnectionBounds(int from, int to) const;
+
 		// variables
 		int m_SelectedNodeIdx = -1;
 		bool m_IsLeftMouseButtonDown = false;
 		Vector2 m_MousePos;
+		const float m_NodeSelectionMargin = 1.5f; // times the node radius
 		const float m_ConnectionSelectionOffset = 1.f;
+
+		mutable SpatialHashGrid<int> m_NodeGrid{ 20.f };
+		mutable SpatialHashGrid<std::pair<int, int>> m_ConnectionGrid{ 20.f }; // undirected graphs only store from < to
+		mutable vector<int> m_NodeHandles;
+		mutable vector<vector<int>> m_ConnectionHandles; // per node, the connections that start or end there
+		mutable unsigned int m_SpatialIndexVersion = 0;
 	};
 
 	template<class T_NodeType, class T_ConnectionType>
@@ -90,7 +112,8 @@ namespace Elite
 			if (m_IsLeftMouseButtonDown)
 			{
 				DEBUGRENDERER2D->DrawCircle(nodePos, GetNodeRadius(GetNode(m_SelectedNodeIdx)), { 1,1,1 }, -1);
-				m_Nodes[m_SelectedNodeIdx]->SetPosition(m_MousePos);
+				GetNodeForWriting(m_SelectedNodeIdx)->SetPosition(m_MousePos);
+				MoveNodeInSpatialIndex(m_SelectedNodeIdx);
 			}
 
 			if (!m_IsLeftMouseButtonDown)
@@ -103,9 +126,9 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	void Graph2D<T_NodeType, T_ConnectionType>::SetConnectionCostsToDistance()
 	{
-		for (auto& connectionList : m_Connections)
+		for (int idx = 0; idx < GetNrOfNodes(); ++idx)
 		{
-			for (auto& connection : connectionList)
+			for (auto& connection : GetNodeConnectionsForWriting(idx))
 			{
 				auto posFrom = GetNodePos(connection->GetFrom());
 				auto posTo = GetNodePos(connection->GetTo());
@@ -120,7 +143,7 @@ namespace Elite
 		for (auto& n : nodes)
 		{
 			if (n)
-				m_Nodes[n->GetIndex()]->SetColor(color);
+				GetNodeForWriting(n->GetIndex())->SetColor(color);
 		}
 	}
 
@@ -171,38 +194,149 @@ namespace Elite
 			RemoveConnection(clickedConnection->GetFrom(), clickedConnection->GetTo());
 	}
 
+	template<class T_NodeType, class T_ConnectionType>
+	template<class T_Function>
+	void Graph2D<T_NodeType, T_ConnectionType>::ForEachNodeInArea(const Rect& area, const T_Function& func) const
+	{
+		UpdateSpatialIndex();
+		m_NodeGrid.ForEachInArea(area, [&func](int, int idx) { func(idx); });
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	template<class T_Function>
+	void Graph2D<T_NodeType, T_ConnectionType>::ForEachConnectionInArea(const Rect& area, const T_Function& func) const
+	{
+		UpdateSpatialIndex();
+		m_ConnectionGrid.ForEachInArea(area, [&func](int, const std::pair<int, int>& connection) { func(connection.first, connection.second); });
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	int Graph2D<T_NodeType, T_ConnectionType>::GetNearestNodeInComponent(int idx, int component) const
+	{
+		UpdateSpatialIndex();
+
+		Vector2 pos = GetNodePos(idx);
+		int handle = m_NodeGrid.FindNearest(pos, std::numeric_limits<float>::infinity(), [this, &pos, component](int nodeIdx)
+			{
+				if (GetComponent(nodeIdx) != component)
+					return std::numeric_limits<float>::infinity();
+
+				return Distance(pos, GetNodePos(nodeIdx));
+			});
+
+		return handle == -1 ? invalid_node_index : m_NodeGrid.GetValue(handle);
+	}
+
 	template<class T_NodeType, class T_ConnectionType>
 	int Graph2D<T_NodeType, T_ConnectionType>::GetNodeIdxAtPosition(const Vector2& pos) const
 	{
-		float posErrorMargin = 1.5f;
-		auto foundIt = find_if(m_Nodes.begin(), m_Nodes.end(),
-			[pos, posErrorMargin, this](GraphNode2D* pNode)
-		{ return (pNode->GetPosition() - pos).MagnitudeSquared() < pow(posErrorMargin * GetNodeRadius(pNode), 2); });
+		UpdateSpatialIndex();
 
-		if (foundIt != m_Nodes.end())
-			return (*foundIt)->GetIndex();
-		else
-			return invalid_node_index;
+		int nearestIdx = invalid_node_index;
+		float nearestDistanceSquared = std::numeric_limits<float>::infinity();
+		m_NodeGrid.ForEachInArea(Rect{ pos, 0.f, 0.f }, [this, &pos, &nearestIdx, &nearestDistanceSquared](int, int idx)
+			{
+				float selectionRadius = m_NodeSelectionMargin * GetNodeRadius(GetNode(idx));
+				float distanceSquared = DistanceSquared(GetNodePos(idx), pos);
+				if (distanceSquared < selectionRadius * selectionRadius && distanceSquared < nearestDistanceSquared)
+				{
+					nearestDistanceSquared = distanceSquared;
+					nearestIdx = idx;
+				}
+			});
+
+		return nearestIdx;
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
 	T_ConnectionType* Graph2D<T_NodeType, T_ConnectionType>::GetConnectionAtPosition(const Vector2& pos) const
 	{
-		GraphConnection2D* result = nullptr;
-		for (auto connectionList : m_Connections)
-		{
-			for (auto connection : connectionList)
+		UpdateSpatialIndex();
+
+		float selectionRadius = sqrtf(m_ConnectionSelectionOffset);
+		std::pair<int, int> nearestConnection{ invalid_node_index, invalid_node_index };
+		float nearestDistanceSquared = m_ConnectionSelectionOffset;
+		m_ConnectionGrid.ForEachInArea(Rect{ pos - Vector2{ selectionRadius, selectionRadius }, 2.f * selectionRadius, 2.f * selectionRadius },
+			[this, &pos, &nearestConnection, &nearestDistanceSquared](int, const std::pair<int, int>& connection)
 			{
-				auto segmentStart = GetNodePos(connection->GetTo());
-				auto segmentEnd =	GetNodePos(connection->GetFrom());
+				auto projectedPoint = ProjectOnLineSegment(GetNodePos(connection.second), GetNodePos(connection.first), pos);
+				float distanceSquared = DistanceSquared(projectedPoint, pos);
+				if (distanceSquared < nearestDistanceSquared)
+				{
+					nearestDistanceSquared = distanceSquared;
+					nearestConnection = connection;
+				}
+			});
+
+		if (nearestConnection.first == invalid_node_index)
+			return nullptr;
+
+		return GetConnection(nearestConnection.first, nearestConnection.second);
+	}
 
-				auto projectedPoint = ProjectOnLineSegment(segmentStart, segmentEnd, pos);
+	template<class T_NodeType, class T_ConnectionType>
+	void Graph2D<T_NodeType, T_ConnectionType>::UpdateSpatialIndex() const
+	{
+		if (m_SpatialIndexVersion == GetStructureVersion() && static_cast<int>(m_NodeHandles.size()) == GetNrOfNodes())
+			return;
+
+		m_NodeGrid.Clear();
+		m_ConnectionGrid.Clear();
+		m_NodeHandles.assign(GetNrOfNodes(), invalid_node_index);
+		m_ConnectionHandles.assign(GetNrOfNodes(), {});
+
+		for (int idx = 0; idx < GetNrOfNodes(); ++idx)
+		{
+			if (GetNode(idx)->GetIndex() == invalid_node_index)
+				continue;
+
+			m_NodeHandles[idx] = m_NodeGrid.Insert(idx, GetNodeBounds(idx));
+			for (auto connection : GetNodeConnections(idx))
+			{
+				int to = connection->GetTo();
+				if (!m_IsDirectionalGraph && to < idx)
+					continue;
 
-				if (DistanceSquared(projectedPoint, pos) < m_ConnectionSelectionOffset)
-					result = connection;
+				int handle = m_ConnectionGrid.Insert({ idx, to }, GetConnectionBounds(idx, to));
+				m_ConnectionHandles[idx].push_back(handle);
+				m_ConnectionHandles[to].push_back(handle);
 			}
 		}
 
-		return result;
+		m_SpatialIndexVersion = GetStructureVersion();
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void Graph2D<T_NodeType, T_ConnectionType>::MoveNodeInSpatialIndex(int idx)
+	{
+		//a rebuild already has the new position
+		if (m_SpatialIndexVersion != GetStructureVersion() || static_cast<int>(m_NodeHandles.size()) != GetNrOfNodes())
+		{
+			UpdateSpatialIndex();
+			return;
+		}
+
+		m_NodeGrid.Move(m_NodeHandles[idx], GetNodeBounds(idx));
+		for (int handle : m_ConnectionHandles[idx])
+		{
+			const std::pair<int, int>& connection = m_ConnectionGrid.GetValue(handle);
+			m_ConnectionGrid.Move(handle, GetConnectionBounds(connection.first, connection.second));
+		}
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	Rect Graph2D<T_NodeType, T_ConnectionType>::GetNodeBounds(int idx) const
+	{
+		float selectionRadius = m_NodeSelectionMargin * GetNodeRadius(GetNode(idx));
+		return Rect{ GetNodePos(idx) - Vector2{ selectionRadius, selectionRadius }, 2.f * selectionRadius, 2.f * selectionRadius };
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	Rect Graph2D<T_NodeType, T_ConnectionType>::GetConnectionBounds(int from, int to) const
+	{
+		Vector2 fromPos = GetNodePos(from);
+		Vector2 toPos = GetNodePos(to);
+		Vector2 bottomLeft{ fromPos.x < toPos.x ? fromPos.x : toPos.x, fromPos.y < toPos.y ? fromPos.y : toPos.y };
+		return Rect{ bottomLeft, abs(fromPos.x - toPos.x), abs(fromPos.y - toPos.y) };
 	}
-}
+}
\ No newline at end of file
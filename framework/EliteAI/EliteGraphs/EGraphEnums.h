@@ -12,4 +12,19 @@ enum class TerrainType : int
 	Mud = 3,
 	// Node's with a value of over 200 000 are always isolated
 	Water = 200001
-};
\ No newline at end of file
+};
+
+// What a pathfinder does when the goal lies in another connected component than the start
+enum class UnreachableGoal
+{
+	reject,		// return an empty path without searching
+	redirect	// search for the closest node to the goal that can be reached instead
+};
+
+// How AStar and JPS keep their open list
+enum class OpenList
+{
+	linearScan,	// unsorted, scanned for the best record every step
+	binaryHeap,
+	bucketQueue	// one bucket per whole number f-cost, needs a graph with a cost scale (IGraph::GetCostScale), uses the binary heap otherwise
+};
@@ -9,6 +9,7 @@
 #include "EIGraph.h"
 #include "EGraphConnectionTypes.h"
 #include "EGraphNodeTypes.h"
+#include "framework/EliteHelpers/ECopyOnWriteArray.h"
 
 namespace Elite
 {
@@ -18,13 +19,18 @@ namespace Elite
 	public:
 		GridGraph(int columns, int rows, int cellSize, bool isDirectionalGraph, bool isConnectedDiagonally, float costStraight = 1.f, float costDiagonal = 1.5);
 
+		// Shares its cells, clearances, region versions and edit log with this grid in chunks until either of them is edited,
+		// so cloning is O(1) (see IGraph(const IGraph&))
+		virtual shared_ptr<IGraph<T_NodeType, T_ConnectionType>> Clone() const override;
+
 		using IGraph::GetNode;
-		T_NodeType* GetNode(int col, int row) const { return m_Nodes[GetIndex(col, row)]; }
-		const ConnectionList& GetConnections(const T_NodeType& node) const { return m_Connections[node.GetIndex()]; }
-		const ConnectionList& GetConnections(int idx) const { return m_Connections[idx]; }
+		T_NodeType* GetNode(int col, int row) const { return GetNode(GetIndex(col, row)); }
+		const ConnectionList& GetConnections(const T_NodeType& node) const { return GetNodeConnections(node.GetIndex()); }
+		const ConnectionList& GetConnections(int idx) const { return GetNodeConnections(idx); }
 
 		int GetRows() const { return m_NrOfRows; }
 		int GetColumns() const { return m_NrOfColumns; }
+		int GetCellSize() const { return m_CellSize; }
 
 		bool IsWithinBounds(int col, int row) const;
 		int GetIndex(int col, int row) const { return row * m_NrOfColumns + col; }
@@ -40,17 +46,58 @@ namespace Elite
 
 		int GetNodeFromWorldPos(Vector2 pos = ZeroVector2) const;
 
-		void UnIsolateNode(int idx);
+		// searches outwards from the node ring by ring instead of visiting every node
+		virtual int GetNearestNodeInComponent(int idx, int component) const override;
+
+		// Isolating, unisolating or changing the terrain of a node bumps the version of the region it lies in,
+		// also when it's done through an IGraph pointer
+		virtual void IsolateNode(int idx) override;
+		virtual void UnIsolateNode(int idx) override;
+		virtual void SetTerrainType(int idx, TerrainType terrain) override;
+
+		// Regions are square blocks of cells that keep a version counter, used to invalidate cached data (paths, fields, ...)
+		int GetRegionSize() const { return m_RegionSize; }
+		void SetRegionSize(int regionSize);
+		int GetNrOfRegions() const { return int(m_RegionVersions.GetSize()); }
+		int GetRegionIndex(int idx) const;
+		unsigned int GetRegionVersion(int regionIdx) const { return m_RegionVersions[regionIdx]; }
+
+		// Every edit gets a stamp, incremental algorithms can ask which nodes were edited since the stamp they last saw
+		// Returns false when the edit log no longer reaches back that far, the caller should then rebuild from scratch
+		unsigned int GetEditStamp() const { return m_EditStamp; }
+		bool GetEditedNodesSince(unsigned int editStamp, vector<int>& editedNodes) const;
+
+		bool IsConnectedDiagonally() const { return m_IsConnectedDiagionally; }
+
+		// Smallest factor (up to 16) that makes the straight and diagonal costs whole numbers, terrain only multiplies them by whole numbers
+		virtual float GetCostScale() const override;
+
+		// Clearance layer: per cell the Chebyshev distance (in cells) to the closest blocked cell, the outside of the grid counts as blocked.
+		// An agent covering the square of 2 * c - 1 cells around its cell fits on every cell with a clearance of at least c.
+		// Built with a two pass distance transform, edits only update the cells whose closest blocked cell changed.
+		virtual int GetClearance(int idx) const override { return m_Clearances[idx]; }
+		// clearance a round agent with this radius (in world units) needs to stand on a cell center
+		int GetClearanceForRadius(float radius) const;
 	private:
 		
 		int m_NrOfColumns;
 		int m_NrOfRows;
 		int m_CellSize;
 
+		int m_RegionSize = 8;
+		int m_NrOfRegionColumns = 0;
+		CopyOnWriteArray<unsigned int> m_RegionVersions;
+
+		static const unsigned int m_EditLogSize = 4096;
+		unsigned int m_EditStamp = 0;
+		CopyOnWriteArray<int> m_EditLog; // ring buffer, the edit with stamp s is stored at s % m_EditLogSize
+
 		bool m_IsConnectedDiagionally;
 		const float m_DefaultCostStraight;
 		const float m_DefaultCostDiagonal;
 
+		CopyOnWriteArray<int> m_Clearances;
+
 		const vector<Vector2> m_StraightDirections = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
 		const vector<Vector2> m_DiagonalDirections = { { 1, 1 }, { -1, 1 }, { -1, -1 }, { 1, -1 } };
 
@@ -59,6 +106,17 @@ namespace Elite
 		void AddConnectionsInDirections(int idx, int col, int row, vector<Vector2> directions);
 
 		float GetConnectionCost(int fromIdx, int toIdx) const;
+		void OnNodeEdited(int idx);
+
+		// clearance helpers
+		bool IsBlocked(int idx) const; // water on terrain grids, nodes without connections otherwise
+		int GetBorderClearance(int col, int row) const;
+		void BuildClearances();
+		// the node and its neighbours can have become blocked or free
+		void UpdateClearances(int idx);
+		void BlockClearance(int idx);
+		void UnblockClearance(int idx);
+		void PropagateClearances(vector<int>& openCells);
 		//void AddCheckedConnection(int idx, int neighborCol, int neighborRow, float cost);
 
 	
@@ -101,6 +159,16 @@ namespace Elite
 				AddConnectionsToAdjacentCells(idx, c, r);
 			}
 		}
+
+		SetRegionSize(m_RegionSize);
+		m_EditLog.Assign(m_EditLogSize, invalid_node_index);
+		BuildClearances();
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline shared_ptr<IGraph<T_NodeType, T_ConnectionType>> GridGraph<T_NodeType, T_ConnectionType>::Clone() const
+	{
+		return shared_ptr<GridGraph>(new GridGraph(*this));
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
@@ -122,11 +190,20 @@ namespace Elite
 		}
 	}
 
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::IsolateNode(int idx)
+	{
+		IGraph::IsolateNode(idx);
+		OnNodeEdited(idx);
+		UpdateClearances(idx);
+	}
+
 	template<class T_NodeType, class T_ConnectionType>
 	void GridGraph<T_NodeType, T_ConnectionType>::UnIsolateNode(int idx)
 	{
 		//Isolate it to make sure it was isolated
-		IsolateNode(idx);
+		IGraph::IsolateNode(idx);
+		OnNodeEdited(idx);
 
 		//Add connections from this node to the neighbouring nodes
 		Vector2 rowCol = GetNodePos(idx);
@@ -158,6 +235,72 @@ namespace Elite
 			}
 		}
 
+		UpdateClearances(idx);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::SetTerrainType(int idx, TerrainType terrain)
+	{
+		GetNodeForWriting(idx)->SetTerrainType(terrain);
+
+		//Water nodes are never connected, every other terrain gets its connections (and their costs) rebuilt
+		switch (terrain)
+		{
+		case TerrainType::Water:
+			IsolateNode(idx);
+			break;
+		default:
+			UnIsolateNode(idx);
+			break;
+		}
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::SetRegionSize(int regionSize)
+	{
+		assert(regionSize > 0 && "<GridGraph::SetRegionSize>: region size must be positive");
+
+		m_RegionSize = regionSize;
+		m_NrOfRegionColumns = (m_NrOfColumns + m_RegionSize - 1) / m_RegionSize;
+		int nrOfRegionRows = (m_NrOfRows + m_RegionSize - 1) / m_RegionSize;
+
+		//Changing the layout invalidates everything that was keyed on the old regions, so never reuse old version numbers
+		unsigned int nextVersion = 0;
+		for (size_t regionIdx = 0; regionIdx < m_RegionVersions.GetSize(); ++regionIdx)
+			if (m_RegionVersions[regionIdx] >= nextVersion)
+				nextVersion = m_RegionVersions[regionIdx] + 1;
+		m_RegionVersions.Assign(m_NrOfRegionColumns * nrOfRegionRows, nextVersion);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline int GridGraph<T_NodeType, T_ConnectionType>::GetRegionIndex(int idx) const
+	{
+		int col = idx % m_NrOfColumns;
+		int row = idx / m_NrOfColumns;
+		return (row / m_RegionSize) * m_NrOfRegionColumns + (col / m_RegionSize);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	bool GridGraph<T_NodeType, T_ConnectionType>::GetEditedNodesSince(unsigned int editStamp, vector<int>& editedNodes) const
+	{
+		unsigned int nrOfEdits = m_EditStamp - editStamp;
+		if (nrOfEdits > m_EditLogSize)
+			return false;
+
+		for (unsigned int stamp = editStamp; stamp != m_EditStamp; ++stamp)
+			editedNodes.push_back(m_EditLog[stamp % m_EditLogSize]);
+
+		return true;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void GridGraph<T_NodeType, T_ConnectionType>::OnNodeEdited(int idx)
+	{
+		int regionIdx = GetRegionIndex(idx);
+		m_RegionVersions.Set(regionIdx, m_RegionVersions[regionIdx] + 1);
+
+		m_EditLog.Set(m_EditStamp % m_EditLogSize, idx);
+		++m_EditStamp;
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
@@ -216,6 +359,251 @@ namespace Elite
 		return cost;
 	}
 
+	template<class T_NodeType, class T_ConnectionType>
+	float GridGraph<T_NodeType, T_ConnectionType>::GetCostScale() const
+	{
+		auto isWhole = [](float cost) { return abs(cost - round(cost)) < 0.001f; };
+		for (int scale = 1; scale <= 16; ++scale)
+		{
+			if (isWhole(m_DefaultCostStraight * scale) && isWhole(m_DefaultCostDiagonal * scale))
+				return float(scale);
+		}
+
+		return 0.f;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	int GridGraph<T_NodeType, T_ConnectionType>::GetClearanceForRadius(float radius) const
+	{
+		//the agent covers every cell whose center is less than radius + half a cell away along either axis
+		int clearance = 1 + int(ceilf(radius / m_CellSize - 0.5f));
+		return clearance < 1 ? 1 : clearance;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline bool GridGraph<T_NodeType, T_ConnectionType>::IsBlocked(int idx) const
+	{
+		return GetNodeConnections(idx).empty();
+	}
+
+	template<>
+	inline bool GridGraph<GridTerrainNode, GraphConnection>::IsBlocked(int idx) const
+	{
+		return GetNode(idx)->GetTerrainType() == TerrainType::Water;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline int GridGraph<T_NodeType, T_ConnectionType>::GetBorderClearance(int col, int row) const
+	{
+		int clearance = col + 1;
+		clearance = row + 1 < clearance ? row + 1 : clearance;
+		clearance = m_NrOfColumns - col < clearance ? m_NrOfColumns - col : clearance;
+		return m_NrOfRows - row < clearance ? m_NrOfRows - row : clearance;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::BuildClearances()
+	{
+		m_Clearances.Assign(m_NrOfColumns * m_NrOfRows, 0);
+		for (int row = 0; row < m_NrOfRows; ++row)
+		{
+			for (int col = 0; col < m_NrOfColumns; ++col)
+			{
+				int idx = GetIndex(col, row);
+				m_Clearances.Set(idx, IsBlocked(idx) ? 0 : GetBorderClearance(col, row));
+			}
+		}
+
+		//Chebyshev distance transform: every cell takes the smallest of the neighbours that come before it, then those after it
+		auto relax = [this](int idx, int neighbourCol, int neighbourRow)
+		{
+			if (IsWithinBounds(neighbourCol, neighbourRow) && m_Clearances[GetIndex(neighbourCol, neighbourRow)] + 1 < m_Clearances[idx])
+				m_Clearances.Set(idx, m_Clearances[GetIndex(neighbourCol, neighbourRow)] + 1);
+		};
+
+		for (int row = 0; row < m_NrOfRows; ++row)
+		{
+			for (int col = 0; col < m_NrOfColumns; ++col)
+			{
+				int idx = GetIndex(col, row);
+				relax(idx, col - 1, row);
+				relax(idx, col - 1, row - 1);
+				relax(idx, col, row - 1);
+				relax(idx, col + 1, row - 1);
+			}
+		}
+
+		for (int row = m_NrOfRows - 1; row >= 0; --row)
+		{
+			for (int col = m_NrOfColumns - 1; col >= 0; --col)
+			{
+				int idx = GetIndex(col, row);
+				relax(idx, col + 1, row);
+				relax(idx, col + 1, row + 1);
+				relax(idx, col, row + 1);
+				relax(idx, col - 1, row + 1);
+			}
+		}
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::UpdateClearances(int idx)
+	{
+		//(un)isolating a node also rebuilds the connections of its neighbours, which reach one cell further
+		int col = idx % m_NrOfColumns;
+		int row = idx / m_NrOfColumns;
+		for (int neighbourRow = row - 2; neighbourRow <= row + 2; ++neighbourRow)
+		{
+			for (int neighbourCol = col - 2; neighbourCol <= col + 2; ++neighbourCol)
+			{
+				if (!IsWithinBounds(neighbourCol, neighbourRow))
+					continue;
+
+				int neighbourIdx = GetIndex(neighbourCol, neighbourRow);
+				bool isBlocked = IsBlocked(neighbourIdx);
+				if (isBlocked && m_Clearances[neighbourIdx] != 0)
+					BlockClearance(neighbourIdx);
+				else if (!isBlocked && m_Clearances[neighbourIdx] == 0)
+					UnblockClearance(neighbourIdx);
+			}
+		}
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::BlockClearance(int idx)
+	{
+		//clearances only go down, a wave from the new blocked cell is enough
+		m_Clearances.Set(idx, 0);
+		vector<int> openCells{ idx };
+		PropagateClearances(openCells);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::UnblockClearance(int idx)
+	{
+		//Clear every cell that had this cell as its closest blocked cell. Those lie exactly their clearance away from it
+		//and form a connected area around it, because each step towards the cell lowers both by one.
+		const int unknown = (std::numeric_limits<int>::max)();
+		int col = idx % m_NrOfColumns;
+		int row = idx / m_NrOfColumns;
+
+		vector<int> clearedCells{ idx };
+		m_Clearances.Set(idx, unknown);
+		for (size_t i = 0; i < clearedCells.size(); ++i)
+		{
+			int clearedCol = clearedCells[i] % m_NrOfColumns;
+			int clearedRow = clearedCells[i] / m_NrOfColumns;
+			for (int neighbourRow = clearedRow - 1; neighbourRow <= clearedRow + 1; ++neighbourRow)
+			{
+				for (int neighbourCol = clearedCol - 1; neighbourCol <= clearedCol + 1; ++neighbourCol)
+				{
+					if (!IsWithinBounds(neighbourCol, neighbourRow))
+						continue;
+
+					int neighbourIdx = GetIndex(neighbourCol, neighbourRow);
+					int distanceX = abs(neighbourCol - col);
+					int distanceY = abs(neighbourRow - row);
+					int distance = distanceX > distanceY ? distanceX : distanceY;
+					int clearance = m_Clearances[neighbourIdx];
+					if (clearance != unknown && clearance != 0 && clearance == distance)
+					{
+						m_Clearances.Set(neighbourIdx, unknown);
+						clearedCells.push_back(neighbourIdx);
+					}
+				}
+			}
+		}
+
+		//refill them from the grid border and the cells around them
+		for (int clearedIdx : clearedCells)
+		{
+			int clearedCol = clearedIdx % m_NrOfColumns;
+			int clearedRow = clearedIdx / m_NrOfColumns;
+			int clearance = IsBlocked(clearedIdx) ? 0 : GetBorderClearance(clearedCol, clearedRow);
+			for (int neighbourRow = clearedRow - 1; neighbourRow <= clearedRow + 1; ++neighbourRow)
+			{
+				for (int neighbourCol = clearedCol - 1; neighbourCol <= clearedCol + 1; ++neighbourCol)
+				{
+					if (!IsWithinBounds(neighbourCol, neighbourRow))
+						continue;
+
+					int neighbourClearance = m_Clearances[GetIndex(neighbourCol, neighbourRow)];
+					if (neighbourClearance != unknown && neighbourClearance + 1 < clearance)
+						clearance = neighbourClearance + 1;
+				}
+			}
+			m_Clearances.Set(clearedIdx, clearance);
+		}
+
+		PropagateClearances(clearedCells);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	void GridGraph<T_NodeType, T_ConnectionType>::PropagateClearances(vector<int>& openCells)
+	{
+		//label correcting: a cell goes back on the list every time it gets lower
+		for (size_t i = 0; i < openCells.size(); ++i)
+		{
+			int idx = openCells[i];
+			int col = idx % m_NrOfColumns;
+			int row = idx / m_NrOfColumns;
+			for (int neighbourRow = row - 1; neighbourRow <= row + 1; ++neighbourRow)
+			{
+				for (int neighbourCol = col - 1; neighbourCol <= col + 1; ++neighbourCol)
+				{
+					if (!IsWithinBounds(neighbourCol, neighbourRow))
+						continue;
+
+					int neighbourIdx = GetIndex(neighbourCol, neighbourRow);
+					if (m_Clearances[idx] + 1 < m_Clearances[neighbourIdx])
+					{
+						m_Clearances.Set(neighbourIdx, m_Clearances[idx] + 1);
+						openCells.push_back(neighbourIdx);
+					}
+				}
+			}
+		}
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	int GridGraph<T_NodeType, T_ConnectionType>::GetNearestNodeInComponent(int idx, int component) const
+	{
+		Vector2 colRow = GetNodePos(idx);
+		int col = (int)colRow.x;
+		int row = (int)colRow.y;
+
+		int nearestIdx = invalid_node_index;
+		int nearestDistanceSquared = (std::numeric_limits<int>::max)();
+		int maxRadius = m_NrOfColumns > m_NrOfRows ? m_NrOfColumns : m_NrOfRows;
+
+		//A cell on ring r lies between r and r * sqrt(2) away, so keep going until the rings can't hold anything closer
+		for (int radius = 0; radius <= maxRadius && radius * radius < nearestDistanceSquared; ++radius)
+		{
+			for (int dRow = -radius; dRow <= radius; ++dRow)
+			{
+				//only the border of the ring, the inside was handled by the smaller rings
+				bool isTopOrBottom = dRow == -radius || dRow == radius;
+				int step = isTopOrBottom || radius == 0 ? 1 : 2 * radius;
+
+				for (int dCol = -radius; dCol <= radius; dCol += step)
+				{
+					if (!IsWithinBounds(col + dCol, row + dRow))
+						continue;
+
+					int neighbourIdx = GetIndex(col + dCol, row + dRow);
+					int distanceSquared = dCol * dCol + dRow * dRow;
+					if (distanceSquared < nearestDistanceSquared && IsNodeValid(neighbourIdx) && GetComponent(neighbourIdx) == component)
+					{
+						nearestDistanceSquared = distanceSquared;
+						nearestIdx = neighbourIdx;
+					}
+				}
+			}
+		}
+
+		return nearestIdx;
+	}
+
 	template<class T_NodeType, class T_ConnectionType>
 	Elite::Vector2 GridGraph<T_NodeType, T_ConnectionType>::GetNodePos(T_NodeType* pNode) const
 	{
@@ -10,9 +10,18 @@
 #include "EGraphNodeTypes.h"
 #include "EGraphConnectionTypes.h"
 #include <memory>
+#include <limits>
+#include <atomic>
 
 namespace Elite
 {
+	// shared by all graph types, 0 is never handed out (see IGraph::GetGraphId)
+	inline unsigned int GetNextGraphId()
+	{
+		static std::atomic<unsigned int> nextGraphId{ 1 };
+		return nextGraphId++;
+	}
+
 	template <class T_NodeType, class T_ConnectionType>
 	class IGraph
 	{
@@ -24,6 +33,11 @@ namespace Elite
 
 	public:
 		IGraph(bool isDirectionalGraph);
+		// Copies share all nodes and connections with the original, in chunks. A chunk's connections are only copied once either graph
+		// changes them, so copying is cheap and a copy can be searched on another thread while the original is being edited.
+		// Node objects stay shared: node pointers of a graph stay valid in that graph whatever either graph edits afterwards (a node
+		// removed while shared gets a new object, the copies keep the old one). Node data (terrain, position, color) is shared as well,
+		// a copy keeps its own structure: which nodes exist and how they're connected. Take the copy on the thread that edits the original.
 		IGraph(const IGraph& other);
 		virtual ~IGraph();
 		
@@ -31,13 +45,15 @@ namespace Elite
 
 		// Basic graph functionality
 		// -------------------------
+		// Nodes and connections can be shared with copies of this graph, only change them through the graph (see GetNodeForWriting)
+		// Connection pointers aren't kept across edits, the graph that edits a shared chunk first gets its own connections
 		T_NodeType* GetNode(int idx) const;
 		bool IsNodeValid(int idx) const;
-		const NodeVector& GetAllNodes() const { return m_Nodes; }
+		NodeVector GetAllNodes() const;
 		NodeVector GetAllActiveNodes() const;
 
 		T_ConnectionType* GetConnection(int from, int to) const;
-		const ConnectionListVector& GetAllConnections() const { return m_Connections; }
+		// connections live in chunks, walk them per node (there's no list of all of them to hand out)
 		const ConnectionList& GetNodeConnections(int idx) const;
 
 		int GetNextFreeNodeIndex() const { return m_NextNodeIndex; }
@@ -49,15 +65,37 @@ namespace Elite
 		void RemoveConnection(T_ConnectionType* pConnection);
 
 		// Removes all connections to this pNode
-		void IsolateNode(int idx);
+		virtual void IsolateNode(int idx);
+		// Connecting a node to its neighbours again and terrain need a layout (see GridGraph), graphs without one don't support them
+		virtual void UnIsolateNode(int idx) { assert(false && "<IGraph::UnIsolateNode>: this graph doesn't know the neighbours of a node"); }
+		virtual void SetTerrainType(int idx, TerrainType terrain) { assert(false && "<IGraph::SetTerrainType>: this graph has no terrain"); }
 
 		void SetConnectionCost(int from, int to, float cost);
 
-		int GetNrOfNodes() const { return m_Nodes.size(); }
+		// Connected components
+		// --------------------
+		// Every node carries a component label that is kept up to date by the functions above: adding a connection merges two components,
+		// removing connections or isolating a node searches for a split locally. Nodes in different components can never reach each other.
+		// Directional graphs track weakly connected components, so sharing a component doesn't guarantee a path there.
+		int GetComponent(int idx) const;
+		bool IsInSameComponent(int from, int to) const { return GetComponent(from) == GetComponent(to); }
+		// closest active node (by position) that lies in the given component, invalid_node_index if there is none
+		virtual int GetNearestNodeInComponent(int idx, int component) const;
+
+		int GetNrOfNodes() const { return m_NrOfNodes; }
 		int GetNrOfActiveNodes() const; // TODO: add comment
 		int GetNrOfConnections() const;
 		bool IsDirectionalGraph() const { return m_IsDirectionalGraph; }
-		bool IsEmpty() const { return m_Nodes.empty(); }
+		bool IsEmpty() const { return m_NrOfNodes == 0; }
+		// Never shared by two graphs, also not by a graph and its copy or by a graph created at the address of a deleted one.
+		// Data cached per graph keys on this instead of the graph's address.
+		unsigned int GetGraphId() const { return m_GraphId; }
+		// Goes up whenever nodes or connections are added or removed, data built from the graph can compare it to see if it is outdated
+		unsigned int GetStructureVersion() const { return m_StructureVersion; }
+		// Factor that turns every connection cost into a whole number, 0 when the graph doesn't promise one
+		virtual float GetCostScale() const { return 0.f; }
+		// How large an agent fits on a node, in cells (see GridGraph). Graphs without a clearance layer fit any agent everywhere.
+		virtual int GetClearance(int idx) const { return (std::numeric_limits<int>::max)(); }
 
 		void Clear();
 		void RemoveConnections();
@@ -75,10 +113,10 @@ namespace Elite
 		virtual Vector2 GetNodePos(int idx) const {	return GetNodePos(GetNode(idx)); }
 
 	protected:
-		// A vector of adjacency pConnection lists, mapped to the indices of the nodes
-		// m_Edges[0] returns the list of connections of the pNode with index 0
-		ConnectionListVector m_Connections;
-		NodeVector m_Nodes;
+		// Nodes are shared with copies of this graph, their data changes in the copies too.
+		// Connection lists are copied first if their chunk is shared, connection pointers handed out before are left to the copy.
+		T_NodeType* GetNodeForWriting(int idx);
+		ConnectionList& GetNodeConnectionsForWriting(int idx);
 
 		bool m_IsDirectionalGraph;
 
@@ -86,53 +124,97 @@ namespace Elite
 		bool IsUniqueConnection(int from, int to) const;
 
 	private:
+		// Nodes and their connection lists are stored in fixed size chunks, shared between copies of the graph until one of them writes.
+		// Copying a chunk shares its nodes and copies its connections.
+		static const int m_ChunkShift = 6;
+		static const int m_ChunkSize = 1 << m_ChunkShift;
+
+		struct StorageChunk
+		{
+			StorageChunk() = default;
+			StorageChunk(const StorageChunk& other);
+			~StorageChunk();
+			StorageChunk& operator=(const StorageChunk&) = delete;
+
+			std::vector<shared_ptr<T_NodeType>> nodes;
+			// A vector of adjacency pConnection lists, mapped to the indices of the nodes
+			// connections[0] returns the list of connections of the first pNode in this chunk
+			ConnectionListVector connections;
+		};
+		using ChunkVector = std::vector<shared_ptr<StorageChunk>>;
+
+		shared_ptr<ChunkVector> m_pChunks;
+		const unsigned int m_GraphId;
+		int m_NrOfNodes = 0;
 		int m_NextNodeIndex;
+		unsigned int m_StructureVersion = 0;
+
+		// Union-find over component labels, every node points at a label. Splits give the split off nodes a fresh label,
+		// so labels are only compacted when a full rebuild happens.
+		mutable vector<int> m_ComponentLabels;
+		mutable vector<int> m_ComponentParents;
+		mutable bool m_AreComponentsDirty = false;
+		vector<unsigned int> m_ComponentVisits;
+		unsigned int m_ComponentVisitStamp = 0;
+		vector<int> m_ComponentSearches[2];
 
 		// private functions
+		const StorageChunk& GetChunk(int idx) const { return *(*m_pChunks)[idx >> m_ChunkShift]; }
+		StorageChunk& GetChunkForWriting(int idx);
 		void CullInvalidEdges();
+
+		int AddComponentLabel();
+		int FindComponent(int label) const;
+		void MergeComponents(int from, int to);
+		void SplitComponents(const vector<int>& nodes);
+		bool SplitComponent(int first, int second);
+		void RebuildComponents() const;
 	};
 
 	template<class T_NodeType, class T_ConnectionType>
 	inline IGraph<T_NodeType, T_ConnectionType>::IGraph(bool isDirectionalGraph)
 		: m_NextNodeIndex(0)
 		, m_IsDirectionalGraph(isDirectionalGraph)
+		, m_pChunks(make_shared<ChunkVector>())
+		, m_GraphId(GetNextGraphId())
 	{
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
 	inline IGraph<T_NodeType, T_ConnectionType>::IGraph(const IGraph& other)
+		: m_IsDirectionalGraph(other.m_IsDirectionalGraph)
+		, m_pChunks(other.m_pChunks)
+		, m_GraphId(GetNextGraphId())
+		, m_NrOfNodes(other.m_NrOfNodes)
+		, m_NextNodeIndex(other.m_NextNodeIndex)
+		, m_StructureVersion(other.m_StructureVersion)
+		, m_AreComponentsDirty(true) // rebuilt on first use, so copying stays cheap
 	{
-		for (auto& n : m_Nodes)
-			SAFE_DELETE(n);
-
-		for (auto& connectionList : m_Connections)
-		{
-			for (auto& connection : connectionList)
-				SAFE_DELETE(connection);
-		};
+	}
 
-		for (auto n : other.m_Nodes)
-			m_Nodes.push_back(new T_NodeType(*n));
+	template<class T_NodeType, class T_ConnectionType>
+	inline IGraph<T_NodeType, T_ConnectionType>::~IGraph()
+	{
+		// chunks delete their nodes and connections once no copy uses them anymore
+	}
 
-		for (auto cList : other.m_Connections)
+	template<class T_NodeType, class T_ConnectionType>
+	inline IGraph<T_NodeType, T_ConnectionType>::StorageChunk::StorageChunk(const StorageChunk& other)
+		: nodes(other.nodes)
+	{
+		for (auto& cList : other.connections)
 		{
-			ConnectionList newList;
+			connections.push_back(ConnectionList());
 			for (auto c : cList)
-				newList.push_back(new T_ConnectionType(*c));
-			m_Connections.push_back(newList);
+				connections.back().push_back(new T_ConnectionType(*c));
 		}
-
-		m_IsDirectionalGraph = other.m_IsDirectionalGraph;
-		m_NextNodeIndex = other.m_NextNodeIndex;
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
-	inline IGraph<T_NodeType, T_ConnectionType>::~IGraph()
+	inline IGraph<T_NodeType, T_ConnectionType>::StorageChunk::~StorageChunk()
 	{
-		for(auto& n : m_Nodes)
-			SAFE_DELETE(n);
-
-		for(auto& connectionList : m_Connections)
+		//nodes go with the last chunk that shares them
+		for (auto& connectionList : connections)
 		{
 			for (auto& connection : connectionList)
 				SAFE_DELETE(connection);
@@ -142,31 +224,31 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline T_NodeType* IGraph<T_NodeType, T_ConnectionType>::GetNode(int idx) const
 	{
-		assert((idx < (int)m_Nodes.size()) && (idx >= 0) &&	"<Graph::GetNode>: invalid index");
+		assert((idx < m_NrOfNodes) && (idx >= 0) &&	"<Graph::GetNode>: invalid index");
 
-		return m_Nodes[idx];
+		return GetChunk(idx).nodes[idx & (m_ChunkSize - 1)].get();
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
 	inline bool IGraph<T_NodeType, T_ConnectionType>::IsNodeValid(int idx) const
 	{
-		return (idx < (int)m_Nodes.size() && (m_Nodes[idx]->GetIndex() != invalid_node_index));
+		return (idx < m_NrOfNodes && (GetNode(idx)->GetIndex() != invalid_node_index));
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
 	inline T_ConnectionType* IGraph<T_NodeType, T_ConnectionType>::GetConnection(int from, int to) const
 	{
-		assert((from < (int)m_Nodes.size()) &&
+		assert((from < m_NrOfNodes) &&
 			(from >= 0) &&
-			m_Nodes[from]->GetIndex() != invalid_node_index &&
+			GetNode(from)->GetIndex() != invalid_node_index &&
 			"<Graph::GetConnection>: invalid 'from' index");
 
-		assert((to < (int)m_Nodes.size()) &&
+		assert((to < m_NrOfNodes) &&
 			(to >= 0) &&
-			m_Nodes[to]->GetIndex() != invalid_node_index &&
+			GetNode(to)->GetIndex() != invalid_node_index &&
 			"<Graph::GetConnection>: invalid 'to' index");
 
-		for (auto c : m_Connections[from])
+		for (auto c : GetNodeConnections(from))
 		{
 			if (c && c->GetTo() == to)
 				return c;
@@ -175,13 +257,26 @@ namespace Elite
 		return nullptr;
 	}
 
+	template<class T_NodeType, class T_ConnectionType>
+	inline vector<T_NodeType*> IGraph<T_NodeType, T_ConnectionType>::GetAllNodes() const
+	{
+		vector<T_NodeType*> nodes{};
+		nodes.reserve(m_NrOfNodes);
+		for (auto& pChunk : *m_pChunks)
+			for (auto& n : pChunk->nodes)
+				nodes.push_back(n.get());
+
+		return nodes;
+	}
+
 	template<class T_NodeType, class T_ConnectionType>
 	inline vector<T_NodeType*> IGraph<T_NodeType, T_ConnectionType>::GetAllActiveNodes() const
 	{
 		vector<T_NodeType*> activeNodes{};
-		for (auto n : m_Nodes)
-			if (n->GetIndex() != invalid_node_index)
-				activeNodes.push_back(n);
+		for (auto& pChunk : *m_pChunks)
+			for (auto& n : pChunk->nodes)
+				if (n->GetIndex() != invalid_node_index)
+					activeNodes.push_back(n.get());
 
 		return activeNodes;
 	}
@@ -189,22 +284,59 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline const std::list<T_ConnectionType*>& IGraph<T_NodeType, T_ConnectionType>::GetNodeConnections(int idx) const
 	{
-		assert((idx < (int)m_Nodes.size()) && (idx >= 0) && "<Graph::GetNode>: invalid index");
+		assert((idx < m_NrOfNodes) && (idx >= 0) && "<Graph::GetNode>: invalid index");
+
+		return GetChunk(idx).connections[idx & (m_ChunkSize - 1)];
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline T_NodeType* IGraph<T_NodeType, T_ConnectionType>::GetNodeForWriting(int idx)
+	{
+		assert((idx < m_NrOfNodes) && (idx >= 0) && "<Graph::GetNodeForWriting>: invalid index");
+
+		return GetChunk(idx).nodes[idx & (m_ChunkSize - 1)].get();
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline std::list<T_ConnectionType*>& IGraph<T_NodeType, T_ConnectionType>::GetNodeConnectionsForWriting(int idx)
+	{
+		assert((idx < m_NrOfNodes) && (idx >= 0) && "<Graph::GetNodeConnectionsForWriting>: invalid index");
 
-		return m_Connections[idx];
+		return GetChunkForWriting(idx).connections[idx & (m_ChunkSize - 1)];
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline typename IGraph<T_NodeType, T_ConnectionType>::StorageChunk& IGraph<T_NodeType, T_ConnectionType>::GetChunkForWriting(int idx)
+	{
+		//Only the thread that owns this graph makes copies of it, so a chunk used by nothing else can't become shared while it's written to.
+		//The chunk table itself is shared as well, a copy of it only costs a pointer per chunk.
+		if (m_pChunks.use_count() > 1)
+			m_pChunks = make_shared<ChunkVector>(*m_pChunks);
+
+		shared_ptr<StorageChunk>& pChunk = (*m_pChunks)[idx >> m_ChunkShift];
+		if (pChunk.use_count() > 1)
+			pChunk = make_shared<StorageChunk>(*pChunk);
+
+		return *pChunk;
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
 	inline int IGraph<T_NodeType, T_ConnectionType>::AddNode(T_NodeType* pNode)
 	{
-		if (pNode->GetIndex() < (int)m_Nodes.size())
+		++m_StructureVersion;
+
+		if (pNode->GetIndex() < m_NrOfNodes)
 		{
 			//make sure the client is not trying to add a pNode with the same ID as
 			//a currently active pNode
-			assert(m_Nodes[pNode->GetIndex()]->GetIndex() == invalid_node_index &&
+			assert(GetNode(pNode->GetIndex())->GetIndex() == invalid_node_index &&
 				"<Graph::AddNode>: Attempting to add a node with a duplicate ID");
 
-			m_Nodes[pNode->GetIndex()] = pNode;
+			//the removed pNode that used this index is still owned by the graph (and maybe its copies)
+			GetChunkForWriting(pNode->GetIndex()).nodes[pNode->GetIndex() & (m_ChunkSize - 1)].reset(pNode);
+			//labels only exist while they're up to date (a fresh copy has none), a rebuild sizes them again
+			if (!m_AreComponentsDirty)
+				m_ComponentLabels[pNode->GetIndex()] = AddComponentLabel();
 
 			return m_NextNodeIndex;
 		}
@@ -213,8 +345,19 @@ namespace Elite
 			//make sure the new pNode has been indexed correctly
 			assert(pNode->GetIndex() == m_NextNodeIndex && "<Graph::AddNode>:invalid index");
 
-			m_Nodes.push_back(pNode);
-			m_Connections.push_back(ConnectionList());
+			if ((m_NrOfNodes & (m_ChunkSize - 1)) == 0)
+			{
+				if (m_pChunks.use_count() > 1)
+					m_pChunks = make_shared<ChunkVector>(*m_pChunks);
+				m_pChunks->push_back(make_shared<StorageChunk>());
+			}
+
+			StorageChunk& chunk = GetChunkForWriting(m_NrOfNodes);
+			chunk.nodes.push_back(shared_ptr<T_NodeType>(pNode));
+			chunk.connections.push_back(ConnectionList());
+			++m_NrOfNodes;
+			if (!m_AreComponentsDirty)
+				m_ComponentLabels.push_back(AddComponentLabel());
 
 			return m_NextNodeIndex++;
 		}
@@ -226,28 +369,35 @@ namespace Elite
 		//Removes pNode by setting it's index to invalid_node_index 
 		//This prevents the other indices from needing to be changed, however it can be reused when adding a new pNode with that index
 
-		assert(node < (int)m_Nodes.size() && "<Graph::RemoveNode>: invalid node index");
+		assert(node < m_NrOfNodes && "<Graph::RemoveNode>: invalid node index");
+		++m_StructureVersion;
 
-		//set this pNode's index to invalid_node_index
-		m_Nodes[node]->SetIndex(invalid_node_index);
+		//set this pNode's index to invalid_node_index, copies that share the pNode keep it as it is
+		shared_ptr<T_NodeType>& pNode = GetChunkForWriting(node).nodes[node & (m_ChunkSize - 1)];
+		if (pNode.use_count() > 1)
+			pNode = shared_ptr<T_NodeType>(new T_NodeType(*pNode));
+		pNode->SetIndex(invalid_node_index);
+
+		vector<int> neighbours;
+		for (auto pConnection : GetNodeConnections(node))
+			neighbours.push_back(pConnection->GetTo());
 
 		//if the graph is not directed remove all connections leading to this pNode and then
 		//clear the connections leading from the pNode
 		if (!m_IsDirectionalGraph)
 		{
 			//visit each neighbour and erase any connections leading to this pNode
-			for (auto currentConnection = m_Connections[node].begin();
-				currentConnection != m_Connections[node].end();
-				++currentConnection)
+			for (int neighbour : neighbours)
 			{
-				for (auto& currentEdgeOnToNode = m_Connections[(*currentConnection)->GetTo()].begin();
-					currentEdgeOnToNode != m_Connections[(*currentConnection)->GetTo()].end();
+				ConnectionList& neighbourConnections = GetNodeConnectionsForWriting(neighbour);
+				for (auto currentEdgeOnToNode = neighbourConnections.begin();
+					currentEdgeOnToNode != neighbourConnections.end();
 					++currentEdgeOnToNode)
 				{
 					if ((*currentEdgeOnToNode)->GetTo() == node)
 					{
 						auto conPtr = *currentEdgeOnToNode;
-						currentEdgeOnToNode = m_Connections[(*currentConnection)->GetTo()].erase(currentEdgeOnToNode);
+						neighbourConnections.erase(currentEdgeOnToNode);
 						SAFE_DELETE(conPtr);
 
 						break;
@@ -256,9 +406,21 @@ namespace Elite
 			}
 
 			//finally, clear this pNode's connections
-			for (auto& connection : m_Connections[node])
+			ConnectionList& nodeConnections = GetNodeConnectionsForWriting(node);
+			for (auto& connection : nodeConnections)
 					SAFE_DELETE(connection);
-			m_Connections[node].clear();
+			nodeConnections.clear();
+
+			//the neighbours might only have been connected through this pNode
+			if (!m_AreComponentsDirty)
+			{
+				m_ComponentLabels[node] = AddComponentLabel();
+				SplitComponents(neighbours);
+			}
+		}
+		else
+		{
+			m_AreComponentsDirty = true;
 		}
 	}
 
@@ -270,13 +432,13 @@ namespace Elite
 			"<Graph::AddConnection>: invalid node index");
 
 		//make sure both nodes are active before adding the pConnection
-		if ((m_Nodes[pConnection->GetTo()]->GetIndex() != invalid_node_index) &&
-			(m_Nodes[pConnection->GetFrom()]->GetIndex() != invalid_node_index))
+		if ((GetNode(pConnection->GetTo())->GetIndex() != invalid_node_index) &&
+			(GetNode(pConnection->GetFrom())->GetIndex() != invalid_node_index))
 		{
 			//add the pConnection, first making sure it is unique
 			assert(IsUniqueConnection(pConnection->GetFrom(), pConnection->GetTo()) && "Connection already exists on this graph");
 			
-			m_Connections[pConnection->GetFrom()].push_back(pConnection);
+			GetNodeConnectionsForWriting(pConnection->GetFrom()).push_back(pConnection);
 
 			//if the graph is undirected we must add another pConnection in the opposite
 			//direction
@@ -291,9 +453,12 @@ namespace Elite
 					oppositeDirEdge->SetTo(pConnection->GetFrom());
 					oppositeDirEdge->SetFrom(pConnection->GetTo());
 
-					m_Connections[pConnection->GetTo()].push_back(oppositeDirEdge);
+					GetNodeConnectionsForWriting(pConnection->GetTo()).push_back(oppositeDirEdge);
 				}
 			}
+
+			MergeComponents(pConnection->GetFrom(), pConnection->GetTo());
+			++m_StructureVersion;
 		}
 		
 	}
@@ -301,40 +466,43 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline void IGraph<T_NodeType, T_ConnectionType>::RemoveConnection(int from, int to)
 	{
-		assert((from < (int)m_Nodes.size()) && (to < (int)m_Nodes.size()) &&
+		assert((from < m_NrOfNodes) && (to < m_NrOfNodes) &&
 			"<Graph::RemoveConnection>:invalid node index");
-
-		auto conFromTo = GetConnection(from, to);
-		auto conToFrom = GetConnection(to, from);
+		++m_StructureVersion;
 
 		if (!m_IsDirectionalGraph)
 		{
-			for (auto& curEdge = m_Connections[to].begin();
-				curEdge != m_Connections[to].end();
+			ConnectionList& toConnections = GetNodeConnectionsForWriting(to);
+			for (auto curEdge = toConnections.begin();
+				curEdge != toConnections.end();
 				++curEdge)
 			{
 				if ((*curEdge)->GetTo() == from) 
 				{ 
-					curEdge = m_Connections[to].erase(curEdge); 
+					SAFE_DELETE(*curEdge);
+					toConnections.erase(curEdge); 
 					break; 
 				}
 			}
 		}
 
-		for (auto& curEdge = m_Connections[from].begin();
-			curEdge != m_Connections[from].end();
+		ConnectionList& fromConnections = GetNodeConnectionsForWriting(from);
+		for (auto curEdge = fromConnections.begin();
+			curEdge != fromConnections.end();
 			++curEdge)
 		{
 			if ((*curEdge)->GetTo() == to) 
 			{ 
-				curEdge = m_Connections[from].erase(curEdge); 
+				SAFE_DELETE(*curEdge);
+				fromConnections.erase(curEdge); 
 				break; 
 			}
 		}
 
-		SAFE_DELETE(conFromTo);
-		SAFE_DELETE(conToFrom);
-
+		if (m_IsDirectionalGraph)
+			m_AreComponentsDirty = true;
+		else
+			SplitComponents({ from, to });
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
@@ -346,21 +514,56 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline void IGraph<T_NodeType, T_ConnectionType>::IsolateNode(int idx)
 	{
+		++m_StructureVersion;
+
+		vector<int> neighbours;
+		for (auto c : GetNodeConnections(idx))
+			neighbours.push_back(c->GetTo());
+
 		// remove and delete connections from this pNode
-		for (auto c : m_Connections[idx])
+		ConnectionList& nodeConnections = GetNodeConnectionsForWriting(idx);
+		for (auto c : nodeConnections)
 			delete c;
-		m_Connections[idx].clear();
+		nodeConnections.clear();
 
-		// remove and delete connections from other nodes to this pNode
+		// remove and delete connections from other nodes to this pNode, only chunks that really hold one get written to (and copied if shared)
 		auto isConnectionToThisNode = [idx](T_ConnectionType* pCon) { return pCon->GetTo() == idx; };
-		for (auto& c : m_Connections)
+		auto removeConnectionsToThisNode = [this, &isConnectionToThisNode](int from)
 		{
-			list<T_ConnectionType*>::iterator foundIt;
-			while ((foundIt = std::find_if(c.begin(), c.end(), isConnectionToThisNode))	!= c.end())
+			const ConnectionList& c = GetNodeConnections(from);
+			if (std::find_if(c.begin(), c.end(), isConnectionToThisNode) == c.end())
+				return;
+
+			ConnectionList& writableConnections = GetNodeConnectionsForWriting(from);
+			typename ConnectionList::iterator foundIt;
+			while ((foundIt = std::find_if(writableConnections.begin(), writableConnections.end(), isConnectionToThisNode)) != writableConnections.end())
 			{
 				delete *foundIt;
-				c.erase(foundIt);
+				writableConnections.erase(foundIt);
 			}
+		};
+
+		// undirected graphs only have them on the neighbours, directional graphs can have them anywhere
+		if (!m_IsDirectionalGraph)
+		{
+			for (int neighbour : neighbours)
+				removeConnectionsToThisNode(neighbour);
+		}
+		else
+		{
+			for (int i = 0; i < m_NrOfNodes; ++i)
+				removeConnectionsToThisNode(i);
+		}
+
+		// the node is on its own now, and its neighbours might only have been connected through it
+		if (m_IsDirectionalGraph)
+		{
+			m_AreComponentsDirty = true;
+		}
+		else if (!neighbours.empty() && !m_AreComponentsDirty)
+		{
+			m_ComponentLabels[idx] = AddComponentLabel();
+			SplitComponents(neighbours);
 		}
 	}
 
@@ -368,13 +571,11 @@ namespace Elite
 	inline void IGraph<T_NodeType, T_ConnectionType>::SetConnectionCost(int from, int to, float cost)
 	{
 		//make sure the nodes given are valid
-		assert((from < (int)m_Nodes.size()) && (to < (int)m_Nodes.size()) &&
+		assert((from < m_NrOfNodes) && (to < m_NrOfNodes) &&
 			"<Graph::SetEdgeCost>: invalid index");
 
 		//visit each neighbour and erase any connections leading to this pNode
-		for (auto& curEdge = m_Connections[from].begin();
-			curEdge != m_Connections[from].end();
-			++curEdge)
+		for (auto curEdge : GetNodeConnectionsForWriting(from))
 		{
 			if (curEdge->GetTo() == to)
 			{
@@ -389,8 +590,8 @@ namespace Elite
 	{
 		int count = 0;
 
-		for (unsigned int n = 0; n < m_Nodes.size(); ++n) 
-			if (m_Nodes[n]->GetIndex() != invalid_node_index) 
+		for (int n = 0; n < m_NrOfNodes; ++n) 
+			if (GetNode(n)->GetIndex() != invalid_node_index) 
 				++count;
 
 		return count;
@@ -401,12 +602,8 @@ namespace Elite
 	{
 		int tot = 0;
 
-		for (auto curEdge = m_Connections.begin();
-			curEdge != m_Connections.end();
-			++curEdge)
-		{
-			tot += curEdge->size();
-		}
+		for (int n = 0; n < m_NrOfNodes; ++n)
+			tot += GetNodeConnections(n).size();
 
 		return tot;
 	}
@@ -415,15 +612,194 @@ namespace Elite
 	inline void IGraph<T_NodeType, T_ConnectionType>::Clear()
 	{
 		m_NextNodeIndex = 0;
-		m_Nodes.clear();
-		m_Connections.clear();
+		m_NrOfNodes = 0;
+		++m_StructureVersion;
+		m_pChunks = make_shared<ChunkVector>();
+		m_ComponentLabels.clear();
+		m_ComponentParents.clear();
+		m_AreComponentsDirty = false;
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
 	inline void IGraph<T_NodeType, T_ConnectionType>::RemoveConnections()
 	{
-		for (auto& connectionList : m_Connections)
+		++m_StructureVersion;
+
+		for (int n = 0; n < m_NrOfNodes; ++n)
+		{
+			if (GetNodeConnections(n).empty())
+				continue;
+
+			ConnectionList& connectionList = GetNodeConnectionsForWriting(n);
+			for (auto& connection : connectionList)
+				SAFE_DELETE(connection);
 			connectionList.clear();
+		}
+
+		m_AreComponentsDirty = true;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline int IGraph<T_NodeType, T_ConnectionType>::GetComponent(int idx) const
+	{
+		assert((idx < m_NrOfNodes) && (idx >= 0) && "<Graph::GetComponent>: invalid index");
+
+		if (m_AreComponentsDirty)
+			RebuildComponents();
+
+		return FindComponent(m_ComponentLabels[idx]);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline int IGraph<T_NodeType, T_ConnectionType>::GetNearestNodeInComponent(int idx, int component) const
+	{
+		Vector2 pos = GetNodePos(idx);
+
+		int nearestIdx = invalid_node_index;
+		float nearestDistanceSquared = (std::numeric_limits<float>::max)();
+		for (auto pNode : GetAllNodes())
+		{
+			if (pNode->GetIndex() == invalid_node_index || GetComponent(pNode->GetIndex()) != component)
+				continue;
+
+			float distanceSquared = pos.DistanceSquared(GetNodePos(pNode));
+			if (distanceSquared < nearestDistanceSquared)
+			{
+				nearestDistanceSquared = distanceSquared;
+				nearestIdx = pNode->GetIndex();
+			}
+		}
+
+		return nearestIdx;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline int IGraph<T_NodeType, T_ConnectionType>::AddComponentLabel()
+	{
+		m_ComponentParents.push_back((int)m_ComponentParents.size());
+		return (int)m_ComponentParents.size() - 1;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline int IGraph<T_NodeType, T_ConnectionType>::FindComponent(int label) const
+	{
+		//path halving, every visited label skips its parent next time
+		while (m_ComponentParents[label] != label)
+		{
+			m_ComponentParents[label] = m_ComponentParents[m_ComponentParents[label]];
+			label = m_ComponentParents[label];
+		}
+
+		return label;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::MergeComponents(int from, int to)
+	{
+		if (m_AreComponentsDirty)
+			return;
+
+		int fromComponent = FindComponent(m_ComponentLabels[from]);
+		int toComponent = FindComponent(m_ComponentLabels[to]);
+		if (fromComponent != toComponent)
+			m_ComponentParents[toComponent] = fromComponent;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::SplitComponents(const vector<int>& nodes)
+	{
+		if (m_AreComponentsDirty)
+			return;
+
+		//Compare every node with the earlier ones in the same component. Once it's still connected to one of them, it's connected to all of them.
+		for (size_t i = 1; i < nodes.size(); ++i)
+		{
+			for (size_t j = 0; j < i; ++j)
+			{
+				if (GetComponent(nodes[i]) == GetComponent(nodes[j]) && !SplitComponent(nodes[i], nodes[j]))
+					break;
+			}
+		}
+
+		//split off nodes never give their old label back, start over once most labels are unused
+		if ((int)m_ComponentParents.size() > 4 * m_NrOfNodes + 64)
+			m_AreComponentsDirty = true;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline bool IGraph<T_NodeType, T_ConnectionType>::SplitComponent(int first, int second)
+	{
+		//Search from both nodes at once, one node at a time, until the searches meet. If one of them runs out of nodes first,
+		//it visited a whole component that got split off. This way the work is bound by the smaller of both parts.
+		if (first == second)
+			return false;
+
+		if ((int)m_ComponentVisits.size() < m_NrOfNodes)
+			m_ComponentVisits.resize(m_NrOfNodes, 0);
+		if (m_ComponentVisitStamp > (std::numeric_limits<unsigned int>::max)() - 2)
+		{
+			std::fill(m_ComponentVisits.begin(), m_ComponentVisits.end(), 0);
+			m_ComponentVisitStamp = 0;
+		}
+		unsigned int stamps[2] = { ++m_ComponentVisitStamp, ++m_ComponentVisitStamp };
+
+		size_t heads[2] = { 0, 0 };
+		m_ComponentSearches[0].assign(1, first);
+		m_ComponentSearches[1].assign(1, second);
+		m_ComponentVisits[first] = stamps[0];
+		m_ComponentVisits[second] = stamps[1];
+
+		for (int side = 0; ; side = 1 - side)
+		{
+			vector<int>& search = m_ComponentSearches[side];
+			if (heads[side] == search.size())
+			{
+				int label = AddComponentLabel();
+				for (int idx : search)
+					m_ComponentLabels[idx] = label;
+				return true;
+			}
+
+			int idx = search[heads[side]++];
+			for (auto pConnection : GetNodeConnections(idx))
+			{
+				int toIdx = pConnection->GetTo();
+				if (m_ComponentVisits[toIdx] == stamps[1 - side])
+					return false;
+
+				if (m_ComponentVisits[toIdx] != stamps[side])
+				{
+					m_ComponentVisits[toIdx] = stamps[side];
+					search.push_back(toIdx);
+				}
+			}
+		}
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::RebuildComponents() const
+	{
+		//every node starts out with its own label, every connection merges two of them
+		m_ComponentLabels.resize(m_NrOfNodes);
+		m_ComponentParents.resize(m_NrOfNodes);
+		for (int idx = 0; idx < m_NrOfNodes; ++idx)
+		{
+			m_ComponentLabels[idx] = idx;
+			m_ComponentParents[idx] = idx;
+		}
+
+		for (int idx = 0; idx < m_NrOfNodes; ++idx)
+		{
+			for (auto pConnection : GetNodeConnections(idx))
+			{
+				int fromComponent = FindComponent(pConnection->GetFrom());
+				int toComponent = FindComponent(pConnection->GetTo());
+				if (fromComponent != toComponent)
+					m_ComponentParents[toComponent] = fromComponent;
+			}
+		}
+
+		m_AreComponentsDirty = false;
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
@@ -476,7 +852,7 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline bool IGraph<T_NodeType, T_ConnectionType>::IsUniqueConnection(int from, int to) const
 	{
-		for(auto c : m_Connections[from])
+		for(auto c : GetNodeConnections(from))
 		{
 			if (c->GetTo() == to)
 			{
@@ -490,14 +866,20 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline void IGraph<T_NodeType, T_ConnectionType>::CullInvalidEdges()
 	{
-		for (auto curEdgeList = m_Connections.begin(); curEdgeList != m_Connections.end(); ++curEdgeList)
+		for (int n = 0; n < m_NrOfNodes; ++n)
 		{
-			for (auto& curEdge = (*curEdgeList).begin(); curEdge != (*curEdgeList).end(); ++curEdge)
+			ConnectionList& connectionList = GetNodeConnectionsForWriting(n);
+			for (auto curEdge = connectionList.begin(); curEdge != connectionList.end();)
 			{
-				if (m_Nodes[curEdge->GetTo()].GetIndex() == invalid_node_index ||
-					m_Nodes[curEdge->GetFrom()].GetIndex() == invalid_node_index)
+				if (GetNode((*curEdge)->GetTo())->GetIndex() == invalid_node_index ||
+					GetNode((*curEdge)->GetFrom())->GetIndex() == invalid_node_index)
+				{
+					SAFE_DELETE(*curEdge);
+					curEdge = connectionList.erase(curEdge);
+				}
+				else
 				{
-					curEdge = (*curEdgeList).erase(curEdge);
+					++curEdge;
 				}
 			}
 		}
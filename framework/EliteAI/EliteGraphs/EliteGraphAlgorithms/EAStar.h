@@ -1,5 +1,8 @@
 #pragma once
 
+#include "EIndexedOpenList.h"
+#include "EBidirectionalSearch.h"
+
 namespace Elite
 {
 	template <class T_NodeType, class T_ConnectionType>
@@ -32,11 +35,44 @@ namespace Elite
 
 		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
 
+		// by default a goal in another component is swapped for the closest node that can be reached
+		void SetUnreachableGoal(UnreachableGoal unreachableGoal) { m_UnreachableGoal = unreachableGoal; }
+
+		// The heap and the bucket queue keep their records per node index instead of searching the open and closed lists
+		void SetOpenList(OpenList openList) { m_OpenList = openList; }
+
+		// Search from both ends at once (see BidirectionalSearch), optionally with the backward search on a second thread.
+		// Only undirected graphs are searched backwards, directed ones keep using a single search. Always uses a binary heap.
+		void SetBidirectional(bool isBidirectional, bool useTwoThreads = false) { m_IsBidirectional = isBidirectional; m_UseTwoThreads = useTwoThreads; }
+
+		// Only walk over nodes with at least this clearance (see IGraph::GetClearance), so one graph serves every agent size.
+		// The start and goal need it as well. A goal that can only be reached through narrower gaps gives an empty path.
+		void SetMinClearance(int minClearance) { m_MinClearance = minClearance; }
+
+		// nodes taken from the open list by the last FindPath
+		int GetNrOfExpandedNodes() const { return m_NrOfExpandedNodes; }
+
 	private:
 		float GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const;
+		bool HasClearance(int idx) const { return m_MinClearance <= 0 || m_pGraph->GetClearance(idx) >= m_MinClearance; }
+		std::vector<T_NodeType*> FindPathIndexed(T_NodeType* pStartNode, T_NodeType* pGoalNode);
+		std::vector<T_NodeType*> FindPathBidirectional(T_NodeType* pStartNode, T_NodeType* pGoalNode);
 
 		IGraph<T_NodeType, T_ConnectionType>* m_pGraph;
 		Heuristic m_HeuristicFunction;
+		UnreachableGoal m_UnreachableGoal = UnreachableGoal::redirect;
+		OpenList m_OpenList = OpenList::linearScan;
+		bool m_IsBidirectional = false;
+		bool m_UseTwoThreads = false;
+		int m_MinClearance = 0;
+		int m_NrOfExpandedNodes = 0;
+
+		// Per node buffers of FindPathIndexed, kept between searches. An entry only counts when its stamp is the one of the current search,
+		// so a short search (like the many small ones of HPAStar) doesn't pay for clearing buffers the size of the graph.
+		std::vector<float> m_CostsSoFar;
+		std::vector<T_ConnectionType*> m_Connections;
+		std::vector<unsigned int> m_SearchStamps;
+		unsigned int m_SearchStamp = 0;
 	};
 
 	template <class T_NodeType, class T_ConnectionType>
@@ -53,6 +89,28 @@ namespace Elite
 		vector<NodeRecord> openList;
 		vector<NodeRecord> closedList;
 		NodeRecord currentRecord{};
+		m_NrOfExpandedNodes = 0;
+
+		//without this check an unreachable goal makes the search visit every node it can reach before giving up
+		int startComponent = m_pGraph->GetComponent(pStartNode->GetIndex());
+		if (startComponent != m_pGraph->GetComponent(pGoalNode->GetIndex()))
+		{
+			if (m_UnreachableGoal == UnreachableGoal::reject)
+				return path;
+
+			int nearestIdx = m_pGraph->GetNearestNodeInComponent(pGoalNode->GetIndex(), startComponent);
+			if (nearestIdx == invalid_node_index)
+				return path;
+			pGoalNode = m_pGraph->GetNode(nearestIdx);
+		}
+
+		if (!HasClearance(pStartNode->GetIndex()) || !HasClearance(pGoalNode->GetIndex()))
+			return path;
+
+		if (m_IsBidirectional && !m_pGraph->IsDirectionalGraph())
+			return FindPathBidirectional(pStartNode, pGoalNode);
+		if (m_OpenList != OpenList::linearScan)
+			return FindPathIndexed(pStartNode, pGoalNode);
 
 		NodeRecord startRecord{};
 		startRecord.pNode = pStartNode;
@@ -69,6 +127,7 @@ namespace Elite
 
 			auto bestRecord = std::min_element(openList.begin(), openList.end());
 			currentRecord = *bestRecord;
+			++m_NrOfExpandedNodes;
 
 			if (currentRecord.pNode == pGoalNode)
 			{
@@ -79,6 +138,9 @@ namespace Elite
 			for (T_ConnectionType* connection : m_pGraph->GetNodeConnections(currentRecord.pNode->GetIndex()))
 			{
 				
+				if (!HasClearance(connection->GetTo()))
+					continue;
+
 				T_NodeType* nextNode = m_pGraph->GetNode(connection->GetTo());
 				float gCost{ currentRecord.costSoFar + connection->GetCost() };	
 				
@@ -116,6 +178,10 @@ namespace Elite
 			closedList.push_back(currentRecord);
 		}
 
+		//the component check can't see narrow gaps, so with a minimum clearance the goal can still be out of reach
+		if (currentRecord.pNode != pGoalNode)
+			return path;
+
 		while (currentRecord.pNode != startRecord.pNode)
 		{
 			path.push_back(currentRecord.pNode);
@@ -136,6 +202,102 @@ namespace Elite
 		return path;
 	}
 
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> AStar<T_NodeType, T_ConnectionType>::FindPathIndexed(T_NodeType* pStartNode, T_NodeType* pGoalNode)
+	{
+		IndexedOpenList openList(m_OpenList, m_pGraph->GetCostScale());
+		std::vector<T_NodeType*> path;
+
+		//new buffers when the graph grew, or when the stamp wraps around and old stamps could look current again
+		size_t nrOfNodes = static_cast<size_t>(m_pGraph->GetNrOfNodes());
+		if (m_SearchStamps.size() != nrOfNodes || ++m_SearchStamp == 0)
+		{
+			m_CostsSoFar.assign(nrOfNodes, 0.f);
+			m_Connections.assign(nrOfNodes, nullptr);
+			m_SearchStamps.assign(nrOfNodes, 0);
+			m_SearchStamp = 1;
+		}
+		auto getCostSoFar = [this](int idx) { return m_SearchStamps[idx] == m_SearchStamp ? m_CostsSoFar[idx] : std::numeric_limits<float>::infinity(); };
+
+		m_CostsSoFar[pStartNode->GetIndex()] = 0.f;
+		m_SearchStamps[pStartNode->GetIndex()] = m_SearchStamp;
+		openList.Push(pStartNode->GetIndex(), 0.f, GetHeuristicCost(pStartNode, pGoalNode));
+
+		bool isGoalFound = false;
+		while (!openList.IsEmpty())
+		{
+			IndexedOpenList::Entry current = openList.Pop();
+
+			//a cheaper way to this node was pushed after this entry
+			if (current.costSoFar > getCostSoFar(current.idx))
+				continue;
+
+			++m_NrOfExpandedNodes;
+			if (current.idx == pGoalNode->GetIndex())
+			{
+				isGoalFound = true;
+				break;
+			}
+
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(current.idx))
+			{
+				int nextIdx = pConnection->GetTo();
+				if (!HasClearance(nextIdx))
+					continue;
+
+				float costSoFar = current.costSoFar + pConnection->GetCost();
+				if (costSoFar < getCostSoFar(nextIdx))
+				{
+					m_CostsSoFar[nextIdx] = costSoFar;
+					m_Connections[nextIdx] = pConnection;
+					m_SearchStamps[nextIdx] = m_SearchStamp;
+					openList.Push(nextIdx, costSoFar, GetHeuristicCost(m_pGraph->GetNode(nextIdx), pGoalNode));
+				}
+			}
+		}
+
+		if (!isGoalFound)
+			return path;
+
+		for (int idx = pGoalNode->GetIndex(); idx != pStartNode->GetIndex(); idx = m_Connections[idx]->GetFrom())
+			path.push_back(m_pGraph->GetNode(idx));
+		path.push_back(pStartNode);
+		std::reverse(path.begin(), path.end());
+
+		return path;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> AStar<T_NodeType, T_ConnectionType>::FindPathBidirectional(T_NodeType* pStartNode, T_NodeType* pGoalNode)
+	{
+		BidirectionalSearch search(m_pGraph->GetNrOfNodes());
+
+		//every connection has a twin in the other direction with the same cost, so both sides can follow the same lists
+		auto getSuccessors = [this](int idx, int, int, int, std::vector<std::pair<int, float>>& successors)
+		{
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(idx))
+			{
+				if (HasClearance(pConnection->GetTo()))
+					successors.push_back({ pConnection->GetTo(), pConnection->GetCost() });
+			}
+		};
+		auto getHeuristicCost = [this](int idx, int targetIdx)
+		{
+			return GetHeuristicCost(m_pGraph->GetNode(idx), m_pGraph->GetNode(targetIdx));
+		};
+
+		std::vector<T_NodeType*> path;
+		bool isPathFound = search.Search(pStartNode->GetIndex(), pGoalNode->GetIndex(), getSuccessors, getHeuristicCost, m_UseTwoThreads);
+		m_NrOfExpandedNodes = search.GetNrOfExpandedNodes();
+		if (!isPathFound)
+			return path;
+
+		for (int idx : search.GetPath())
+			path.push_back(m_pGraph->GetNode(idx));
+
+		return path;
+	}
+
 	template <class T_NodeType, class T_ConnectionType>
 	float Elite::AStar<T_NodeType, T_ConnectionType>::GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const
 	{
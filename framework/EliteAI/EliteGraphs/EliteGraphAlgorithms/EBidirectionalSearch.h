@@ -0,0 +1,230 @@
+#pragma once
+
+#include "EIndexedOpenList.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace Elite
+{
+	// Two A* searches on an undirected graph, one from the start towards the goal and one from the goal towards the start.
+	// Whenever a side reaches a node the other side has a cost for, the sum is a path and the cheapest one is kept.
+	// Both sides order their open list by g + p, with p = (h(node, goal) - h(node, start)) / 2 going forward and -p going backward.
+	// With a consistent heuristic both searches then see the same non-negative costs, so the search can stop as soon as the
+	// lowest keys of both sides add up to the cheapest path found. (Stopping when one side's lowest f-cost reaches it is
+	// correct as well, but lets each side run far past the middle.)
+	// That only holds when both sides search the same graph. When they don't (JPS prunes successors by the direction it came from,
+	// so both sides stop on different jump points) a path the sides haven't met on yet isn't bounded by their keys. Such searches
+	// turn off SetIsSymmetric: then each side orders by its own f-cost and only the forward side ends the search, once its lowest f-cost
+	// reaches the cheapest path. It expands the same nodes a single A* would, the backward side only adds paths where it meets it.
+	// With two threads each side runs on its own, they share the costs per node, the lowest key of each side and the cheapest path.
+	// The keys aren't whole numbers of cost steps, so the sides always use a binary heap.
+	class BidirectionalSearch
+	{
+	public:
+		explicit BidirectionalSearch(int nrOfNodes);
+
+		// whether the backward side sees the same successors as the forward side would going the other way, see above
+		void SetIsSymmetric(bool isSymmetric) { m_IsSymmetric = isSymmetric; }
+
+		// getSuccessors(idx, parentIdx, startIdx, goalIdx, successors) fills successors with (node, cost) pairs, parentIdx is
+		// invalid_node_index for the side's own start. getHeuristicCost(idx, targetIdx) estimates the cost between two nodes.
+		// Both are called from both threads at once in two thread mode. Returns false when there is no path.
+		template <class T_Successors, class T_HeuristicCost>
+		bool Search(int startIdx, int goalIdx, const T_Successors& getSuccessors, const T_HeuristicCost& getHeuristicCost, bool useTwoThreads);
+
+		// node indices from start to goal
+		std::vector<int> GetPath() const;
+		float GetPathCost() const { return m_BestCost; }
+		int GetNrOfExpandedNodes() const { return m_Frontiers[0].nrOfExpandedNodes + m_Frontiers[1].nrOfExpandedNodes; }
+		// expanded nodes of the forward search followed by those of the backward search
+		std::vector<int> GetExpandedNodes() const;
+
+	private:
+		struct Frontier
+		{
+			Frontier(int nrOfNodes);
+
+			IndexedOpenList openList;
+			std::vector<std::atomic<float>> costsSoFar; // read by the other side
+			std::atomic<float> minKey; // key of the last entry taken from the open list, read by the other side
+			std::vector<int> parents;
+			std::vector<int> expandedNodes;
+			std::vector<std::pair<int, float>> successors;
+			int startIdx = invalid_node_index;
+			int targetIdx = invalid_node_index;
+			int nrOfExpandedNodes = 0;
+		};
+
+		// expands one node, returns false when this side is done
+		template <class T_Successors, class T_HeuristicCost>
+		bool Step(Frontier& side, const Frontier& other, const T_Successors& getSuccessors, const T_HeuristicCost& getHeuristicCost);
+		template <class T_HeuristicCost>
+		float GetPotential(const Frontier& side, int idx, const T_HeuristicCost& getHeuristicCost) const;
+		void OnMeet(int idx, float cost);
+
+		Frontier m_Frontiers[2];
+		std::atomic<float> m_BestCost;
+		std::atomic<bool> m_IsDone;
+		std::mutex m_MeetMutex;
+		int m_MeetIdx = invalid_node_index;
+		bool m_IsSymmetric = true;
+	};
+
+	inline BidirectionalSearch::Frontier::Frontier(int nrOfNodes)
+		: openList(OpenList::binaryHeap, 0.f)
+		, costsSoFar(nrOfNodes)
+		, minKey(-std::numeric_limits<float>::infinity())
+		, parents(nrOfNodes, invalid_node_index)
+	{
+		for (std::atomic<float>& cost : costsSoFar)
+			cost.store(std::numeric_limits<float>::infinity(), std::memory_order_relaxed);
+	}
+
+	inline BidirectionalSearch::BidirectionalSearch(int nrOfNodes)
+		: m_Frontiers{ { nrOfNodes }, { nrOfNodes } }
+		, m_BestCost(std::numeric_limits<float>::infinity())
+		, m_IsDone(false)
+	{
+	}
+
+	template <class T_Successors, class T_HeuristicCost>
+	bool BidirectionalSearch::Search(int startIdx, int goalIdx, const T_Successors& getSuccessors, const T_HeuristicCost& getHeuristicCost, bool useTwoThreads)
+	{
+		Frontier& forward = m_Frontiers[0];
+		Frontier& backward = m_Frontiers[1];
+		forward.startIdx = startIdx;
+		forward.targetIdx = goalIdx;
+		backward.startIdx = goalIdx;
+		backward.targetIdx = startIdx;
+
+		for (Frontier& side : m_Frontiers)
+		{
+			side.costsSoFar[side.startIdx].store(0.f);
+			side.openList.Push(side.startIdx, 0.f, GetPotential(side, side.startIdx, getHeuristicCost));
+			side.minKey.store(side.openList.GetMinCost());
+		}
+
+		if (startIdx == goalIdx)
+			OnMeet(startIdx, 0.f);
+
+		if (useTwoThreads)
+		{
+			auto run = [&](Frontier& side, const Frontier& other)
+			{
+				while (!m_IsDone.load(std::memory_order_relaxed) && Step(side, other, getSuccessors, getHeuristicCost));
+				if (m_IsSymmetric || &side == &forward)
+					m_IsDone.store(true);
+			};
+
+			std::thread backwardThread(run, std::ref(backward), std::cref(forward));
+			run(forward, backward);
+			backwardThread.join();
+		}
+		else
+		{
+			//expand the side with the smaller open list, so both sides grow about as fast
+			bool isBackwardRunning = true;
+			while (true)
+			{
+				if (!isBackwardRunning || forward.openList.GetSize() <= backward.openList.GetSize())
+				{
+					if (!Step(forward, backward, getSuccessors, getHeuristicCost))
+						break;
+				}
+				else if (!Step(backward, forward, getSuccessors, getHeuristicCost))
+				{
+					if (m_IsSymmetric)
+						break;
+					isBackwardRunning = false;
+				}
+			}
+		}
+
+		return m_MeetIdx != invalid_node_index;
+	}
+
+	template <class T_Successors, class T_HeuristicCost>
+	bool BidirectionalSearch::Step(Frontier& side, const Frontier& other, const T_Successors& getSuccessors, const T_HeuristicCost& getHeuristicCost)
+	{
+		//an empty side has reached everything it can, the other side can't find more than that either
+		if (side.openList.IsEmpty())
+			return false;
+
+		float lowerBound = m_IsSymmetric ? side.openList.GetMinCost() + other.minKey.load() : side.openList.GetMinCost();
+		if (lowerBound >= m_BestCost.load())
+			return false;
+
+		IndexedOpenList::Entry current = side.openList.Pop();
+		side.minKey.store(current.estimatedTotalCost);
+
+		//a cheaper way to this node was pushed after this entry
+		if (current.costSoFar > side.costsSoFar[current.idx].load(std::memory_order_relaxed))
+			return true;
+
+		++side.nrOfExpandedNodes;
+		side.expandedNodes.push_back(current.idx);
+
+		side.successors.clear();
+		getSuccessors(current.idx, side.parents[current.idx], side.startIdx, side.targetIdx, side.successors);
+		for (const std::pair<int, float>& successor : side.successors)
+		{
+			float costSoFar = current.costSoFar + successor.second;
+			if (costSoFar >= side.costsSoFar[successor.first].load(std::memory_order_relaxed))
+				continue;
+
+			//store before reading the other side's cost: when both sides reach a node at once, at least one of them sees the other
+			side.costsSoFar[successor.first].store(costSoFar);
+			side.parents[successor.first] = current.idx;
+			side.openList.Push(successor.first, costSoFar, GetPotential(side, successor.first, getHeuristicCost));
+
+			float otherCost = other.costsSoFar[successor.first].load();
+			if (costSoFar + otherCost < m_BestCost.load())
+				OnMeet(successor.first, costSoFar + otherCost);
+		}
+
+		return true;
+	}
+
+	template <class T_HeuristicCost>
+	float BidirectionalSearch::GetPotential(const Frontier& side, int idx, const T_HeuristicCost& getHeuristicCost) const
+	{
+		if (!m_IsSymmetric)
+			return getHeuristicCost(idx, side.targetIdx);
+
+		return (getHeuristicCost(idx, side.targetIdx) - getHeuristicCost(idx, side.startIdx)) / 2.f;
+	}
+
+	inline void BidirectionalSearch::OnMeet(int idx, float cost)
+	{
+		std::lock_guard<std::mutex> lock(m_MeetMutex);
+		if (cost < m_BestCost.load())
+		{
+			m_BestCost.store(cost);
+			m_MeetIdx = idx;
+		}
+	}
+
+	inline std::vector<int> BidirectionalSearch::GetPath() const
+	{
+		std::vector<int> path;
+		if (m_MeetIdx == invalid_node_index)
+			return path;
+
+		for (int idx = m_MeetIdx; idx != invalid_node_index; idx = m_Frontiers[0].parents[idx])
+			path.push_back(idx);
+		std::reverse(path.begin(), path.end());
+
+		for (int idx = m_Frontiers[1].parents[m_MeetIdx]; idx != invalid_node_index; idx = m_Frontiers[1].parents[idx])
+			path.push_back(idx);
+
+		return path;
+	}
+
+	inline std::vector<int> BidirectionalSearch::GetExpandedNodes() const
+	{
+		std::vector<int> expandedNodes = m_Frontiers[0].expandedNodes;
+		expandedNodes.insert(expandedNodes.end(), m_Frontiers[1].expandedNodes.begin(), m_Frontiers[1].expandedNodes.end());
+		return expandedNodes;
+	}
+}
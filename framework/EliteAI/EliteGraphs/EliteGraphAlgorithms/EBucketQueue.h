@@ -0,0 +1,117 @@
+#pragma once
+
+namespace Elite
+{
+	// Priority queue for whole number keys: one bucket per key, kept in a ring that covers the span between the smallest and largest key.
+	// Push is O(1), Pop is amortized O(1) as long as the keys that get popped don't decrease (like f-costs in A* with a consistent heuristic).
+	// Values with the same key come out last in, first out.
+	template <class T_Value>
+	class BucketQueue
+	{
+	public:
+		explicit BucketQueue(unsigned int nrOfBuckets = 64);
+
+		void Push(unsigned int key, const T_Value& value);
+		T_Value Pop();
+		unsigned int GetMinKey();
+
+		bool IsEmpty() const { return m_Size == 0; }
+		size_t GetSize() const { return m_Size; }
+		void Clear();
+
+	private:
+		void Grow(unsigned int span);
+
+		std::vector<std::vector<T_Value>> m_Buckets; // key k is stored in bucket k & (size - 1), size is a power of two
+		unsigned int m_MinKey = 0; // no key is smaller, the bucket it points at can be empty
+		unsigned int m_MaxKey = 0; // no key is larger
+		size_t m_Size = 0;
+	};
+
+	template <class T_Value>
+	BucketQueue<T_Value>::BucketQueue(unsigned int nrOfBuckets)
+	{
+		unsigned int size = 1;
+		while (size < nrOfBuckets)
+			size <<= 1;
+
+		m_Buckets.resize(size);
+	}
+
+	template <class T_Value>
+	void BucketQueue<T_Value>::Push(unsigned int key, const T_Value& value)
+	{
+		if (m_Size == 0)
+		{
+			m_MinKey = key;
+			m_MaxKey = key;
+		}
+		else if (key < m_MinKey)
+		{
+			Grow(m_MaxKey - key + 1);
+			m_MinKey = key;
+		}
+		else if (key > m_MaxKey)
+		{
+			Grow(key - m_MinKey + 1);
+			m_MaxKey = key;
+		}
+
+		m_Buckets[key & (m_Buckets.size() - 1)].push_back(value);
+		++m_Size;
+	}
+
+	template <class T_Value>
+	T_Value BucketQueue<T_Value>::Pop()
+	{
+		assert(m_Size > 0 && "<BucketQueue::Pop>: queue is empty");
+
+		std::vector<T_Value>& bucket = m_Buckets[GetMinKey() & (m_Buckets.size() - 1)];
+		T_Value value = bucket.back();
+		bucket.pop_back();
+		--m_Size;
+
+		return value;
+	}
+
+	template <class T_Value>
+	unsigned int BucketQueue<T_Value>::GetMinKey()
+	{
+		assert(m_Size > 0 && "<BucketQueue::GetMinKey>: queue is empty");
+
+		while (m_Buckets[m_MinKey & (m_Buckets.size() - 1)].empty())
+			++m_MinKey;
+
+		return m_MinKey;
+	}
+
+	template <class T_Value>
+	void BucketQueue<T_Value>::Clear()
+	{
+		for (std::vector<T_Value>& bucket : m_Buckets)
+			bucket.clear();
+
+		m_Size = 0;
+	}
+
+	template <class T_Value>
+	void BucketQueue<T_Value>::Grow(unsigned int span)
+	{
+		if (span <= m_Buckets.size())
+			return;
+
+		size_t size = m_Buckets.size();
+		while (size < span)
+			size <<= 1;
+
+		//every stored key lies in [m_MinKey, m_MinKey + old size), so each old bucket maps onto exactly one new one
+		std::vector<std::vector<T_Value>> buckets(size);
+		for (unsigned int i = 0; i < m_Buckets.size(); ++i)
+		{
+			unsigned int key = m_MinKey + i;
+			buckets[key & (size - 1)].swap(m_Buckets[key & (m_Buckets.size() - 1)]);
+		}
+
+		m_Buckets.swap(buckets);
+	}
+}
@@ -0,0 +1,373 @@
+#pragma once
+#include <limits>
+#include <thread>
+#include <atomic>
+#include "framework/EliteHelpers/EMappedFile.h"
+
+namespace Elite
+{
+	// First move tables for static GridGraphs: for every (start, goal) pair the neighbour of start on a cheapest path to goal.
+	// Built offline with a Dijkstra from every node, queries then follow first moves with no search at all.
+	// Goals are ordered along a Hilbert curve so nearby goals, which mostly share a first move, sit next to each other,
+	// and every start keeps its row of moves run length encoded. Goals in another component can't be asked for,
+	// they take whatever move extends the current run.
+	// The tables are one block of 32 bit words that is saved as is, loading maps the file instead of reading it.
+	template <class T_NodeType, class T_ConnectionType>
+	class CompressedPathDatabase
+	{
+	public:
+		explicit CompressedPathDatabase(GridGraph<T_NodeType, T_ConnectionType>* pGraph);
+
+		// one Dijkstra per node, spread over nrOfThreads threads (0 uses every hardware thread)
+		void Build(int nrOfThreads = 0);
+		bool Save(const std::string& path) const;
+		// false when the file can't be mapped or was built for a grid of another size, the database is empty then
+		bool Load(const std::string& path);
+		void Clear();
+		bool IsBuilt() const { return m_pData != nullptr; }
+
+		// neighbour to step to from start towards goal, invalid_node_index at the goal or when there's no path
+		int GetNextNodeIdx(int startIdx, int goalIdx) const;
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pGoalNode) const;
+
+		// Statistics
+		unsigned int GetNrOfRuns() const { return m_pData ? m_pData[m_NrOfRunsWord] : 0; }
+		float GetBuildTime() const { return m_BuildTime; } // ms spent on the last build
+		size_t GetMemoryUsage() const { return m_DataSize * sizeof(unsigned int); } // bytes of the tables, also the file size
+
+	private:
+		// a move is the offset to the neighbour as (dRow + 1) * 3 + dCol + 1, the middle one means no move
+		static const unsigned int m_NoMove = 4;
+		static const unsigned int m_MoveBits = 4;
+
+		// file layout, in words: the header, the Hilbert rank and component of every node,
+		// for every start the offset of its first run (plus the end), then all runs as rank << m_MoveBits | move
+		static const unsigned int m_Magic = 0x42445045; // "EPDB"
+		static const unsigned int m_Version = 1;
+		static const size_t m_ColumnsWord = 2;
+		static const size_t m_RowsWord = 3;
+		static const size_t m_NrOfRunsWord = 4;
+		static const size_t m_HeaderSize = 5;
+
+		struct Neighbour
+		{
+			int idx;
+			float cost;
+			unsigned int move;
+		};
+
+		void BuildRanks(std::vector<unsigned int>& ranks) const;
+		void BuildRuns(int startIdx, const std::vector<std::vector<Neighbour>>& neighbours, const std::vector<int>& goalsByRank,
+			const std::vector<unsigned int>& components, std::vector<float>& costs, std::vector<unsigned char>& firstMoves, std::vector<unsigned int>& runs) const;
+		static unsigned int GetHilbertIndex(unsigned int size, unsigned int col, unsigned int row);
+		void SetData(const unsigned int* pData, size_t dataSize);
+
+		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+
+		// point into m_Data after a build, into m_File after a load
+		const unsigned int* m_pData = nullptr;
+		size_t m_DataSize = 0;
+		const unsigned int* m_pRanks = nullptr;
+		const unsigned int* m_pComponents = nullptr;
+		const unsigned int* m_pOffsets = nullptr;
+		const unsigned int* m_pRuns = nullptr;
+
+		std::vector<unsigned int> m_Data;
+		MappedFile m_File;
+
+		float m_BuildTime = 0.f;
+	};
+
+	template <class T_NodeType, class T_ConnectionType>
+	CompressedPathDatabase<T_NodeType, T_ConnectionType>::CompressedPathDatabase(GridGraph<T_NodeType, T_ConnectionType>* pGraph)
+		: m_pGraph(pGraph)
+	{
+		assert(static_cast<unsigned long long>(pGraph->GetNrOfNodes()) < (1ULL << (32 - m_MoveBits)) && "<CompressedPathDatabase::CompressedPathDatabase>: too many nodes to pack a rank and a move in a word");
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CompressedPathDatabase<T_NodeType, T_ConnectionType>::Build(int nrOfThreads)
+	{
+		auto startTime = std::chrono::high_resolution_clock::now();
+		Clear();
+
+		const int nrOfNodes = m_pGraph->GetNrOfNodes();
+		const int nrOfColumns = m_pGraph->GetColumns();
+
+		// the connections as flat arrays, walking the linked lists in every Dijkstra would cost more than the search itself
+		std::vector<std::vector<Neighbour>> neighbours(nrOfNodes);
+		for (int idx = 0; idx < nrOfNodes; ++idx)
+		{
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(idx))
+			{
+				const int toIdx = pConnection->GetTo();
+				const int dCol = toIdx % nrOfColumns - idx % nrOfColumns;
+				const int dRow = toIdx / nrOfColumns - idx / nrOfColumns;
+				neighbours[idx].push_back({ toIdx, pConnection->GetCost(), static_cast<unsigned int>((dRow + 1) * 3 + dCol + 1) });
+			}
+		}
+
+		std::vector<unsigned int> ranks;
+		BuildRanks(ranks);
+		std::vector<int> goalsByRank(nrOfNodes);
+		for (int idx = 0; idx < nrOfNodes; ++idx)
+			goalsByRank[ranks[idx]] = idx;
+
+		// looked up once, the graph finds components lazily and isn't safe to ask from several threads
+		std::vector<unsigned int> components(nrOfNodes);
+		for (int idx = 0; idx < nrOfNodes; ++idx)
+			components[idx] = static_cast<unsigned int>(m_pGraph->GetComponent(idx));
+
+		// every start writes only its own runs, workers pull the next start from a shared counter
+		std::vector<std::vector<unsigned int>> runsPerStart(nrOfNodes);
+		std::atomic<int> nextStart{ 0 };
+		auto worker = [this, &neighbours, &goalsByRank, &components, &runsPerStart, &nextStart, nrOfNodes]()
+		{
+			std::vector<float> costs(nrOfNodes);
+			std::vector<unsigned char> firstMoves(nrOfNodes);
+			for (int startIdx = nextStart++; startIdx < nrOfNodes; startIdx = nextStart++)
+				BuildRuns(startIdx, neighbours, goalsByRank, components, costs, firstMoves, runsPerStart[startIdx]);
+		};
+
+		if (nrOfThreads <= 0)
+			nrOfThreads = static_cast<int>(std::thread::hardware_concurrency());
+		if (nrOfThreads > nrOfNodes)
+			nrOfThreads = nrOfNodes;
+
+		std::vector<std::thread> threads;
+		for (int i = 1; i < nrOfThreads; ++i)
+			threads.emplace_back(worker);
+		worker();
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		size_t nrOfRuns = 0;
+		for (const std::vector<unsigned int>& runs : runsPerStart)
+			nrOfRuns += runs.size();
+		assert(nrOfRuns <= (std::numeric_limits<unsigned int>::max)() && "<CompressedPathDatabase::Build>: too many runs for 32 bit offsets");
+
+		m_Data.reserve(m_HeaderSize + 3 * static_cast<size_t>(nrOfNodes) + 1 + nrOfRuns);
+		m_Data.insert(m_Data.end(), { m_Magic, m_Version, static_cast<unsigned int>(nrOfColumns), static_cast<unsigned int>(m_pGraph->GetRows()), static_cast<unsigned int>(nrOfRuns) });
+		m_Data.insert(m_Data.end(), ranks.begin(), ranks.end());
+		m_Data.insert(m_Data.end(), components.begin(), components.end());
+
+		unsigned int offset = 0;
+		for (const std::vector<unsigned int>& runs : runsPerStart)
+		{
+			m_Data.push_back(offset);
+			offset += static_cast<unsigned int>(runs.size());
+		}
+		m_Data.push_back(offset);
+
+		for (std::vector<unsigned int>& runs : runsPerStart)
+		{
+			m_Data.insert(m_Data.end(), runs.begin(), runs.end());
+			std::vector<unsigned int>().swap(runs);
+		}
+
+		SetData(m_Data.data(), m_Data.size());
+		m_BuildTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CompressedPathDatabase<T_NodeType, T_ConnectionType>::BuildRuns(int startIdx, const std::vector<std::vector<Neighbour>>& neighbours, const std::vector<int>& goalsByRank,
+		const std::vector<unsigned int>& components, std::vector<float>& costs, std::vector<unsigned char>& firstMoves, std::vector<unsigned int>& runs) const
+	{
+		using QueueEntry = std::pair<float, int>;
+		std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> openList;
+
+		std::fill(costs.begin(), costs.end(), std::numeric_limits<float>::infinity());
+		costs[startIdx] = 0.f;
+		openList.push({ 0.f, startIdx });
+
+		// every node inherits the first move of the node it was reached from, the start's neighbours get the move to them
+		while (!openList.empty())
+		{
+			QueueEntry current = openList.top();
+			openList.pop();
+			if (current.first > costs[current.second])
+				continue;
+
+			for (const Neighbour& neighbour : neighbours[current.second])
+			{
+				const float cost = current.first + neighbour.cost;
+				if (cost < costs[neighbour.idx])
+				{
+					costs[neighbour.idx] = cost;
+					firstMoves[neighbour.idx] = static_cast<unsigned char>(current.second == startIdx ? neighbour.move : firstMoves[current.second]);
+					openList.push({ cost, neighbour.idx });
+				}
+			}
+		}
+
+		unsigned int runMove = (std::numeric_limits<unsigned int>::max)();
+		for (int rank = 0; rank < static_cast<int>(goalsByRank.size()); ++rank)
+		{
+			const int goalIdx = goalsByRank[rank];
+			if (goalIdx == startIdx || components[goalIdx] != components[startIdx])
+				continue;
+
+			const unsigned int move = costs[goalIdx] == std::numeric_limits<float>::infinity() ? m_NoMove : firstMoves[goalIdx];
+			if (move != runMove)
+			{
+				runs.push_back(static_cast<unsigned int>(rank) << m_MoveBits | move);
+				runMove = move;
+			}
+		}
+
+		// the first run starts at rank 0, so every goal falls in a run
+		if (runs.empty())
+			runs = { m_NoMove };
+		runs[0] &= (1u << m_MoveBits) - 1;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CompressedPathDatabase<T_NodeType, T_ConnectionType>::BuildRanks(std::vector<unsigned int>& ranks) const
+	{
+		unsigned int size = 1;
+		while (size < static_cast<unsigned int>(m_pGraph->GetColumns()) || size < static_cast<unsigned int>(m_pGraph->GetRows()))
+			size *= 2;
+
+		const int nrOfNodes = m_pGraph->GetNrOfNodes();
+		std::vector<std::pair<unsigned int, int>> curveIndices(nrOfNodes);
+		for (int idx = 0; idx < nrOfNodes; ++idx)
+			curveIndices[idx] = { GetHilbertIndex(size, idx % m_pGraph->GetColumns(), idx / m_pGraph->GetColumns()), idx };
+		std::sort(curveIndices.begin(), curveIndices.end());
+
+		ranks.resize(nrOfNodes);
+		for (int rank = 0; rank < nrOfNodes; ++rank)
+			ranks[curveIndices[rank].second] = static_cast<unsigned int>(rank);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	unsigned int CompressedPathDatabase<T_NodeType, T_ConnectionType>::GetHilbertIndex(unsigned int size, unsigned int col, unsigned int row)
+	{
+		// distance along the Hilbert curve through a size x size square, size is a power of two
+		unsigned int index = 0;
+		for (unsigned int half = size / 2; half > 0; half /= 2)
+		{
+			const unsigned int isRight = (col & half) ? 1 : 0;
+			const unsigned int isTop = (row & half) ? 1 : 0;
+			index += half * half * ((3 * isRight) ^ isTop);
+
+			// turn the quadrant so the curve enters it where the previous one left off
+			if (isTop == 0)
+			{
+				if (isRight == 1)
+				{
+					col = size - 1 - col;
+					row = size - 1 - row;
+				}
+
+				const unsigned int temp = col;
+				col = row;
+				row = temp;
+			}
+		}
+
+		return index;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	bool CompressedPathDatabase<T_NodeType, T_ConnectionType>::Save(const std::string& path) const
+	{
+		if (!m_pData)
+			return false;
+
+		// raw words in the byte order of this machine, Load maps them back as they are
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(m_pData), static_cast<std::streamsize>(m_DataSize * sizeof(unsigned int)));
+		return file.good();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	bool CompressedPathDatabase<T_NodeType, T_ConnectionType>::Load(const std::string& path)
+	{
+		Clear();
+		if (!m_File.Open(path))
+			return false;
+
+		const unsigned int* pData = reinterpret_cast<const unsigned int*>(m_File.GetData());
+		const size_t dataSize = m_File.GetSize() / sizeof(unsigned int);
+		const size_t nrOfNodes = static_cast<size_t>(m_pGraph->GetNrOfNodes());
+		if (m_File.GetSize() % sizeof(unsigned int) != 0 || dataSize < m_HeaderSize
+			|| pData[0] != m_Magic || pData[1] != m_Version
+			|| pData[m_ColumnsWord] != static_cast<unsigned int>(m_pGraph->GetColumns()) || pData[m_RowsWord] != static_cast<unsigned int>(m_pGraph->GetRows())
+			|| dataSize != m_HeaderSize + 3 * nrOfNodes + 1 + pData[m_NrOfRunsWord])
+		{
+			m_File.Close();
+			return false;
+		}
+
+		SetData(pData, dataSize);
+		return true;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CompressedPathDatabase<T_NodeType, T_ConnectionType>::Clear()
+	{
+		m_pData = nullptr;
+		m_DataSize = 0;
+		m_pRanks = nullptr;
+		m_pComponents = nullptr;
+		m_pOffsets = nullptr;
+		m_pRuns = nullptr;
+
+		std::vector<unsigned int>().swap(m_Data);
+		m_File.Close();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CompressedPathDatabase<T_NodeType, T_ConnectionType>::SetData(const unsigned int* pData, size_t dataSize)
+	{
+		const size_t nrOfNodes = static_cast<size_t>(m_pGraph->GetNrOfNodes());
+		m_pData = pData;
+		m_DataSize = dataSize;
+		m_pRanks = pData + m_HeaderSize;
+		m_pComponents = m_pRanks + nrOfNodes;
+		m_pOffsets = m_pComponents + nrOfNodes;
+		m_pRuns = m_pOffsets + nrOfNodes + 1;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	int CompressedPathDatabase<T_NodeType, T_ConnectionType>::GetNextNodeIdx(int startIdx, int goalIdx) const
+	{
+		assert(m_pData && "<CompressedPathDatabase::GetNextNodeIdx>: build or load the database first");
+		if (startIdx == goalIdx || m_pComponents[startIdx] != m_pComponents[goalIdx])
+			return invalid_node_index;
+
+		// the last run that starts at or before the goal's rank
+		const unsigned int* pFirst = m_pRuns + m_pOffsets[startIdx];
+		const unsigned int* pLast = m_pRuns + m_pOffsets[startIdx + 1];
+		const unsigned int key = m_pRanks[goalIdx] << m_MoveBits | ((1u << m_MoveBits) - 1);
+		const unsigned int move = *(std::upper_bound(pFirst, pLast, key) - 1) & ((1u << m_MoveBits) - 1);
+		if (move == m_NoMove)
+			return invalid_node_index;
+
+		const int dCol = static_cast<int>(move % 3) - 1;
+		const int dRow = static_cast<int>(move / 3) - 1;
+		return startIdx + dRow * m_pGraph->GetColumns() + dCol;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> CompressedPathDatabase<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pGoalNode) const
+	{
+		std::vector<T_NodeType*> path;
+		int idx = pStartNode->GetIndex();
+		const int goalIdx = pGoalNode->GetIndex();
+		path.push_back(pStartNode);
+
+		// every first move lies on a cheapest path, so following them can't take more steps than there are nodes
+		while (idx != goalIdx && static_cast<int>(path.size()) <= m_pGraph->GetNrOfNodes())
+		{
+			idx = GetNextNodeIdx(idx, goalIdx);
+			if (idx == invalid_node_index)
+				return {};
+
+			path.push_back(m_pGraph->GetNode(idx));
+		}
+
+		return path;
+	}
+}
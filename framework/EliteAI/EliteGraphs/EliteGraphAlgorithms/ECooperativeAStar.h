@@ -0,0 +1,339 @@
+#pragma once
+
+#include <unordered_map>
+#include "EIndexedOpenList.h"
+#include "EReservationTable.h"
+
+namespace Elite
+{
+	// Windowed hierarchical cooperative A* (WHCA*): many agents on one undirected GridGraph that path without running into each other.
+	// Agents plan one after the other in priority order, through space and time: a move or a wait takes one time step, every step
+	// of a plan is reserved and the agents after it avoid those nodes and won't swap places with their owners.
+	// Plans only look a window of steps ahead and are redone every few steps. The cost beyond the window is the true distance to
+	// the goal on the grid without agents, found by a reverse resumable A* from the goal that every agent keeps for itself.
+	template <class T_NodeType, class T_ConnectionType>
+	class CooperativeAStar
+	{
+	public:
+		CooperativeAStar(GridGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction, int window = 16, int replanInterval = 8);
+
+		// returns the index of the agent, higher priorities plan first
+		int AddAgent(int startIdx, int goalIdx, int priority = 0);
+		void SetGoal(int agent, int goalIdx);
+		void SetPriority(int agent, int priority);
+
+		// a plan runs out after the window, so the replan interval can't be longer
+		void SetWindow(int window);
+		void SetReplanInterval(int replanInterval);
+		// cost of standing still for a step, except on the goal where it's free
+		void SetWaitCost(float waitCost) { m_WaitCost = waitCost; }
+
+		// plans again when it's time (or agents and goals changed), then moves every agent one step
+		void Step();
+
+		int GetNrOfAgents() const { return static_cast<int>(m_Agents.size()); }
+		int GetAgentNode(int agent) const { return m_Agents[agent].idx; }
+		bool IsAtGoal(int agent) const { return m_Agents[agent].idx == m_Agents[agent].goalIdx; }
+		// nodes for the coming time steps, starting with the current one
+		std::vector<int> GetAgentPlan(int agent) const;
+		unsigned int GetTimeStep() const { return m_TimeStep; }
+
+		// space-time nodes expanded by the last replan
+		int GetNrOfExpandedNodes() const { return m_NrOfExpandedNodes; }
+		// Steps that couldn't be reserved because an agent was boxed in and had to stay put, other agents can run into it there.
+		// Counts every replan since the start.
+		int GetNrOfConflicts() const { return m_NrOfConflicts; }
+		size_t GetReservationMemoryUsage() const { return m_Reservations.GetMemoryUsage(); }
+
+	private:
+		struct DistanceRecord
+		{
+			float costSoFar;
+			bool isClosed;
+		};
+
+		struct Agent
+		{
+			int idx;
+			int goalIdx;
+			int priority;
+			std::vector<int> plan; // node per time step, from the last replan on
+
+			// reverse resumable A*: searches from the goal towards where the agent was when it got the goal and resumes whenever
+			// the distance of a node that isn't closed yet is asked
+			IndexedOpenList distanceOpenList;
+			std::unordered_map<int, DistanceRecord> distances; // closed nodes have their true distance
+			int distanceTargetIdx;
+		};
+
+		// space-time search node, (idx, step) is found back through m_Visited
+		struct Record
+		{
+			int idx;
+			int step;
+			int parent;
+			float costSoFar;
+			bool isClosed;
+		};
+
+		void Replan();
+		void PlanAgent(int agent);
+		void ResetDistances(Agent& agent);
+		float GetTrueDistance(Agent& agent, int idx);
+		float GetHeuristicCost(int fromIdx, int toIdx) const;
+
+		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		Heuristic m_HeuristicFunction;
+		int m_Window;
+		int m_ReplanInterval;
+		float m_WaitCost = 1.f;
+
+		std::vector<Agent> m_Agents;
+		ReservationTable m_Reservations;
+		unsigned int m_TimeStep = 0;
+		unsigned int m_PlanTime = 0; // time step of the last replan
+		bool m_IsPlanOutdated = true;
+
+		// scratch space of the space-time search, m_Visited holds record indices instead of agents
+		std::vector<Record> m_Records;
+		ReservationTable m_Visited;
+
+		int m_NrOfExpandedNodes = 0;
+		int m_NrOfConflicts = 0;
+	};
+
+	template <class T_NodeType, class T_ConnectionType>
+	CooperativeAStar<T_NodeType, T_ConnectionType>::CooperativeAStar(GridGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction, int window, int replanInterval)
+		: m_pGraph(pGraph)
+		, m_HeuristicFunction(hFunction)
+		, m_Window(window)
+		, m_ReplanInterval(replanInterval)
+	{
+		assert(!pGraph->IsDirectionalGraph() && "<CooperativeAStar::CooperativeAStar>: the distances are searched backwards, connections have to go both ways");
+		assert(replanInterval >= 1 && replanInterval <= window && "<CooperativeAStar::CooperativeAStar>: the replan interval has to lie between 1 and the window");
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	int CooperativeAStar<T_NodeType, T_ConnectionType>::AddAgent(int startIdx, int goalIdx, int priority)
+	{
+		m_Agents.push_back(Agent{ startIdx, goalIdx, priority, {}, IndexedOpenList(OpenList::binaryHeap, 0.f), {}, invalid_node_index });
+		ResetDistances(m_Agents.back());
+		m_IsPlanOutdated = true;
+
+		return static_cast<int>(m_Agents.size()) - 1;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CooperativeAStar<T_NodeType, T_ConnectionType>::SetGoal(int agent, int goalIdx)
+	{
+		m_Agents[agent].goalIdx = goalIdx;
+		ResetDistances(m_Agents[agent]);
+		m_IsPlanOutdated = true;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CooperativeAStar<T_NodeType, T_ConnectionType>::SetPriority(int agent, int priority)
+	{
+		m_Agents[agent].priority = priority;
+		m_IsPlanOutdated = true;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CooperativeAStar<T_NodeType, T_ConnectionType>::SetWindow(int window)
+	{
+		assert(window >= m_ReplanInterval && "<CooperativeAStar::SetWindow>: the window can't be shorter than the replan interval");
+		m_Window = window;
+		m_IsPlanOutdated = true;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CooperativeAStar<T_NodeType, T_ConnectionType>::SetReplanInterval(int replanInterval)
+	{
+		assert(replanInterval >= 1 && replanInterval <= m_Window && "<CooperativeAStar::SetReplanInterval>: the replan interval has to lie between 1 and the window");
+		m_ReplanInterval = replanInterval;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CooperativeAStar<T_NodeType, T_ConnectionType>::Step()
+	{
+		if (m_IsPlanOutdated || m_TimeStep - m_PlanTime >= static_cast<unsigned int>(m_ReplanInterval))
+			Replan();
+
+		++m_TimeStep;
+		for (Agent& agent : m_Agents)
+		{
+			size_t step = m_TimeStep - m_PlanTime;
+			agent.idx = agent.plan[step < agent.plan.size() ? step : agent.plan.size() - 1];
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<int> CooperativeAStar<T_NodeType, T_ConnectionType>::GetAgentPlan(int agent) const
+	{
+		const std::vector<int>& plan = m_Agents[agent].plan;
+		size_t step = m_TimeStep - m_PlanTime;
+		if (m_IsPlanOutdated || step >= plan.size())
+			return { m_Agents[agent].idx };
+
+		return std::vector<int>(plan.begin() + step, plan.end());
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CooperativeAStar<T_NodeType, T_ConnectionType>::Replan()
+	{
+		m_Reservations.Clear();
+		m_PlanTime = m_TimeStep;
+		m_IsPlanOutdated = false;
+		m_NrOfExpandedNodes = 0;
+
+		std::vector<int> order(m_Agents.size());
+		for (size_t i = 0; i < order.size(); ++i)
+			order[i] = static_cast<int>(i);
+		std::stable_sort(order.begin(), order.end(), [this](int agent, int otherAgent) { return m_Agents[agent].priority > m_Agents[otherAgent].priority; });
+
+		for (int agent : order)
+			PlanAgent(agent);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CooperativeAStar<T_NodeType, T_ConnectionType>::PlanAgent(int agentIdx)
+	{
+		Agent& agent = m_Agents[agentIdx];
+		m_Records.clear();
+		m_Visited.Clear();
+
+		IndexedOpenList openList(OpenList::binaryHeap, 0.f);
+		float startHeuristicCost = GetTrueDistance(agent, agent.idx);
+		if (startHeuristicCost < std::numeric_limits<float>::infinity())
+		{
+			m_Records.push_back(Record{ agent.idx, 0, -1, 0.f, false });
+			m_Visited.Reserve(agent.idx, 0, 0);
+			openList.Push(0, 0.f, startHeuristicCost);
+		}
+
+		//the first record that reaches the end of the window has the cheapest plan, with the distance after it included
+		int lastRecordIdx = -1;
+		while (!openList.IsEmpty())
+		{
+			IndexedOpenList::Entry current = openList.Pop();
+			if (m_Records[current.idx].isClosed || current.costSoFar > m_Records[current.idx].costSoFar)
+				continue;
+
+			m_Records[current.idx].isClosed = true;
+			++m_NrOfExpandedNodes;
+
+			//records move when new ones are added, keep copies
+			const int idx = m_Records[current.idx].idx;
+			const int step = m_Records[current.idx].step;
+			if (step == m_Window)
+			{
+				lastRecordIdx = current.idx;
+				break;
+			}
+
+			const unsigned int nextTime = m_PlanTime + step + 1;
+			auto addSuccessor = [&](int nextIdx, float cost)
+			{
+				if (m_Reservations.IsReserved(nextIdx, nextTime))
+					return;
+
+				//moving onto a node whose agent moves onto this one would swap them through each other
+				if (nextIdx != idx)
+				{
+					int otherAgent = m_Reservations.GetAgent(nextIdx, nextTime - 1);
+					if (otherAgent != -1 && m_Reservations.GetAgent(idx, nextTime) == otherAgent)
+						return;
+				}
+
+				float heuristicCost = GetTrueDistance(agent, nextIdx);
+				if (heuristicCost == std::numeric_limits<float>::infinity())
+					return;
+
+				float costSoFar = current.costSoFar + cost;
+				int recordIdx = m_Visited.GetAgent(nextIdx, step + 1);
+				if (recordIdx == -1)
+				{
+					recordIdx = static_cast<int>(m_Records.size());
+					m_Records.push_back(Record{ nextIdx, step + 1, -1, std::numeric_limits<float>::infinity(), false });
+					m_Visited.Reserve(nextIdx, step + 1, recordIdx);
+				}
+
+				Record& nextRecord = m_Records[recordIdx];
+				if (nextRecord.isClosed || costSoFar >= nextRecord.costSoFar)
+					return;
+
+				nextRecord.costSoFar = costSoFar;
+				nextRecord.parent = current.idx;
+				openList.Push(recordIdx, costSoFar, heuristicCost);
+			};
+
+			addSuccessor(idx, idx == agent.goalIdx ? 0.f : m_WaitCost);
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(idx))
+				addSuccessor(pConnection->GetTo(), pConnection->GetCost());
+		}
+
+		//boxed in (or the goal can't be reached at all): stay put and hope the others go around
+		agent.plan.assign(m_Window + 1, agent.idx);
+		for (int recordIdx = lastRecordIdx; recordIdx != -1; recordIdx = m_Records[recordIdx].parent)
+			agent.plan[m_Records[recordIdx].step] = m_Records[recordIdx].idx;
+
+		for (int step = 0; step <= m_Window; ++step)
+		{
+			if (!m_Reservations.Reserve(agent.plan[step], m_PlanTime + step, agentIdx))
+				++m_NrOfConflicts;
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void CooperativeAStar<T_NodeType, T_ConnectionType>::ResetDistances(Agent& agent)
+	{
+		agent.distanceOpenList = IndexedOpenList(OpenList::binaryHeap, 0.f);
+		agent.distances.clear();
+		agent.distanceTargetIdx = agent.idx;
+
+		agent.distances[agent.goalIdx] = DistanceRecord{ 0.f, false };
+		agent.distanceOpenList.Push(agent.goalIdx, 0.f, GetHeuristicCost(agent.goalIdx, agent.distanceTargetIdx));
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	float CooperativeAStar<T_NodeType, T_ConnectionType>::GetTrueDistance(Agent& agent, int idx)
+	{
+		auto foundIt = agent.distances.find(idx);
+		if (foundIt != agent.distances.end() && foundIt->second.isClosed)
+			return foundIt->second.costSoFar;
+
+		while (!agent.distanceOpenList.IsEmpty())
+		{
+			IndexedOpenList::Entry current = agent.distanceOpenList.Pop();
+			DistanceRecord& record = agent.distances[current.idx];
+			if (record.isClosed || current.costSoFar > record.costSoFar)
+				continue;
+
+			record.isClosed = true;
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(current.idx))
+			{
+				int nextIdx = pConnection->GetTo();
+				float costSoFar = current.costSoFar + pConnection->GetCost();
+				auto inserted = agent.distances.insert({ nextIdx, DistanceRecord{ std::numeric_limits<float>::infinity(), false } });
+				DistanceRecord& nextRecord = inserted.first->second;
+				if (nextRecord.isClosed || costSoFar >= nextRecord.costSoFar)
+					continue;
+
+				nextRecord.costSoFar = costSoFar;
+				agent.distanceOpenList.Push(nextIdx, costSoFar, GetHeuristicCost(nextIdx, agent.distanceTargetIdx));
+			}
+
+			if (current.idx == idx)
+				return current.costSoFar;
+		}
+
+		return std::numeric_limits<float>::infinity();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	float CooperativeAStar<T_NodeType, T_ConnectionType>::GetHeuristicCost(int fromIdx, int toIdx) const
+	{
+		Vector2 toDestination = m_pGraph->GetNodePos(toIdx) - m_pGraph->GetNodePos(fromIdx);
+		return m_HeuristicFunction(abs(toDestination.x), abs(toDestination.y));
+	}
+}
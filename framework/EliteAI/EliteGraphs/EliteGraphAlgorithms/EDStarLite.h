@@ -0,0 +1,306 @@
+#pragma once
+#include <limits>
+
+namespace Elite
+{
+	// Incremental planner (D* Lite, Koenig & Likhachev) over a GridGraph.
+	// The search runs backwards from the goal and is kept between calls. When nodes of the graph are edited (see GridGraph::GetEditedNodesSince)
+	// or the start moves because the agent walked along the path, only the affected part of the search is repaired.
+	// Changing the goal starts a new search.
+	template <class T_NodeType, class T_ConnectionType>
+	class DStarLite
+	{
+	public:
+		DStarLite(GridGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction);
+
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		void Reset();
+
+		// number of nodes expanded by the last call to FindPath, to compare against a full replan
+		int GetNrOfExpandedNodes() const { return m_NrOfExpandedNodes; }
+
+	private:
+		struct Key
+		{
+			float primary = 0.f;
+			float secondary = 0.f;
+
+			bool operator<(const Key& other) const
+			{
+				return primary < other.primary || (primary == other.primary && secondary < other.secondary);
+			};
+
+			bool operator==(const Key& other) const
+			{
+				return primary == other.primary && secondary == other.secondary;
+			};
+		};
+
+		struct OpenRecord
+		{
+			Key key;
+			int nodeIdx;
+
+			// std heap functions build a max heap, invert so the smallest key is on top
+			bool operator<(const OpenRecord& other) const
+			{
+				return other.key < key;
+			};
+		};
+
+		void Initialize(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		void ApplyEdits(const std::vector<int>& editedNodes);
+		void ComputeShortestPath();
+		std::vector<T_NodeType*> ExtractPath() const;
+
+		void UpdateNode(int idx);
+		Key CalculateKey(int idx) const;
+		Key GetTopKey();
+		void PushOpen(int idx);
+
+		float GetHeuristicCost(int fromIdx, int toIdx) const;
+
+		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		Heuristic m_HeuristicFunction;
+
+		// search state, kept between calls
+		std::vector<float> m_CostSoFar;	// g: cost from the node to the goal
+		std::vector<float> m_Lookahead;	// rhs: one step lookahead of g
+		std::vector<Key> m_OpenKeys;		// key the node was last pushed with
+		std::vector<bool> m_IsOpen;
+		std::vector<OpenRecord> m_OpenList; // binary heap, outdated records are skipped when popped
+
+		int m_StartIdx = invalid_node_index;
+		int m_GoalIdx = invalid_node_index;
+		float m_KeyModifier = 0.f;	// k_m: accumulated heuristic drift caused by moving the start
+		unsigned int m_EditStamp = 0;
+		int m_NrOfExpandedNodes = 0;
+
+		const float m_Infinity = std::numeric_limits<float>::infinity();
+	};
+
+	template <class T_NodeType, class T_ConnectionType>
+	DStarLite<T_NodeType, T_ConnectionType>::DStarLite(GridGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction)
+		: m_pGraph(pGraph)
+		, m_HeuristicFunction(hFunction)
+	{
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> DStarLite<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pGoalNode)
+	{
+		m_NrOfExpandedNodes = 0;
+
+		std::vector<int> editedNodes;
+		bool canRepair = m_GoalIdx == pGoalNode->GetIndex()
+			&& (int)m_CostSoFar.size() == m_pGraph->GetNrOfNodes()
+			&& m_pGraph->GetEditedNodesSince(m_EditStamp, editedNodes);
+
+		if (!canRepair)
+		{
+			Initialize(pStartNode, pGoalNode);
+		}
+		else
+		{
+			// the agent moved, all keys in the open list are now too large by at most h(oldStart, newStart)
+			if (pStartNode->GetIndex() != m_StartIdx)
+			{
+				m_KeyModifier += GetHeuristicCost(m_StartIdx, pStartNode->GetIndex());
+				m_StartIdx = pStartNode->GetIndex();
+			}
+
+			ApplyEdits(editedNodes);
+		}
+		m_EditStamp = m_pGraph->GetEditStamp();
+
+		ComputeShortestPath();
+		return ExtractPath();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void DStarLite<T_NodeType, T_ConnectionType>::Reset()
+	{
+		m_CostSoFar.clear();
+		m_Lookahead.clear();
+		m_OpenKeys.clear();
+		m_IsOpen.clear();
+		m_OpenList.clear();
+		m_StartIdx = invalid_node_index;
+		m_GoalIdx = invalid_node_index;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void DStarLite<T_NodeType, T_ConnectionType>::Initialize(T_NodeType* pStartNode, T_NodeType* pGoalNode)
+	{
+		int nrOfNodes = m_pGraph->GetNrOfNodes();
+		m_CostSoFar.assign(nrOfNodes, m_Infinity);
+		m_Lookahead.assign(nrOfNodes, m_Infinity);
+		m_OpenKeys.assign(nrOfNodes, Key{});
+		m_IsOpen.assign(nrOfNodes, false);
+		m_OpenList.clear();
+
+		m_StartIdx = pStartNode->GetIndex();
+		m_GoalIdx = pGoalNode->GetIndex();
+		m_KeyModifier = 0.f;
+
+		m_Lookahead[m_GoalIdx] = 0.f;
+		PushOpen(m_GoalIdx);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void DStarLite<T_NodeType, T_ConnectionType>::ApplyEdits(const std::vector<int>& editedNodes)
+	{
+		// An edit changes every connection touching the node, so the node and all the cells around it need a new lookahead.
+		// Use the grid layout instead of the connections, an isolated node has no connections left to its old neighbours.
+		for (int idx : editedNodes)
+		{
+			Vector2 colRow = m_pGraph->GetNodePos(idx);
+			for (int dRow = -1; dRow <= 1; ++dRow)
+			{
+				for (int dCol = -1; dCol <= 1; ++dCol)
+				{
+					int col = int(colRow.x) + dCol;
+					int row = int(colRow.y) + dRow;
+					if (m_pGraph->IsWithinBounds(col, row))
+						UpdateNode(m_pGraph->GetIndex(col, row));
+				}
+			}
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void DStarLite<T_NodeType, T_ConnectionType>::ComputeShortestPath()
+	{
+		while (GetTopKey() < CalculateKey(m_StartIdx) || m_Lookahead[m_StartIdx] > m_CostSoFar[m_StartIdx])
+		{
+			OpenRecord record = m_OpenList.front();
+			std::pop_heap(m_OpenList.begin(), m_OpenList.end());
+			m_OpenList.pop_back();
+			m_IsOpen[record.nodeIdx] = false;
+
+			int idx = record.nodeIdx;
+			++m_NrOfExpandedNodes;
+
+			Key newKey = CalculateKey(idx);
+			if (record.key < newKey)
+			{
+				// key was outdated because the start moved, put it back with the right one
+				PushOpen(idx);
+			}
+			else if (m_CostSoFar[idx] > m_Lookahead[idx])
+			{
+				// overconsistent: the node got cheaper, settle it and propagate to its predecessors
+				m_CostSoFar[idx] = m_Lookahead[idx];
+				for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(idx))
+					UpdateNode(pConnection->GetTo());
+			}
+			else
+			{
+				// underconsistent: the node got more expensive, invalidate it and everything that depended on it
+				m_CostSoFar[idx] = m_Infinity;
+				UpdateNode(idx);
+				for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(idx))
+					UpdateNode(pConnection->GetTo());
+			}
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> DStarLite<T_NodeType, T_ConnectionType>::ExtractPath() const
+	{
+		// the search can stop with the start still open, its lookahead is already exact at that point
+		std::vector<T_NodeType*> path;
+		if (m_Lookahead[m_StartIdx] == m_Infinity)
+			return path;
+
+		// walk downhill from the start, every step takes the connection with the lowest cost + g
+		int currentIdx = m_StartIdx;
+		path.push_back(m_pGraph->GetNode(currentIdx));
+
+		while (currentIdx != m_GoalIdx && (int)path.size() <= m_pGraph->GetNrOfNodes())
+		{
+			int bestIdx = invalid_node_index;
+			float bestCost = m_Infinity;
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(currentIdx))
+			{
+				float cost = pConnection->GetCost() + m_CostSoFar[pConnection->GetTo()];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestIdx = pConnection->GetTo();
+				}
+			}
+
+			if (bestIdx == invalid_node_index)
+				return {};
+
+			currentIdx = bestIdx;
+			path.push_back(m_pGraph->GetNode(currentIdx));
+		}
+
+		return path;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void DStarLite<T_NodeType, T_ConnectionType>::UpdateNode(int idx)
+	{
+		if (idx != m_GoalIdx)
+		{
+			// Grid graphs are always connected both ways, so the successors of a node are also its predecessors
+			float lookahead = m_Infinity;
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(idx))
+			{
+				float cost = pConnection->GetCost() + m_CostSoFar[pConnection->GetTo()];
+				if (cost < lookahead)
+					lookahead = cost;
+			}
+			m_Lookahead[idx] = lookahead;
+		}
+
+		m_IsOpen[idx] = false;
+		if (m_CostSoFar[idx] != m_Lookahead[idx])
+			PushOpen(idx);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	typename DStarLite<T_NodeType, T_ConnectionType>::Key DStarLite<T_NodeType, T_ConnectionType>::CalculateKey(int idx) const
+	{
+		float minCost = m_CostSoFar[idx] < m_Lookahead[idx] ? m_CostSoFar[idx] : m_Lookahead[idx];
+		return Key{ minCost + GetHeuristicCost(m_StartIdx, idx) + m_KeyModifier, minCost };
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	typename DStarLite<T_NodeType, T_ConnectionType>::Key DStarLite<T_NodeType, T_ConnectionType>::GetTopKey()
+	{
+		// drop records of nodes that were removed from the open list or pushed again with another key
+		while (!m_OpenList.empty())
+		{
+			const OpenRecord& top = m_OpenList.front();
+			if (m_IsOpen[top.nodeIdx] && m_OpenKeys[top.nodeIdx] == top.key)
+				return top.key;
+
+			std::pop_heap(m_OpenList.begin(), m_OpenList.end());
+			m_OpenList.pop_back();
+		}
+
+		return Key{ m_Infinity, m_Infinity };
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void DStarLite<T_NodeType, T_ConnectionType>::PushOpen(int idx)
+	{
+		Key key = CalculateKey(idx);
+		m_OpenKeys[idx] = key;
+		m_IsOpen[idx] = true;
+
+		m_OpenList.push_back(OpenRecord{ key, idx });
+		std::push_heap(m_OpenList.begin(), m_OpenList.end());
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	float DStarLite<T_NodeType, T_ConnectionType>::GetHeuristicCost(int fromIdx, int toIdx) const
+	{
+		Vector2 toDestination = m_pGraph->GetNodePos(toIdx) - m_pGraph->GetNodePos(fromIdx);
+		return m_HeuristicFunction(abs(toDestination.x), abs(toDestination.y));
+	}
+}
@@ -1,5 +1,4 @@
 #pragma once
-#include <stack>
 
 namespace Elite
 {
@@ -23,6 +22,8 @@ namespace Elite
 	private:
 		void VisitAllNodesDFS(int startIdx, vector<bool>& visited) const;
 		bool IsConnected() const;
+		// flattens the connections of every node, returns the number of edges
+		int BuildEdgeIndex(vector<int>& firstConnections, vector<int>& targets, vector<int>& edges) const;
 
 		IGraph<T_NodeType, T_ConnectionType>* m_pGraph;
 	};
@@ -43,7 +44,7 @@ namespace Elite
 		// Count nodes with odd degree 
 		int nrOfNodes = m_pGraph->GetNrOfActiveNodes();
 		int oddCount = 0;
-		for (int i = 0; i < nrOfNodes; i++)
+		for (int i = 0; i < m_pGraph->GetNrOfNodes(); i++)
 			if (m_pGraph->IsNodeValid(i) && (m_pGraph->GetNodeConnections(i).size() & 1))
 				oddCount++;
 
@@ -63,60 +64,55 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline vector<T_NodeType*> EulerianPath<T_NodeType, T_ConnectionType>::FindPath(Eulerianity& eulerianity) const
 	{
-		// Get a copy of the graph because this algorithm involves removing edges
-		//auto graphCopy = m_pGraph->Clone();
-		shared_ptr<IGraph<T_NodeType, T_ConnectionType>> graphCopy = m_pGraph->Clone();
-		int nrOfNodes = graphCopy->GetNrOfNodes();
-		//auto path = vector<T_NodeType*>();
+		// Hierholzer's algorithm. Instead of removing edges from a copy of the graph, edges are marked as used in a bitset.
+		// Every connection gets an edge index first, both directions of an undirected connection share the same one.
 		vector<T_NodeType*> path;
-		vector<T_NodeType*> stack;
-
-		int currentNode{}, nextNode{};
+		if (eulerianity == Eulerianity::notEulerian)
+			return path;
 
-		// algorithm...
+		vector<int> firstConnections; // connections of node i are at [firstConnections[i], firstConnections[i + 1])
+		vector<int> targets;
+		vector<int> edges;
+		int nrOfEdges = BuildEdgeIndex(firstConnections, targets, edges);
 
-		switch (eulerianity)
+		int nrOfNodes = m_pGraph->GetNrOfNodes();
+		int currentNode = 0;
+		if (eulerianity == Eulerianity::semiEulerian)
 		{
-		case Elite::Eulerianity::eulerian:
-			currentNode = 0;
-			break;
-		case Elite::Eulerianity::semiEulerian:
 			for (int i = 0; i < nrOfNodes; i++)
 			{
-				if ((graphCopy->GetNodeConnections(i).size() & 1))
+				if ((firstConnections[i + 1] - firstConnections[i]) & 1)
 				{
 					currentNode = i;
 					break;
 				}
 			}
-			break;
-		case Elite::Eulerianity::notEulerian:
-			return path;
 		}
 
+		vector<bool> isEdgeUsed(nrOfEdges, false);
+		vector<int> nextConnections(firstConnections.begin(), firstConnections.end() - 1);
+		vector<int> stack{ currentNode };
+		path.reserve(nrOfEdges + 1);
 
-		while (true)
+		while (!stack.empty())
 		{
-			if (graphCopy->GetNodeConnections(currentNode).size() == 0)
+			currentNode = stack.back();
+
+			// connections before the cursor are used, skip the ones that were used from the other side
+			int& connection = nextConnections[currentNode];
+			while (connection < firstConnections[currentNode + 1] && isEdgeUsed[edges[connection]])
+				++connection;
+
+			if (connection == firstConnections[currentNode + 1])
 			{
 				path.push_back(m_pGraph->GetNode(currentNode));
-
-				if (stack.size() != 0)
-				{
-					currentNode = stack.back()->GetIndex();
-					stack.pop_back();
-				}
-				else
-				{
-					break;
-				}
+				stack.pop_back();
 			}
 			else
 			{
-				stack.push_back(graphCopy->GetNode(currentNode));
-				nextNode = graphCopy->GetNodeConnections(currentNode).front()->GetTo();
-				graphCopy->RemoveConnection(currentNode, nextNode);
-				currentNode = nextNode;
+				isEdgeUsed[edges[connection]] = true;
+				stack.push_back(targets[connection]);
+				++connection;
 			}
 		}
 
@@ -124,22 +120,56 @@ namespace Elite
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
-	inline void EulerianPath<T_NodeType, T_ConnectionType>::VisitAllNodesDFS(int startIdx, vector<bool>& visited) const
+	inline int EulerianPath<T_NodeType, T_ConnectionType>::BuildEdgeIndex(vector<int>& firstConnections, vector<int>& targets, vector<int>& edges) const
 	{
-		// mark the visited node
-		visited[startIdx] = true;
+		int nrOfNodes = m_pGraph->GetNrOfNodes();
+
+		// flatten the adjacency lists, sorted per node so both sides of a connection can be matched without a lookup
+		firstConnections.assign(nrOfNodes + 1, 0);
+		for (int i = 0; i < nrOfNodes; i++)
+			firstConnections[i + 1] = firstConnections[i] + (int)m_pGraph->GetNodeConnections(i).size();
+
+		targets.resize(firstConnections[nrOfNodes]);
+		for (int i = 0; i < nrOfNodes; i++)
+		{
+			int connection = firstConnections[i];
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(i))
+				targets[connection++] = pConnection->GetTo();
+			std::sort(targets.begin() + firstConnections[i], targets.begin() + firstConnections[i + 1]);
+		}
+
+		edges.resize(targets.size());
+		int nrOfEdges = 0;
+		if (m_pGraph->IsDirectionalGraph())
+		{
+			for (int& edge : edges)
+				edge = nrOfEdges++;
+			return nrOfEdges;
+		}
+
+		// Nodes are visited in increasing order, so the connections back to smaller nodes in a sorted list get matched in order as well
+		vector<int> nextBackConnections(firstConnections.begin(), firstConnections.end() - 1);
+		for (int from = 0; from < nrOfNodes; from++)
+		{
+			for (int connection = firstConnections[from]; connection < firstConnections[from + 1]; connection++)
+			{
+				int to = targets[connection];
+				if (to > from)
+				{
+					edges[connection] = nrOfEdges;
+					edges[nextBackConnections[to]++] = nrOfEdges;
+					nrOfEdges++;
+				}
+			}
+		}
 
-		// recursively visit any valid connected nodes that were not visited before
-		for (T_ConnectionType* connection : m_pGraph->GetNodeConnections(startIdx))
-			if (m_pGraph->IsNodeValid(connection->GetTo()) && !visited[connection->GetTo()])
-				VisitAllNodesDFS(connection->GetTo(), visited);
+		return nrOfEdges;
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
 	inline bool EulerianPath<T_NodeType, T_ConnectionType>::IsConnected() const
 	{
 		int nrOfNodes = m_pGraph->GetNrOfNodes();
-		vector<bool> visited(nrOfNodes, false);
 
 		// find a valid starting node that has connections
 		int connectedIdx = invalid_node_index;
@@ -162,17 +192,54 @@ namespace Elite
 		if (connectedIdx == invalid_node_index)
 			return false;
 
-		// start a depth-first-search traversal from a node that has connections
-		VisitAllNodesDFS(connectedIdx, visited);
+		// the components the graph keeps ignore the direction of connections, a directional graph still needs a traversal
+		if (m_pGraph->IsDirectionalGraph())
+		{
+			vector<bool> visited(nrOfNodes, false);
+			VisitAllNodesDFS(connectedIdx, visited);
+
+			// if a node was never visited, this graph is not connected
+			for (int i = 0; i < nrOfNodes; i++)
+			{
+				if (m_pGraph->IsNodeValid(i) && visited[i] == false)
+					return false;
+			}
+
+			return true;
+		}
 
-		// if a node was never visited, this graph is not connected
+		// the graph keeps its connected components up to date, no traversal needed
+		int component = m_pGraph->GetComponent(connectedIdx);
 		for (int i = 0; i < nrOfNodes; i++)
 		{
-			if (m_pGraph->IsNodeValid(i) && visited[i] == false)
+			if (m_pGraph->IsNodeValid(i) && m_pGraph->GetComponent(i) != component)
 				return false;
 		}
 
 		return true;
 	}
 
+	template<class T_NodeType, class T_ConnectionType>
+	inline void EulerianPath<T_NodeType, T_ConnectionType>::VisitAllNodesDFS(int startIdx, vector<bool>& visited) const
+	{
+		// with an explicit stack, recursion runs out of stack on large graphs
+		vector<int> stack{ startIdx };
+		visited[startIdx] = true;
+		while (!stack.empty())
+		{
+			int idx = stack.back();
+			stack.pop_back();
+
+			// visit any valid connected nodes that were not visited before
+			for (T_ConnectionType* connection : m_pGraph->GetNodeConnections(idx))
+			{
+				if (m_pGraph->IsNodeValid(connection->GetTo()) && !visited[connection->GetTo()])
+				{
+					visited[connection->GetTo()] = true;
+					stack.push_back(connection->GetTo());
+				}
+			}
+		}
+	}
+
 }
\ No newline at end of file
@@ -0,0 +1,360 @@
+#pragma once
+#include <limits>
+#include <thread>
+#include <atomic>
+
+namespace Elite
+{
+	// Flow fields over a GridGraph, for many agents heading to the same goal.
+	// One Dijkstra pass from the goal integrates the terrain costs, every cell then stores the direction to its cheapest neighbour,
+	// so following the field is a lookup per agent per step. Fields are cached per goal (least recently used goes first) and
+	// repaired when nodes are edited (see GridGraph::GetEditedNodesSince) instead of being integrated again.
+	template <class T_NodeType, class T_ConnectionType>
+	class FlowField
+	{
+	public:
+		FlowField(GridGraph<T_NodeType, T_ConnectionType>* pGraph, unsigned int capacity = 4, int tileSize = 32);
+
+		// normalized direction to walk in from pNode, zero at the goal or when the goal can't be reached
+		Vector2 GetDirection(T_NodeType* pGoalNode, T_NodeType* pNode);
+		T_NodeType* GetNextNode(T_NodeType* pGoalNode, T_NodeType* pNode);
+		float GetIntegratedCost(T_NodeType* pGoalNode, T_NodeType* pNode);
+		const std::vector<Vector2>& GetDirections(T_NodeType* pGoalNode);
+		void Clear();
+
+		// fields with at least this many cells get their directions built by several threads, one tile at a time
+		void SetParallelThreshold(int nrOfNodes) { m_ParallelThreshold = nrOfNodes; }
+
+		// Statistics
+		unsigned int GetNrOfFields() const { return (unsigned int)m_Fields.size(); }
+		unsigned int GetHits() const { return m_NrOfHits; }
+		unsigned int GetMisses() const { return m_NrOfMisses; }
+		int GetNrOfRepairedNodes() const { return m_NrOfRepairedNodes; } // cells touched by the last repair
+		float GetBuildTime() const { return m_BuildTime; } // ms spent on the last build or repair
+
+	private:
+		struct Field
+		{
+			int goalIdx;
+			unsigned int editStamp;
+			std::vector<float> costs;		// integrated cost from the cell to the goal
+			std::vector<int> nextNodes;		// cheapest neighbour, invalid_node_index at the goal or when unreachable
+			std::vector<Vector2> directions;
+		};
+
+		using FieldList = std::list<Field>;
+		using QueueEntry = std::pair<float, int>;
+		using OpenList = std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>;
+
+		Field& GetField(int goalIdx);
+		void Build(Field& field);
+		void Repair(Field& field, const std::vector<int>& editedNodes);
+		void Integrate(Field& field, OpenList& openList, std::vector<int>* pChangedNodes);
+
+		void BuildDirections(Field& field);
+		void BuildDirections(Field& field, int tileIdx);
+		void BuildDirection(Field& field, int idx);
+
+		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		unsigned int m_Capacity;
+		int m_TileSize;
+		int m_ParallelThreshold = 128 * 128;
+
+		// most recently used field at the front
+		FieldList m_Fields;
+
+		unsigned int m_NrOfHits = 0;
+		unsigned int m_NrOfMisses = 0;
+		int m_NrOfRepairedNodes = 0;
+		float m_BuildTime = 0.f;
+
+		const float m_Infinity = std::numeric_limits<float>::infinity();
+	};
+
+	template <class T_NodeType, class T_ConnectionType>
+	FlowField<T_NodeType, T_ConnectionType>::FlowField(GridGraph<T_NodeType, T_ConnectionType>* pGraph, unsigned int capacity, int tileSize)
+		: m_pGraph(pGraph)
+		, m_Capacity(capacity)
+		, m_TileSize(tileSize)
+	{
+		assert(m_Capacity > 0 && "<FlowField>: capacity must be at least 1");
+		assert(m_TileSize > 0 && "<FlowField>: tiles need at least 1 cell");
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	Vector2 FlowField<T_NodeType, T_ConnectionType>::GetDirection(T_NodeType* pGoalNode, T_NodeType* pNode)
+	{
+		return GetField(pGoalNode->GetIndex()).directions[pNode->GetIndex()];
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	T_NodeType* FlowField<T_NodeType, T_ConnectionType>::GetNextNode(T_NodeType* pGoalNode, T_NodeType* pNode)
+	{
+		int nextIdx = GetField(pGoalNode->GetIndex()).nextNodes[pNode->GetIndex()];
+		if (nextIdx == invalid_node_index)
+			return nullptr;
+
+		return m_pGraph->GetNode(nextIdx);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	float FlowField<T_NodeType, T_ConnectionType>::GetIntegratedCost(T_NodeType* pGoalNode, T_NodeType* pNode)
+	{
+		return GetField(pGoalNode->GetIndex()).costs[pNode->GetIndex()];
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	const std::vector<Vector2>& FlowField<T_NodeType, T_ConnectionType>::GetDirections(T_NodeType* pGoalNode)
+	{
+		return GetField(pGoalNode->GetIndex()).directions;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void FlowField<T_NodeType, T_ConnectionType>::Clear()
+	{
+		m_Fields.clear();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	typename FlowField<T_NodeType, T_ConnectionType>::Field& FlowField<T_NodeType, T_ConnectionType>::GetField(int goalIdx)
+	{
+		// only a handful of goals are cached, a linear search beats hashing here
+		auto fieldIt = std::find_if(m_Fields.begin(), m_Fields.end(), [goalIdx](const Field& field) { return field.goalIdx == goalIdx; });
+
+		if (fieldIt == m_Fields.end())
+		{
+			++m_NrOfMisses;
+			if (m_Fields.size() >= m_Capacity)
+				m_Fields.pop_back();
+
+			m_Fields.push_front(Field{ goalIdx, 0 });
+			Build(m_Fields.front());
+			return m_Fields.front();
+		}
+
+		++m_NrOfHits;
+		m_Fields.splice(m_Fields.begin(), m_Fields, fieldIt);
+
+		// cheap check first, this runs for every agent every step
+		Field& field = m_Fields.front();
+		if (field.editStamp != m_pGraph->GetEditStamp())
+		{
+			//every route ends in the goal, an edited goal invalidates the whole field
+			std::vector<int> editedNodes;
+			if (m_pGraph->GetEditedNodesSince(field.editStamp, editedNodes)
+				&& std::find(editedNodes.begin(), editedNodes.end(), field.goalIdx) == editedNodes.end())
+				Repair(field, editedNodes);
+			else
+				Build(field);
+		}
+
+		return field;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void FlowField<T_NodeType, T_ConnectionType>::Build(Field& field)
+	{
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		int nrOfNodes = m_pGraph->GetNrOfNodes();
+		field.costs.assign(nrOfNodes, m_Infinity);
+		field.nextNodes.assign(nrOfNodes, invalid_node_index);
+		field.directions.assign(nrOfNodes, ZeroVector2);
+		field.editStamp = m_pGraph->GetEditStamp();
+
+		OpenList openList;
+		field.costs[field.goalIdx] = 0.f;
+		openList.push({ 0.f, field.goalIdx });
+		Integrate(field, openList, nullptr);
+
+		BuildDirections(field);
+
+		m_NrOfRepairedNodes = nrOfNodes;
+		m_BuildTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void FlowField<T_NodeType, T_ConnectionType>::Repair(Field& field, const std::vector<int>& editedNodes)
+	{
+		auto startTime = std::chrono::high_resolution_clock::now();
+		field.editStamp = m_pGraph->GetEditStamp();
+
+		// Every cell whose route to the goal runs through an edited cell lost its cost, walk the field backwards from the edited cells to find them.
+		// Use the grid layout instead of the connections, an isolated node has no connections left to its old neighbours.
+		std::vector<int> affectedNodes;
+		std::vector<bool> isAffected(field.costs.size(), false);
+		for (int idx : editedNodes)
+		{
+			if (!isAffected[idx])
+			{
+				isAffected[idx] = true;
+				affectedNodes.push_back(idx);
+			}
+		}
+
+		for (size_t i = 0; i < affectedNodes.size(); ++i)
+		{
+			Vector2 colRow = m_pGraph->GetNodePos(affectedNodes[i]);
+			for (int dRow = -1; dRow <= 1; ++dRow)
+			{
+				for (int dCol = -1; dCol <= 1; ++dCol)
+				{
+					int col = int(colRow.x) + dCol;
+					int row = int(colRow.y) + dRow;
+					if (!m_pGraph->IsWithinBounds(col, row))
+						continue;
+
+					int neighbourIdx = m_pGraph->GetIndex(col, row);
+					if (!isAffected[neighbourIdx] && field.nextNodes[neighbourIdx] == affectedNodes[i])
+					{
+						isAffected[neighbourIdx] = true;
+						affectedNodes.push_back(neighbourIdx);
+					}
+				}
+			}
+		}
+
+		for (int idx : affectedNodes)
+		{
+			field.costs[idx] = m_Infinity;
+			field.nextNodes[idx] = invalid_node_index;
+		}
+
+		// Seed every affected cell with the best cost it can get from the untouched part of the field.
+		// Integrate relaxes into untouched cells as well, so cells that got cheaper through an edit are picked up too.
+		OpenList openList;
+		for (int idx : affectedNodes)
+		{
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(idx))
+			{
+				float cost = field.costs[pConnection->GetTo()] + pConnection->GetCost();
+				if (cost < field.costs[idx])
+					field.costs[idx] = cost;
+			}
+
+			if (field.costs[idx] != m_Infinity)
+				openList.push({ field.costs[idx], idx });
+		}
+
+		std::vector<int> changedNodes = affectedNodes;
+		Integrate(field, openList, &changedNodes);
+
+		// a cell's direction only depends on its neighbours' costs
+		for (int idx : changedNodes)
+		{
+			Vector2 colRow = m_pGraph->GetNodePos(idx);
+			for (int dRow = -1; dRow <= 1; ++dRow)
+			{
+				for (int dCol = -1; dCol <= 1; ++dCol)
+				{
+					int col = int(colRow.x) + dCol;
+					int row = int(colRow.y) + dRow;
+					if (m_pGraph->IsWithinBounds(col, row))
+						BuildDirection(field, m_pGraph->GetIndex(col, row));
+				}
+			}
+		}
+
+		m_NrOfRepairedNodes = (int)changedNodes.size();
+		m_BuildTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void FlowField<T_NodeType, T_ConnectionType>::Integrate(Field& field, OpenList& openList, std::vector<int>* pChangedNodes)
+	{
+		// Grid graphs are always connected both ways with the same cost, so searching outwards from the goal gives the cost towards it
+		while (!openList.empty())
+		{
+			QueueEntry current = openList.top();
+			openList.pop();
+			if (current.first > field.costs[current.second])
+				continue;
+
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(current.second))
+			{
+				int toIdx = pConnection->GetTo();
+				float cost = current.first + pConnection->GetCost();
+				if (cost < field.costs[toIdx])
+				{
+					field.costs[toIdx] = cost;
+					openList.push({ cost, toIdx });
+					if (pChangedNodes)
+						pChangedNodes->push_back(toIdx);
+				}
+			}
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void FlowField<T_NodeType, T_ConnectionType>::BuildDirections(Field& field)
+	{
+		int nrOfTileColumns = (m_pGraph->GetColumns() + m_TileSize - 1) / m_TileSize;
+		int nrOfTileRows = (m_pGraph->GetRows() + m_TileSize - 1) / m_TileSize;
+		int nrOfTiles = nrOfTileColumns * nrOfTileRows;
+
+		int nrOfThreads = (int)std::thread::hardware_concurrency();
+		if (m_pGraph->GetNrOfNodes() < m_ParallelThreshold || nrOfThreads < 2 || nrOfTiles < 2)
+		{
+			for (int tileIdx = 0; tileIdx < nrOfTiles; ++tileIdx)
+				BuildDirections(field, tileIdx);
+			return;
+		}
+
+		// Every tile only writes its own cells and reads the finished costs, so tiles need no synchronisation.
+		// Workers pull the next tile from a shared counter, unreachable tiles finish faster than the others.
+		std::atomic<int> nextTile{ 0 };
+		auto worker = [this, &field, &nextTile, nrOfTiles]()
+		{
+			for (int tileIdx = nextTile++; tileIdx < nrOfTiles; tileIdx = nextTile++)
+				BuildDirections(field, tileIdx);
+		};
+
+		if (nrOfThreads > nrOfTiles)
+			nrOfThreads = nrOfTiles;
+
+		std::vector<std::thread> threads;
+		for (int i = 1; i < nrOfThreads; ++i)
+			threads.emplace_back(worker);
+		worker();
+
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void FlowField<T_NodeType, T_ConnectionType>::BuildDirections(Field& field, int tileIdx)
+	{
+		int nrOfTileColumns = (m_pGraph->GetColumns() + m_TileSize - 1) / m_TileSize;
+		int firstColumn = (tileIdx % nrOfTileColumns) * m_TileSize;
+		int firstRow = (tileIdx / nrOfTileColumns) * m_TileSize;
+
+		for (int row = firstRow; row < firstRow + m_TileSize && row < m_pGraph->GetRows(); ++row)
+		{
+			for (int col = firstColumn; col < firstColumn + m_TileSize && col < m_pGraph->GetColumns(); ++col)
+				BuildDirection(field, m_pGraph->GetIndex(col, row));
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void FlowField<T_NodeType, T_ConnectionType>::BuildDirection(Field& field, int idx)
+	{
+		field.nextNodes[idx] = invalid_node_index;
+		field.directions[idx] = ZeroVector2;
+		if (idx == field.goalIdx || field.costs[idx] == m_Infinity)
+			return;
+
+		float bestCost = m_Infinity;
+		for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(idx))
+		{
+			float cost = pConnection->GetCost() + field.costs[pConnection->GetTo()];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				field.nextNodes[idx] = pConnection->GetTo();
+			}
+		}
+
+		if (field.nextNodes[idx] != invalid_node_index)
+			field.directions[idx] = (m_pGraph->GetNodePos(field.nextNodes[idx]) - m_pGraph->GetNodePos(idx)).GetNormalized();
+	}
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <unordered_map>
+
+namespace Elite
+{
+	// Line of sight between cell centers of a GridGraph. A line is blocked by every cell it touches that has no connections
+	// (isolated cells, water), lines through a corner need both cells next to that corner to be free.
+	// Terrain costs are ignored, like in JPS. Results are cached per segment until a cell in the segment's bounding box is edited.
+	template <class T_NodeType, class T_ConnectionType>
+	class GridLineOfSight
+	{
+	public:
+		GridLineOfSight(GridGraph<T_NodeType, T_ConnectionType>* pGraph, size_t maxCacheSize = 1 << 16);
+
+		bool HasLineOfSight(int fromIdx, int toIdx);
+
+		// String pulling: keeps a waypoint only when the previous kept one can't see the waypoint after it.
+		// Works on any path of cells that are free and in order, cell by cell (A*) or jump points (JPS).
+		std::vector<T_NodeType*> SmoothPath(const std::vector<T_NodeType*>& path);
+
+		unsigned int GetHits() const { return m_Hits; }
+		unsigned int GetMisses() const { return m_Misses; }
+
+	private:
+		struct Segment
+		{
+			int fromIdx;
+			int toIdx;
+			bool hasLineOfSight;
+		};
+
+		void Update();
+		bool IsBlocked(int col, int row) const { return m_IsBlocked[row * m_NrOfColumns + col] != 0; }
+		bool TraceLine(int fromIdx, int toIdx) const;
+		bool IsInBoundingBox(const Segment& segment, int idx) const;
+
+		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		int m_NrOfColumns = 0;
+		std::vector<char> m_IsBlocked;
+		unsigned int m_EditStamp = 0;
+
+		// keyed on the pair of indices, smallest first: a line looks the same from both ends
+		std::unordered_map<unsigned long long, Segment> m_Cache;
+		size_t m_MaxCacheSize;
+		unsigned int m_Hits = 0;
+		unsigned int m_Misses = 0;
+
+		// more edits than this at once drop the whole cache instead of checking every segment
+		static const size_t m_MaxEditsToRepair = 64;
+	};
+
+	template <class T_NodeType, class T_ConnectionType>
+	GridLineOfSight<T_NodeType, T_ConnectionType>::GridLineOfSight(GridGraph<T_NodeType, T_ConnectionType>* pGraph, size_t maxCacheSize)
+		: m_pGraph(pGraph)
+		, m_NrOfColumns(pGraph->GetColumns())
+		, m_EditStamp(pGraph->GetEditStamp())
+		, m_MaxCacheSize(maxCacheSize)
+	{
+		m_IsBlocked.resize(m_pGraph->GetNrOfNodes());
+		for (int idx = 0; idx < m_pGraph->GetNrOfNodes(); ++idx)
+			m_IsBlocked[idx] = m_pGraph->GetNodeConnections(idx).empty();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	bool GridLineOfSight<T_NodeType, T_ConnectionType>::HasLineOfSight(int fromIdx, int toIdx)
+	{
+		Update();
+
+		unsigned long long key = fromIdx < toIdx
+			? (unsigned long long)(unsigned int)fromIdx << 32 | (unsigned int)toIdx
+			: (unsigned long long)(unsigned int)toIdx << 32 | (unsigned int)fromIdx;
+
+		auto foundIt = m_Cache.find(key);
+		if (foundIt != m_Cache.end())
+		{
+			++m_Hits;
+			return foundIt->second.hasLineOfSight;
+		}
+
+		++m_Misses;
+		if (m_Cache.size() >= m_MaxCacheSize)
+			m_Cache.clear();
+
+		bool hasLineOfSight = TraceLine(fromIdx, toIdx);
+		m_Cache.insert({ key, Segment{ fromIdx, toIdx, hasLineOfSight } });
+
+		return hasLineOfSight;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> GridLineOfSight<T_NodeType, T_ConnectionType>::SmoothPath(const std::vector<T_NodeType*>& path)
+	{
+		if (path.size() <= 2)
+			return path;
+
+		std::vector<T_NodeType*> smoothPath{ path.front() };
+		for (size_t i = 2; i < path.size(); ++i)
+		{
+			if (!HasLineOfSight(smoothPath.back()->GetIndex(), path[i]->GetIndex()))
+				smoothPath.push_back(path[i - 1]);
+		}
+		smoothPath.push_back(path.back());
+
+		return smoothPath;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void GridLineOfSight<T_NodeType, T_ConnectionType>::Update()
+	{
+		if (m_EditStamp == m_pGraph->GetEditStamp())
+			return;
+
+		std::vector<int> editedNodes;
+		bool isLogComplete = m_pGraph->GetEditedNodesSince(m_EditStamp, editedNodes);
+		m_EditStamp = m_pGraph->GetEditStamp();
+
+		if (!isLogComplete)
+		{
+			for (int idx = 0; idx < m_pGraph->GetNrOfNodes(); ++idx)
+				m_IsBlocked[idx] = m_pGraph->GetNodeConnections(idx).empty();
+			m_Cache.clear();
+			return;
+		}
+
+		//an edit can also (un)isolate the neighbours of the edited cell
+		std::vector<int> changedNodes;
+		for (int idx : editedNodes)
+		{
+			Vector2 colRow = m_pGraph->GetNodePos(idx);
+			for (int row = int(colRow.y) - 1; row <= int(colRow.y) + 1; ++row)
+			{
+				for (int col = int(colRow.x) - 1; col <= int(colRow.x) + 1; ++col)
+				{
+					if (!m_pGraph->IsWithinBounds(col, row))
+						continue;
+
+					int neighbourIdx = m_pGraph->GetIndex(col, row);
+					char isBlocked = m_pGraph->GetNodeConnections(neighbourIdx).empty();
+					if (isBlocked != m_IsBlocked[neighbourIdx])
+					{
+						m_IsBlocked[neighbourIdx] = isBlocked;
+						changedNodes.push_back(neighbourIdx);
+					}
+				}
+			}
+		}
+
+		if (changedNodes.size() > m_MaxEditsToRepair)
+		{
+			m_Cache.clear();
+			return;
+		}
+
+		for (auto it = m_Cache.begin(); it != m_Cache.end();)
+		{
+			bool isStale = std::any_of(changedNodes.begin(), changedNodes.end(),
+				[this, &it](int idx) { return IsInBoundingBox(it->second, idx); });
+
+			if (isStale)
+				it = m_Cache.erase(it);
+			else
+				++it;
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	bool GridLineOfSight<T_NodeType, T_ConnectionType>::TraceLine(int fromIdx, int toIdx) const
+	{
+		//supercover line: visits every cell the segment between both centers touches
+		int col = fromIdx % m_NrOfColumns;
+		int row = fromIdx / m_NrOfColumns;
+		int toCol = toIdx % m_NrOfColumns;
+		int toRow = toIdx / m_NrOfColumns;
+
+		int deltaCol = abs(toCol - col);
+		int deltaRow = abs(toRow - row);
+		int stepCol = toCol > col ? 1 : -1;
+		int stepRow = toRow > row ? 1 : -1;
+		int error = deltaCol - deltaRow;
+		deltaCol *= 2;
+		deltaRow *= 2;
+
+		while (true)
+		{
+			if (IsBlocked(col, row))
+				return false;
+			if (col == toCol && row == toRow)
+				return true;
+
+			if (error > 0)
+			{
+				col += stepCol;
+				error -= deltaRow;
+			}
+			else if (error < 0)
+			{
+				row += stepRow;
+				error += deltaCol;
+			}
+			else
+			{
+				//exactly through a corner
+				if (IsBlocked(col + stepCol, row) || IsBlocked(col, row + stepRow))
+					return false;
+
+				col += stepCol;
+				row += stepRow;
+				error += deltaCol - deltaRow;
+			}
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	bool GridLineOfSight<T_NodeType, T_ConnectionType>::IsInBoundingBox(const Segment& segment, int idx) const
+	{
+		int col = idx % m_NrOfColumns;
+		int row = idx / m_NrOfColumns;
+		int fromCol = segment.fromIdx % m_NrOfColumns;
+		int fromRow = segment.fromIdx / m_NrOfColumns;
+		int toCol = segment.toIdx % m_NrOfColumns;
+		int toRow = segment.toIdx / m_NrOfColumns;
+
+		return (col - fromCol) * (col - toCol) <= 0 && (row - fromRow) * (row - toRow) <= 0;
+	}
+}
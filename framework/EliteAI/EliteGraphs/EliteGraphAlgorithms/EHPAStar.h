@@ -0,0 +1,562 @@
+#pragma once
+#include <limits>
+#include "framework\EliteAI\EliteGraphs\EGraph2D.h"
+#include "EAStar.h"
+
+namespace Elite
+{
+	// Hierarchical pathfinding (HPA*, Botea et al.) over a GridGraph.
+	// The grid is split in square clusters. Cells on both sides of an open stretch of cluster border become transition nodes in an abstract graph,
+	// connected across the border and, within a cluster, by their cluster-bounded shortest distance. Clusters that only touch at a corner
+	// get a transition there when the grid connects the corner cells diagonally, that can be the only way from one to the other.
+	// Queries search the abstract graph and then refine each abstract step on the grid with A*.
+	// Edited nodes (see GridGraph::GetEditedNodesSince) only rebuild the clusters they lie in and the borders around them.
+	template <class T_NodeType, class T_ConnectionType>
+	class HPAStar
+	{
+	public:
+		using AbstractGraph = Graph2D<GraphNode2D, GraphConnection2D>;
+
+		HPAStar(GridGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction, int clusterSize = 16);
+		~HPAStar();
+
+		void Build();
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+
+		const AbstractGraph* GetAbstractGraph() const { return m_pAbstractGraph; }
+		int GetClusterSize() const { return m_ClusterSize; }
+		int GetClusterIndex(int gridIdx) const;
+
+		// Statistics
+		float GetBuildTime() const { return m_BuildTime; } // ms spent in the last (partial) rebuild
+		int GetNrOfRebuiltClusters() const { return m_NrOfRebuiltClusters; }
+		size_t GetMemoryUsage() const; // approximate, in bytes
+
+	private:
+		// a cluster owns the border to its right and bottom neighbour and the corners it shares with its bottom right and bottom left neighbour
+		enum BorderSide
+		{
+			right = 0,
+			bottom = 1,
+			bottomRight = 2,
+			bottomLeft = 3
+		};
+		static const int m_NrOfBorderSides = 4;
+
+		struct Cluster
+		{
+			int column = 0, row = 0; // first cell
+			int width = 0, height = 0;
+			std::vector<int> abstractNodes;
+		};
+
+		void UpdateClusters();
+		void RebuildBorder(int clusterIdx, BorderSide side);
+		void RemoveBorder(int borderIdx);
+		void AddTransition(int borderIdx, int insideCell, int outsideCell);
+		void ConnectCluster(int clusterIdx);
+		void DisconnectCluster(int clusterIdx);
+
+		int AddAbstractNode(int gridIdx);
+		void RemoveAbstractNode(int abstractIdx);
+		void ConnectToCluster(int abstractIdx);
+
+		// Dijkstra from gridIdx that never leaves its cluster, fills m_ClusterCosts
+		void SearchCluster(int clusterIdx, int gridIdx);
+		int GetBorderIndex(int clusterIdx, BorderSide side) const { return clusterIdx * m_NrOfBorderSides + side; }
+
+		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		AbstractGraph* m_pAbstractGraph = nullptr;
+		Heuristic m_HeuristicFunction;
+
+		int m_ClusterSize;
+		int m_NrOfClusterColumns = 0;
+		int m_NrOfClusterRows = 0;
+		std::vector<Cluster> m_Clusters;
+		std::vector<std::vector<int>> m_BorderNodes; // abstract nodes created for every border side (see BorderSide) of every cluster
+		std::vector<int> m_AbstractToGrid;
+		std::vector<int> m_FreeAbstractIndices;
+
+		std::vector<float> m_ClusterCosts; // scratch buffer for SearchCluster, local cell index within the cluster
+
+		unsigned int m_EditStamp = 0;
+		float m_BuildTime = 0.f;
+		int m_NrOfRebuiltClusters = 0;
+
+		// entrances at least this long get a transition at both ends instead of a single one in the middle
+		const int m_MinDoubleEntranceLength = 6;
+		const float m_Infinity = std::numeric_limits<float>::infinity();
+	};
+
+	template <class T_NodeType, class T_ConnectionType>
+	HPAStar<T_NodeType, T_ConnectionType>::HPAStar(GridGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction, int clusterSize)
+		: m_pGraph(pGraph)
+		, m_HeuristicFunction(hFunction)
+		, m_ClusterSize(clusterSize)
+	{
+		assert(m_ClusterSize > 1 && "<HPAStar>: clusters need at least 2x2 cells");
+		Build();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	HPAStar<T_NodeType, T_ConnectionType>::~HPAStar()
+	{
+		SAFE_DELETE(m_pAbstractGraph);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void HPAStar<T_NodeType, T_ConnectionType>::Build()
+	{
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		SAFE_DELETE(m_pAbstractGraph);
+		m_pAbstractGraph = new AbstractGraph(false);
+		m_AbstractToGrid.clear();
+		m_FreeAbstractIndices.clear();
+
+		m_NrOfClusterColumns = (m_pGraph->GetColumns() + m_ClusterSize - 1) / m_ClusterSize;
+		m_NrOfClusterRows = (m_pGraph->GetRows() + m_ClusterSize - 1) / m_ClusterSize;
+		m_Clusters.assign(m_NrOfClusterColumns * m_NrOfClusterRows, Cluster{});
+		m_BorderNodes.assign(m_Clusters.size() * m_NrOfBorderSides, std::vector<int>{});
+		m_ClusterCosts.resize(m_ClusterSize * m_ClusterSize);
+
+		for (int r = 0; r < m_NrOfClusterRows; ++r)
+		{
+			for (int c = 0; c < m_NrOfClusterColumns; ++c)
+			{
+				Cluster& cluster = m_Clusters[r * m_NrOfClusterColumns + c];
+				cluster.column = c * m_ClusterSize;
+				cluster.row = r * m_ClusterSize;
+				int columnsLeft = m_pGraph->GetColumns() - cluster.column;
+				int rowsLeft = m_pGraph->GetRows() - cluster.row;
+				cluster.width = columnsLeft < m_ClusterSize ? columnsLeft : m_ClusterSize;
+				cluster.height = rowsLeft < m_ClusterSize ? rowsLeft : m_ClusterSize;
+			}
+		}
+
+		for (int clusterIdx = 0; clusterIdx < (int)m_Clusters.size(); ++clusterIdx)
+		{
+			RebuildBorder(clusterIdx, right);
+			RebuildBorder(clusterIdx, bottom);
+			RebuildBorder(clusterIdx, bottomRight);
+			RebuildBorder(clusterIdx, bottomLeft);
+		}
+
+		for (int clusterIdx = 0; clusterIdx < (int)m_Clusters.size(); ++clusterIdx)
+			ConnectCluster(clusterIdx);
+
+		m_EditStamp = m_pGraph->GetEditStamp();
+		m_NrOfRebuiltClusters = (int)m_Clusters.size();
+		m_BuildTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> HPAStar<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pGoalNode)
+	{
+		UpdateClusters();
+
+		auto gridPathfinder = AStar<T_NodeType, T_ConnectionType>(m_pGraph, m_HeuristicFunction);
+		gridPathfinder.SetOpenList(OpenList::binaryHeap);
+
+		// nothing to abstract within a single cluster
+		if (GetClusterIndex(pStartNode->GetIndex()) == GetClusterIndex(pGoalNode->GetIndex()))
+			return gridPathfinder.FindPath(pStartNode, pGoalNode);
+
+		// temporarily hook the start and goal into the abstract graph
+		int abstractStart = AddAbstractNode(pStartNode->GetIndex());
+		int abstractGoal = AddAbstractNode(pGoalNode->GetIndex());
+		ConnectToCluster(abstractStart);
+		ConnectToCluster(abstractGoal);
+
+		auto abstractPathfinder = AStar<GraphNode2D, GraphConnection2D>(m_pAbstractGraph, m_HeuristicFunction);
+		abstractPathfinder.SetOpenList(OpenList::binaryHeap);
+		std::vector<GraphNode2D*> abstractPath = abstractPathfinder.FindPath(m_pAbstractGraph->GetNode(abstractStart), m_pAbstractGraph->GetNode(abstractGoal));
+
+		std::vector<int> waypoints;
+		if (!abstractPath.empty() && abstractPath.back()->GetIndex() == abstractGoal)
+		{
+			for (GraphNode2D* pAbstractNode : abstractPath)
+				waypoints.push_back(m_AbstractToGrid[pAbstractNode->GetIndex()]);
+		}
+
+		RemoveAbstractNode(abstractGoal);
+		RemoveAbstractNode(abstractStart);
+
+		// refine every abstract step, these searches never reach far beyond a single cluster
+		std::vector<T_NodeType*> path;
+		if (waypoints.empty())
+			return path;
+
+		path.push_back(pStartNode);
+		for (size_t i = 1; i < waypoints.size(); ++i)
+		{
+			int fromIdx = waypoints[i - 1];
+			int toIdx = waypoints[i];
+			if (fromIdx == toIdx)
+				continue;
+
+			if (m_pGraph->GetConnection(fromIdx, toIdx))
+			{
+				path.push_back(m_pGraph->GetNode(toIdx));
+				continue;
+			}
+
+			// An abstract step always has a path within its cluster, unless the abstract graph is out of step with the grid.
+			// Don't stitch a broken path together (AStar can also redirect to the nearest reachable node), search the whole grid instead.
+			std::vector<T_NodeType*> segment = gridPathfinder.FindPath(m_pGraph->GetNode(fromIdx), m_pGraph->GetNode(toIdx));
+			if (segment.empty() || segment.back()->GetIndex() != toIdx)
+				return gridPathfinder.FindPath(pStartNode, pGoalNode);
+
+			path.insert(path.end(), segment.begin() + 1, segment.end());
+		}
+
+		return path;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	int HPAStar<T_NodeType, T_ConnectionType>::GetClusterIndex(int gridIdx) const
+	{
+		Vector2 colRow = m_pGraph->GetNodePos(gridIdx);
+		return (int(colRow.y) / m_ClusterSize) * m_NrOfClusterColumns + int(colRow.x) / m_ClusterSize;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	size_t HPAStar<T_NodeType, T_ConnectionType>::GetMemoryUsage() const
+	{
+		size_t bytes = sizeof(*this);
+
+		// abstract graph: nodes, adjacency lists and their list nodes (connection + 2 links)
+		bytes += m_pAbstractGraph->GetNrOfNodes() * sizeof(GraphNode2D*);
+		bytes += m_pAbstractGraph->GetNrOfNodes() * (sizeof(GraphNode2D) + sizeof(typename AbstractGraph::ConnectionList));
+		bytes += m_pAbstractGraph->GetNrOfConnections() * (sizeof(GraphConnection2D) + 3 * sizeof(void*));
+
+		for (const Cluster& cluster : m_Clusters)
+			bytes += sizeof(Cluster) + cluster.abstractNodes.capacity() * sizeof(int);
+		for (const std::vector<int>& borderNodes : m_BorderNodes)
+			bytes += sizeof(borderNodes) + borderNodes.capacity() * sizeof(int);
+
+		bytes += (m_AbstractToGrid.capacity() + m_FreeAbstractIndices.capacity()) * sizeof(int);
+		bytes += m_ClusterCosts.capacity() * sizeof(float);
+
+		return bytes;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void HPAStar<T_NodeType, T_ConnectionType>::UpdateClusters()
+	{
+		std::vector<int> editedNodes;
+		if (!m_pGraph->GetEditedNodesSince(m_EditStamp, editedNodes))
+		{
+			Build();
+			return;
+		}
+		if (editedNodes.empty())
+			return;
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		std::vector<bool> isDirty(m_Clusters.size(), false);
+		for (int gridIdx : editedNodes)
+			isDirty[GetClusterIndex(gridIdx)] = true;
+
+		// Every border and corner of a dirty cluster gets new transitions, so the neighbours on the other side (diagonal ones too)
+		// need new intra-cluster connections as well
+		std::vector<bool> needsConnecting(m_Clusters.size(), false);
+		for (int clusterIdx = 0; clusterIdx < (int)m_Clusters.size(); ++clusterIdx)
+		{
+			if (!isDirty[clusterIdx])
+				continue;
+
+			int c = clusterIdx % m_NrOfClusterColumns;
+			int r = clusterIdx / m_NrOfClusterColumns;
+			for (int neighbourRow = r - 1; neighbourRow <= r + 1; ++neighbourRow)
+			{
+				for (int neighbourCol = c - 1; neighbourCol <= c + 1; ++neighbourCol)
+				{
+					if (neighbourCol >= 0 && neighbourCol < m_NrOfClusterColumns && neighbourRow >= 0 && neighbourRow < m_NrOfClusterRows)
+						needsConnecting[neighbourRow * m_NrOfClusterColumns + neighbourCol] = true;
+				}
+			}
+		}
+
+		m_NrOfRebuiltClusters = 0;
+		for (int clusterIdx = 0; clusterIdx < (int)m_Clusters.size(); ++clusterIdx)
+		{
+			if (needsConnecting[clusterIdx])
+			{
+				DisconnectCluster(clusterIdx);
+				++m_NrOfRebuiltClusters;
+			}
+		}
+
+		// a cluster owns its right and bottom border and bottom corners, the left and top ones belong to its neighbours
+		for (int clusterIdx = 0; clusterIdx < (int)m_Clusters.size(); ++clusterIdx)
+		{
+			if (!isDirty[clusterIdx])
+				continue;
+
+			RebuildBorder(clusterIdx, right);
+			RebuildBorder(clusterIdx, bottom);
+			RebuildBorder(clusterIdx, bottomRight);
+			RebuildBorder(clusterIdx, bottomLeft);
+
+			int c = clusterIdx % m_NrOfClusterColumns;
+			int r = clusterIdx / m_NrOfClusterColumns;
+			if (c > 0 && !isDirty[clusterIdx - 1])
+				RebuildBorder(clusterIdx - 1, right);
+			if (r > 0 && !isDirty[clusterIdx - m_NrOfClusterColumns])
+				RebuildBorder(clusterIdx - m_NrOfClusterColumns, bottom);
+			if (c > 0 && r > 0 && !isDirty[clusterIdx - m_NrOfClusterColumns - 1])
+				RebuildBorder(clusterIdx - m_NrOfClusterColumns - 1, bottomRight);
+			if (c + 1 < m_NrOfClusterColumns && r > 0 && !isDirty[clusterIdx - m_NrOfClusterColumns + 1])
+				RebuildBorder(clusterIdx - m_NrOfClusterColumns + 1, bottomLeft);
+		}
+
+		for (int clusterIdx = 0; clusterIdx < (int)m_Clusters.size(); ++clusterIdx)
+		{
+			if (needsConnecting[clusterIdx])
+				ConnectCluster(clusterIdx);
+		}
+
+		m_EditStamp = m_pGraph->GetEditStamp();
+		m_BuildTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void HPAStar<T_NodeType, T_ConnectionType>::RebuildBorder(int clusterIdx, BorderSide side)
+	{
+		int borderIdx = GetBorderIndex(clusterIdx, side);
+		RemoveBorder(borderIdx);
+
+		const Cluster& cluster = m_Clusters[clusterIdx];
+
+		// a corner only has the one diagonal connection between the corner cells
+		if (side == bottomRight || side == bottomLeft)
+		{
+			int insideCol = side == bottomRight ? cluster.column + cluster.width - 1 : cluster.column;
+			int insideRow = cluster.row + cluster.height - 1;
+			int outsideCol = side == bottomRight ? insideCol + 1 : insideCol - 1;
+			if (!m_pGraph->IsWithinBounds(outsideCol, insideRow + 1))
+				return;
+
+			int insideCell = m_pGraph->GetIndex(insideCol, insideRow);
+			int outsideCell = m_pGraph->GetIndex(outsideCol, insideRow + 1);
+			if (m_pGraph->GetConnection(insideCell, outsideCell))
+				AddTransition(borderIdx, insideCell, outsideCell);
+			return;
+		}
+
+		int borderLength = 0;
+		if (side == right)
+		{
+			if (cluster.column + cluster.width >= m_pGraph->GetColumns())
+				return;
+			borderLength = cluster.height;
+		}
+		else
+		{
+			if (cluster.row + cluster.height >= m_pGraph->GetRows())
+				return;
+			borderLength = cluster.width;
+		}
+
+		// the cell on this side of the border and its neighbour on the other side, at a given offset along the border
+		auto getInsideCell = [this, &cluster, side](int offset)
+		{
+			return side == right
+				? m_pGraph->GetIndex(cluster.column + cluster.width - 1, cluster.row + offset)
+				: m_pGraph->GetIndex(cluster.column + offset, cluster.row + cluster.height - 1);
+		};
+		auto getOutsideCell = [this, &cluster, side](int offset)
+		{
+			return side == right
+				? m_pGraph->GetIndex(cluster.column + cluster.width, cluster.row + offset)
+				: m_pGraph->GetIndex(cluster.column + offset, cluster.row + cluster.height);
+		};
+		auto addTransition = [this, borderIdx, &getInsideCell, &getOutsideCell](int offset)
+		{
+			AddTransition(borderIdx, getInsideCell(offset), getOutsideCell(offset));
+		};
+
+		// every maximal stretch of cells that are connected straight across the border is an entrance
+		int entranceStart = -1;
+		for (int offset = 0; offset <= borderLength; ++offset)
+		{
+			bool isOpen = offset < borderLength && m_pGraph->GetConnection(getInsideCell(offset), getOutsideCell(offset)) != nullptr;
+
+			if (isOpen && entranceStart == -1)
+			{
+				entranceStart = offset;
+			}
+			else if (!isOpen && entranceStart != -1)
+			{
+				int entranceEnd = offset - 1;
+				if (entranceEnd - entranceStart + 1 >= m_MinDoubleEntranceLength)
+				{
+					addTransition(entranceStart);
+					addTransition(entranceEnd);
+				}
+				else
+				{
+					addTransition((entranceStart + entranceEnd) / 2);
+				}
+				entranceStart = -1;
+			}
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void HPAStar<T_NodeType, T_ConnectionType>::RemoveBorder(int borderIdx)
+	{
+		for (int abstractIdx : m_BorderNodes[borderIdx])
+			RemoveAbstractNode(abstractIdx);
+		m_BorderNodes[borderIdx].clear();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void HPAStar<T_NodeType, T_ConnectionType>::AddTransition(int borderIdx, int insideCell, int outsideCell)
+	{
+		int insideNode = AddAbstractNode(insideCell);
+		int outsideNode = AddAbstractNode(outsideCell);
+		m_BorderNodes[borderIdx].push_back(insideNode);
+		m_BorderNodes[borderIdx].push_back(outsideNode);
+
+		float cost = m_pGraph->GetConnection(insideCell, outsideCell)->GetCost();
+		m_pAbstractGraph->AddConnection(new GraphConnection2D(insideNode, outsideNode, cost));
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void HPAStar<T_NodeType, T_ConnectionType>::ConnectCluster(int clusterIdx)
+	{
+		const std::vector<int>& abstractNodes = m_Clusters[clusterIdx].abstractNodes;
+		const Cluster& cluster = m_Clusters[clusterIdx];
+
+		for (size_t i = 0; i < abstractNodes.size(); ++i)
+		{
+			SearchCluster(clusterIdx, m_AbstractToGrid[abstractNodes[i]]);
+
+			// the graph is undirected, every pair only needs to be added once
+			for (size_t j = i + 1; j < abstractNodes.size(); ++j)
+			{
+				Vector2 colRow = m_pGraph->GetNodePos(m_AbstractToGrid[abstractNodes[j]]);
+				int localIdx = (int(colRow.y) - cluster.row) * cluster.width + (int(colRow.x) - cluster.column);
+
+				float cost = m_ClusterCosts[localIdx];
+				if (cost != m_Infinity)
+					m_pAbstractGraph->AddConnection(new GraphConnection2D(abstractNodes[i], abstractNodes[j], cost));
+			}
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void HPAStar<T_NodeType, T_ConnectionType>::DisconnectCluster(int clusterIdx)
+	{
+		for (int abstractIdx : m_Clusters[clusterIdx].abstractNodes)
+		{
+			std::vector<int> intraConnections;
+			for (GraphConnection2D* pConnection : m_pAbstractGraph->GetNodeConnections(abstractIdx))
+			{
+				if (GetClusterIndex(m_AbstractToGrid[pConnection->GetTo()]) == clusterIdx)
+					intraConnections.push_back(pConnection->GetTo());
+			}
+
+			for (int toIdx : intraConnections)
+				m_pAbstractGraph->RemoveConnection(abstractIdx, toIdx);
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	int HPAStar<T_NodeType, T_ConnectionType>::AddAbstractNode(int gridIdx)
+	{
+		int abstractIdx = m_pAbstractGraph->GetNextFreeNodeIndex();
+		if (!m_FreeAbstractIndices.empty())
+		{
+			abstractIdx = m_FreeAbstractIndices.back();
+			m_FreeAbstractIndices.pop_back();
+		}
+
+		m_pAbstractGraph->AddNode(new GraphNode2D(abstractIdx, m_pGraph->GetNodePos(gridIdx)));
+
+		if (abstractIdx >= (int)m_AbstractToGrid.size())
+			m_AbstractToGrid.resize(abstractIdx + 1, invalid_node_index);
+		m_AbstractToGrid[abstractIdx] = gridIdx;
+
+		m_Clusters[GetClusterIndex(gridIdx)].abstractNodes.push_back(abstractIdx);
+		return abstractIdx;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void HPAStar<T_NodeType, T_ConnectionType>::RemoveAbstractNode(int abstractIdx)
+	{
+		std::vector<int>& clusterNodes = m_Clusters[GetClusterIndex(m_AbstractToGrid[abstractIdx])].abstractNodes;
+		clusterNodes.erase(std::remove(clusterNodes.begin(), clusterNodes.end(), abstractIdx), clusterNodes.end());
+
+		m_pAbstractGraph->RemoveNode(abstractIdx);
+		m_AbstractToGrid[abstractIdx] = invalid_node_index;
+		m_FreeAbstractIndices.push_back(abstractIdx);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void HPAStar<T_NodeType, T_ConnectionType>::ConnectToCluster(int abstractIdx)
+	{
+		int gridIdx = m_AbstractToGrid[abstractIdx];
+		int clusterIdx = GetClusterIndex(gridIdx);
+		const Cluster& cluster = m_Clusters[clusterIdx];
+
+		SearchCluster(clusterIdx, gridIdx);
+		for (int otherIdx : cluster.abstractNodes)
+		{
+			if (otherIdx == abstractIdx)
+				continue;
+
+			Vector2 colRow = m_pGraph->GetNodePos(m_AbstractToGrid[otherIdx]);
+			int localIdx = (int(colRow.y) - cluster.row) * cluster.width + (int(colRow.x) - cluster.column);
+
+			float cost = m_ClusterCosts[localIdx];
+			if (cost != m_Infinity)
+				m_pAbstractGraph->AddConnection(new GraphConnection2D(abstractIdx, otherIdx, cost));
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void HPAStar<T_NodeType, T_ConnectionType>::SearchCluster(int clusterIdx, int gridIdx)
+	{
+		const Cluster& cluster = m_Clusters[clusterIdx];
+		auto toLocal = [&cluster, this](int idx)
+		{
+			Vector2 colRow = m_pGraph->GetNodePos(idx);
+			return (int(colRow.y) - cluster.row) * cluster.width + (int(colRow.x) - cluster.column);
+		};
+
+		std::fill(m_ClusterCosts.begin(), m_ClusterCosts.end(), m_Infinity);
+
+		using QueueEntry = std::pair<float, int>;
+		std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> openList;
+
+		m_ClusterCosts[toLocal(gridIdx)] = 0.f;
+		openList.push({ 0.f, gridIdx });
+
+		while (!openList.empty())
+		{
+			QueueEntry current = openList.top();
+			openList.pop();
+			if (current.first > m_ClusterCosts[toLocal(current.second)])
+				continue;
+
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(current.second))
+			{
+				int toIdx = pConnection->GetTo();
+				if (GetClusterIndex(toIdx) != clusterIdx)
+					continue;
+
+				float cost = current.first + pConnection->GetCost();
+				int localIdx = toLocal(toIdx);
+				if (cost < m_ClusterCosts[localIdx])
+				{
+					m_ClusterCosts[localIdx] = cost;
+					openList.push({ cost, toIdx });
+				}
+			}
+		}
+	}
+}
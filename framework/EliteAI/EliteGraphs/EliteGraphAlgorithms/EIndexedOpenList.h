@@ -0,0 +1,73 @@
+#pragma once
+
+#include "EBucketQueue.h"
+
+namespace Elite
+{
+	// Open list of node indices ordered by f-cost, kept in a binary heap or in a bucket queue (see OpenList).
+	// Entries aren't updated in place: push the node again when a cheaper way to it is found and skip entries whose cost is outdated.
+	class IndexedOpenList
+	{
+	public:
+		struct Entry
+		{
+			float estimatedTotalCost; // f-cost (= costSoFar + h-cost)
+			float costSoFar;
+			int idx;
+
+			bool operator>(const Entry& other) const { return estimatedTotalCost > other.estimatedTotalCost; }
+		};
+
+		// Buckets need a cost scale (see IGraph::GetCostScale), without one the heap is used.
+		// In the bucket queue g and h are each rounded down to 1/costScale steps, which keeps a consistent heuristic consistent:
+		// on graphs whose costs are whole numbers of steps the search still finds the cheapest path.
+		IndexedOpenList(OpenList openList, float costScale);
+
+		void Push(int idx, float costSoFar, float heuristicCost);
+		Entry Pop();
+		// no entry has a lower f-cost, in the bucket queue it's the rounded f-cost of the first bucket
+		float GetMinCost();
+
+		bool IsEmpty() const { return m_UseBuckets ? m_Buckets.IsEmpty() : m_Heap.empty(); }
+		size_t GetSize() const { return m_UseBuckets ? m_Buckets.GetSize() : m_Heap.size(); }
+
+	private:
+		float m_CostScale;
+		bool m_UseBuckets;
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> m_Heap;
+		BucketQueue<Entry> m_Buckets;
+	};
+
+	inline IndexedOpenList::IndexedOpenList(OpenList openList, float costScale)
+		: m_CostScale(costScale)
+		, m_UseBuckets(openList == OpenList::bucketQueue && costScale > 0.f)
+	{
+	}
+
+	inline void IndexedOpenList::Push(int idx, float costSoFar, float heuristicCost)
+	{
+		Entry entry{ costSoFar + heuristicCost, costSoFar, idx };
+		if (m_UseBuckets)
+			m_Buckets.Push(static_cast<unsigned int>(costSoFar * m_CostScale + 0.001f) + static_cast<unsigned int>(heuristicCost * m_CostScale + 0.001f), entry);
+		else
+			m_Heap.push(entry);
+	}
+
+	inline IndexedOpenList::Entry IndexedOpenList::Pop()
+	{
+		if (m_UseBuckets)
+			return m_Buckets.Pop();
+
+		Entry entry = m_Heap.top();
+		m_Heap.pop();
+		return entry;
+	}
+
+	inline float IndexedOpenList::GetMinCost()
+	{
+		if (m_UseBuckets)
+			return m_Buckets.GetMinKey() / m_CostScale;
+
+		return m_Heap.top().estimatedTotalCost;
+	}
+}
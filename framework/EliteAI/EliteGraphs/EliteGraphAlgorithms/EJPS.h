@@ -1,5 +1,8 @@
 #pragma once
 
+#include "EIndexedOpenList.h"
+#include "EBidirectionalSearch.h"
+
 namespace Elite
 {
 	template <class T_NodeType, class T_ConnectionType>
@@ -32,8 +35,31 @@ namespace Elite
 		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
 		std::vector<T_NodeType*> GetJumpPoints() const;
 
+		// by default a goal in another component gives an empty path
+		void SetUnreachableGoal(UnreachableGoal unreachableGoal) { m_UnreachableGoal = unreachableGoal; }
+
+		// The heap and the bucket queue keep their records per node index instead of searching the open and closed lists.
+		// Jumps are measured as straight line distances, which don't scale to whole numbers: the bucket queue rounds f-costs
+		// down to 1/GetCostScale() steps, so it can return a slightly longer path than the heap does.
+		void SetOpenList(OpenList openList) { m_OpenList = openList; }
+
+		// Search from both ends at once (see BidirectionalSearch), optionally with the backward search on a second thread.
+		// Both sides stop on different jump points, so meeting in the middle proves nothing: the forward side expands the same jump points
+		// a single search does, until its lowest f-cost reaches the cheapest path the sides met on. The path is never longer than a single
+		// search finds, it can only end sooner when the backward side already met it on that path.
+		void SetBidirectional(bool isBidirectional, bool useTwoThreads = false) { m_IsBidirectional = isBidirectional; m_UseTwoThreads = useTwoThreads; }
+
+		// Cells with less clearance than this (see GridGraph::GetClearance) count as blocked, so one grid serves every agent size.
+		// The start and goal need it as well. A goal that can only be reached through narrower gaps gives an empty path.
+		void SetMinClearance(int minClearance) { m_MinClearance = minClearance; }
+
+		// jump points taken from the open list by the last FindPath
+		int GetNrOfExpandedNodes() const { return int(m_JumpPoints.size()); }
+
 	private:
 		float GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const;
+		std::vector<T_NodeType*> FindPathIndexed(T_NodeType* pStartNode, T_NodeType* pGoalNode);
+		std::vector<T_NodeType*> FindPathBidirectional(T_NodeType* pStartNode, T_NodeType* pGoalNode);
 
 		std::vector<T_NodeType*> GetSuccessors(const JPSNode& currentNode, T_NodeType* pStartNode, T_NodeType* pEndNode) const;
 		T_NodeType* Jump(T_NodeType* Parent, int horizontal, int vertical, T_NodeType* pStartNode, T_NodeType* pEndNode) const;
@@ -44,6 +70,11 @@ namespace Elite
 		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
 		std::vector<T_NodeType*> m_JumpPoints;
 		Heuristic m_HeuristicFunction;
+		UnreachableGoal m_UnreachableGoal = UnreachableGoal::reject;
+		OpenList m_OpenList = OpenList::linearScan;
+		bool m_IsBidirectional = false;
+		bool m_UseTwoThreads = false;
+		int m_MinClearance = 0;
 	};
 
 	template <class T_NodeType, class T_ConnectionType>
@@ -61,6 +92,27 @@ namespace Elite
 		std::vector<T_NodeType*> path;
 		m_JumpPoints.clear();
 
+		//without this check an unreachable goal makes the search visit every node it can reach before giving up
+		int startComponent = m_pGraph->GetComponent(pStartNode->GetIndex());
+		if (startComponent != m_pGraph->GetComponent(pGoalNode->GetIndex()))
+		{
+			if (m_UnreachableGoal == UnreachableGoal::reject)
+				return path;
+
+			int nearestIdx = m_pGraph->GetNearestNodeInComponent(pGoalNode->GetIndex(), startComponent);
+			if (nearestIdx == invalid_node_index)
+				return path;
+			pGoalNode = m_pGraph->GetNode(nearestIdx);
+		}
+
+		if (m_MinClearance > 0 && (m_pGraph->GetClearance(pStartNode->GetIndex()) < m_MinClearance || m_pGraph->GetClearance(pGoalNode->GetIndex()) < m_MinClearance))
+			return path;
+
+		if (m_IsBidirectional && !m_pGraph->IsDirectionalGraph())
+			return FindPathBidirectional(pStartNode, pGoalNode);
+		if (m_OpenList != OpenList::linearScan)
+			return FindPathIndexed(pStartNode, pGoalNode);
+
 		JPSNode startNode;
 		startNode.pNode = pStartNode;
 		startNode.pParentNode = nullptr;
@@ -147,6 +199,107 @@ namespace Elite
 
 	}
 
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> JPS<T_NodeType, T_ConnectionType>::FindPathIndexed(T_NodeType* pStartNode, T_NodeType* pGoalNode)
+	{
+		IndexedOpenList openList(m_OpenList, m_pGraph->GetCostScale());
+		std::vector<float> costsSoFar(m_pGraph->GetNrOfNodes(), std::numeric_limits<float>::infinity());
+		std::vector<int> parents(m_pGraph->GetNrOfNodes(), invalid_node_index);
+		std::vector<T_NodeType*> path;
+
+		costsSoFar[pStartNode->GetIndex()] = 0.f;
+		openList.Push(pStartNode->GetIndex(), 0.f, GetHeuristicCost(pStartNode, pGoalNode));
+
+		bool isGoalFound = false;
+		while (!openList.IsEmpty())
+		{
+			IndexedOpenList::Entry current = openList.Pop();
+
+			//a cheaper way to this node was pushed after this entry
+			if (current.costSoFar > costsSoFar[current.idx])
+				continue;
+
+			m_JumpPoints.push_back(m_pGraph->GetNode(current.idx));
+			if (current.idx == pGoalNode->GetIndex())
+			{
+				isGoalFound = true;
+				break;
+			}
+
+			//the successors only need the parent's node to know the direction the search came from
+			JPSNode parentNode{};
+			JPSNode currentNode{};
+			currentNode.pNode = m_pGraph->GetNode(current.idx);
+			if (parents[current.idx] != invalid_node_index)
+			{
+				parentNode.pNode = m_pGraph->GetNode(parents[current.idx]);
+				currentNode.pParentNode = &parentNode;
+			}
+
+			Vector2 currentPos = m_pGraph->GetNodePos(current.idx);
+			for (T_NodeType* pSuccessor : GetSuccessors(currentNode, pStartNode, pGoalNode))
+			{
+				int successorIdx = pSuccessor->GetIndex();
+				float costSoFar = current.costSoFar + currentPos.Distance(m_pGraph->GetNodePos(successorIdx));
+				if (costSoFar < costsSoFar[successorIdx])
+				{
+					costsSoFar[successorIdx] = costSoFar;
+					parents[successorIdx] = current.idx;
+					openList.Push(successorIdx, costSoFar, GetHeuristicCost(pSuccessor, pGoalNode));
+				}
+			}
+		}
+
+		if (!isGoalFound)
+			return path;
+
+		for (int idx = pGoalNode->GetIndex(); idx != invalid_node_index; idx = parents[idx])
+			path.push_back(m_pGraph->GetNode(idx));
+		std::reverse(path.begin(), path.end());
+
+		return path;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> JPS<T_NodeType, T_ConnectionType>::FindPathBidirectional(T_NodeType* pStartNode, T_NodeType* pGoalNode)
+	{
+		BidirectionalSearch search(m_pGraph->GetNrOfNodes());
+		search.SetIsSymmetric(false);
+
+		//the backward search jumps from the goal towards the start, the grid is the same in both directions
+		auto getSuccessors = [this](int idx, int parentIdx, int startIdx, int targetIdx, std::vector<std::pair<int, float>>& successors)
+		{
+			JPSNode parentNode{};
+			JPSNode currentNode{};
+			currentNode.pNode = m_pGraph->GetNode(idx);
+			if (parentIdx != invalid_node_index)
+			{
+				parentNode.pNode = m_pGraph->GetNode(parentIdx);
+				currentNode.pParentNode = &parentNode;
+			}
+
+			Vector2 currentPos = m_pGraph->GetNodePos(idx);
+			for (T_NodeType* pSuccessor : GetSuccessors(currentNode, m_pGraph->GetNode(startIdx), m_pGraph->GetNode(targetIdx)))
+				successors.push_back({ pSuccessor->GetIndex(), currentPos.Distance(m_pGraph->GetNodePos(pSuccessor)) });
+		};
+		auto getHeuristicCost = [this](int idx, int targetIdx)
+		{
+			return GetHeuristicCost(m_pGraph->GetNode(idx), m_pGraph->GetNode(targetIdx));
+		};
+
+		std::vector<T_NodeType*> path;
+		bool isPathFound = search.Search(pStartNode->GetIndex(), pGoalNode->GetIndex(), getSuccessors, getHeuristicCost, m_UseTwoThreads);
+		for (int idx : search.GetExpandedNodes())
+			m_JumpPoints.push_back(m_pGraph->GetNode(idx));
+		if (!isPathFound)
+			return path;
+
+		for (int idx : search.GetPath())
+			path.push_back(m_pGraph->GetNode(idx));
+
+		return path;
+	}
+
 	template <class T_NodeType, class T_ConnectionType>
 	std::vector<T_NodeType*> Elite::JPS<T_NodeType, T_ConnectionType>::GetSuccessors(const JPSNode& currentNode, T_NodeType* pStartNode, T_NodeType* pEndNode) const
 	{
@@ -371,7 +524,7 @@ namespace Elite
 		}
 
 		T_NodeType* nextNode{ m_pGraph->GetNode(int(nextPos.x), int(nextPos.y)) };
-		Jump(nextNode, horizontal, vertical, pStartNode, pEndNode);
+		return Jump(nextNode, horizontal, vertical, pStartNode, pEndNode);
 	}
 
 
@@ -386,6 +539,9 @@ namespace Elite
 		if (m_pGraph->GetNode(nodeIdx)->GetTerrainType() == TerrainType::Water)//check if node isnt blocked
 			return true;
 
+		if (m_MinClearance > 0 && m_pGraph->GetClearance(nodeIdx) < m_MinClearance)//too narrow for the agent
+			return true;
+
 		return false;
 	}
 
@@ -0,0 +1,257 @@
+#pragma once
+#include <memory>
+
+namespace Elite
+{
+	enum class PathCacheKey
+	{
+		startGoal,	// only exact (start, goal) queries hit
+		region,		// queries between the same pair of regions share a path, the ends get stitched on
+	};
+
+	// LRU cache in front of a grid pathfinder (AStar, JPS, ...)
+	// Every cached path remembers the versions of the regions it crosses, editing a node bumps its region version (see GridGraph::SetTerrainType)
+	// so only paths through edited regions get evicted. Paths are validated lazily when they are looked up.
+	template <class T_NodeType, class T_ConnectionType>
+	class PathCache
+	{
+	public:
+		using PathFinder = std::function<std::vector<T_NodeType*>(T_NodeType*, T_NodeType*)>;
+
+		PathCache(GridGraph<T_NodeType, T_ConnectionType>* pGraph, PathFinder pathFinder, unsigned int capacity = 256, PathCacheKey keyType = PathCacheKey::startGoal);
+
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		void Clear();
+
+		// Statistics
+		unsigned int GetNrOfEntries() const { return (unsigned int)m_Entries.size(); }
+		unsigned int GetHits() const { return m_NrOfHits; }
+		unsigned int GetMisses() const { return m_NrOfMisses; }
+		unsigned int GetEvictions() const { return m_NrOfEvictions; } // dropped because the cache was full
+		unsigned int GetInvalidations() const { return m_NrOfInvalidations; } // dropped because a crossed region was edited
+		float GetHitRate() const;
+		size_t GetMemoryUsage() const; // approximate, in bytes
+		void ResetStatistics();
+
+	private:
+		struct RegionStamp
+		{
+			int regionIdx;
+			unsigned int version;
+		};
+
+		struct CacheEntry
+		{
+			unsigned long long key;
+			std::vector<T_NodeType*> path;
+			std::vector<RegionStamp> regions;
+		};
+
+		using EntryList = std::list<CacheEntry>;
+
+		unsigned long long GetKey(T_NodeType* pStartNode, T_NodeType* pDestinationNode) const;
+		bool IsValid(const CacheEntry& entry) const;
+		bool IsCompletePath(const std::vector<T_NodeType*>& path, T_NodeType* pStartNode, T_NodeType* pDestinationNode) const;
+		std::vector<T_NodeType*> StitchPath(const std::vector<T_NodeType*>& cachedPath, T_NodeType* pStartNode, T_NodeType* pDestinationNode) const;
+		void Insert(unsigned long long key, const std::vector<T_NodeType*>& path);
+
+		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		PathFinder m_PathFinder;
+		unsigned int m_Capacity;
+		PathCacheKey m_KeyType;
+
+		// most recently used entry at the front
+		EntryList m_Entries;
+		std::unordered_map<unsigned long long, typename EntryList::iterator> m_Lookup;
+
+		unsigned int m_NrOfHits = 0;
+		unsigned int m_NrOfMisses = 0;
+		unsigned int m_NrOfEvictions = 0;
+		unsigned int m_NrOfInvalidations = 0;
+	};
+
+	template <class T_NodeType, class T_ConnectionType>
+	PathCache<T_NodeType, T_ConnectionType>::PathCache(GridGraph<T_NodeType, T_ConnectionType>* pGraph, PathFinder pathFinder, unsigned int capacity, PathCacheKey keyType)
+		: m_pGraph(pGraph)
+		, m_PathFinder(pathFinder)
+		, m_Capacity(capacity)
+		, m_KeyType(keyType)
+	{
+		assert(m_Capacity > 0 && "<PathCache>: capacity must be at least 1");
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> PathCache<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode)
+	{
+		unsigned long long key = GetKey(pStartNode, pDestinationNode);
+
+		auto lookupIt = m_Lookup.find(key);
+		if (lookupIt != m_Lookup.end())
+		{
+			auto entryIt = lookupIt->second;
+			if (IsValid(*entryIt))
+			{
+				std::vector<T_NodeType*> path = entryIt->path;
+				if (m_KeyType == PathCacheKey::region)
+					path = StitchPath(entryIt->path, pStartNode, pDestinationNode);
+
+				if (IsCompletePath(path, pStartNode, pDestinationNode))
+				{
+					// move to the front, this is now the most recently used entry
+					m_Entries.splice(m_Entries.begin(), m_Entries, entryIt);
+					++m_NrOfHits;
+					return path;
+				}
+			}
+			else
+			{
+				++m_NrOfInvalidations;
+			}
+
+			m_Entries.erase(entryIt);
+			m_Lookup.erase(lookupIt);
+		}
+
+		++m_NrOfMisses;
+		std::vector<T_NodeType*> path = m_PathFinder(pStartNode, pDestinationNode);
+
+		// failed searches are never cached, removing an obstacle anywhere could make them succeed
+		if (IsCompletePath(path, pStartNode, pDestinationNode))
+			Insert(key, path);
+
+		return path;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void PathCache<T_NodeType, T_ConnectionType>::Clear()
+	{
+		m_Entries.clear();
+		m_Lookup.clear();
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	float PathCache<T_NodeType, T_ConnectionType>::GetHitRate() const
+	{
+		unsigned int nrOfQueries = m_NrOfHits + m_NrOfMisses;
+		if (nrOfQueries == 0)
+			return 0.f;
+
+		return float(m_NrOfHits) / nrOfQueries;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	size_t PathCache<T_NodeType, T_ConnectionType>::GetMemoryUsage() const
+	{
+		size_t bytes = sizeof(*this);
+		for (const CacheEntry& entry : m_Entries)
+		{
+			// list node (entry + 2 links) and its lookup bucket entry
+			bytes += sizeof(CacheEntry) + 2 * sizeof(void*);
+			bytes += sizeof(typename std::unordered_map<unsigned long long, typename EntryList::iterator>::value_type) + sizeof(void*);
+
+			bytes += entry.path.capacity() * sizeof(T_NodeType*);
+			bytes += entry.regions.capacity() * sizeof(RegionStamp);
+		}
+		bytes += m_Lookup.bucket_count() * sizeof(void*);
+
+		return bytes;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void PathCache<T_NodeType, T_ConnectionType>::ResetStatistics()
+	{
+		m_NrOfHits = 0;
+		m_NrOfMisses = 0;
+		m_NrOfEvictions = 0;
+		m_NrOfInvalidations = 0;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	unsigned long long PathCache<T_NodeType, T_ConnectionType>::GetKey(T_NodeType* pStartNode, T_NodeType* pDestinationNode) const
+	{
+		unsigned int from = pStartNode->GetIndex();
+		unsigned int to = pDestinationNode->GetIndex();
+
+		if (m_KeyType == PathCacheKey::region)
+		{
+			from = m_pGraph->GetRegionIndex(from);
+			to = m_pGraph->GetRegionIndex(to);
+		}
+
+		return ((unsigned long long)from << 32) | to;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	bool PathCache<T_NodeType, T_ConnectionType>::IsValid(const CacheEntry& entry) const
+	{
+		for (const RegionStamp& stamp : entry.regions)
+		{
+			if (m_pGraph->GetRegionVersion(stamp.regionIdx) != stamp.version)
+				return false;
+		}
+
+		return true;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	bool PathCache<T_NodeType, T_ConnectionType>::IsCompletePath(const std::vector<T_NodeType*>& path, T_NodeType* pStartNode, T_NodeType* pDestinationNode) const
+	{
+		// An unreachable destination either gives no path or, when AStar or JPS redirect it, a path to the nearest reachable node instead
+		return !path.empty() && path.front() == pStartNode && path.back() == pDestinationNode;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> PathCache<T_NodeType, T_ConnectionType>::StitchPath(const std::vector<T_NodeType*>& cachedPath, T_NodeType* pStartNode, T_NodeType* pDestinationNode) const
+	{
+		// Search from the start to the beginning of the cached path, and from the end of the cached path to the destination.
+		// Both ends lie in the same region as the query so these searches stay short. The result is not guaranteed to be optimal.
+		std::vector<T_NodeType*> path;
+
+		if (pStartNode != cachedPath.front())
+		{
+			path = m_PathFinder(pStartNode, cachedPath.front());
+			if (!IsCompletePath(path, pStartNode, cachedPath.front()))
+				return {};
+			path.pop_back();
+		}
+
+		path.insert(path.end(), cachedPath.begin(), cachedPath.end());
+
+		if (pDestinationNode != cachedPath.back())
+		{
+			std::vector<T_NodeType*> tail = m_PathFinder(cachedPath.back(), pDestinationNode);
+			if (!IsCompletePath(tail, cachedPath.back(), pDestinationNode))
+				return {};
+			path.insert(path.end(), tail.begin() + 1, tail.end());
+		}
+
+		return path;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void PathCache<T_NodeType, T_ConnectionType>::Insert(unsigned long long key, const std::vector<T_NodeType*>& path)
+	{
+		if (m_Entries.size() >= m_Capacity)
+		{
+			// least recently used entry is at the back
+			m_Lookup.erase(m_Entries.back().key);
+			m_Entries.pop_back();
+			++m_NrOfEvictions;
+		}
+
+		CacheEntry entry{ key, path, {} };
+
+		// record every region the path crosses, with the version it had when the path was found
+		for (T_NodeType* pNode : path)
+		{
+			int regionIdx = m_pGraph->GetRegionIndex(pNode->GetIndex());
+			auto isSameRegion = [regionIdx](const RegionStamp& stamp) { return stamp.regionIdx == regionIdx; };
+			if (std::find_if(entry.regions.begin(), entry.regions.end(), isSameRegion) == entry.regions.end())
+				entry.regions.push_back(RegionStamp{ regionIdx, m_pGraph->GetRegionVersion(regionIdx) });
+		}
+		entry.regions.shrink_to_fit();
+
+		m_Entries.push_front(std::move(entry));
+		m_Lookup[key] = m_Entries.begin();
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+namespace Elite
+{
+	// Hash table from (node, time step) to an agent, for cooperative pathfinding (see CooperativeAStar).
+	// Open addressing with linear probing over two flat arrays, 12 bytes per slot. Entries can't be removed one by one,
+	// the table is cleared as a whole when the agents plan again. Clear only resets the slots in use, a table that grew
+	// for one big search doesn't make clearing it after every small one expensive.
+	class ReservationTable
+	{
+	public:
+		explicit ReservationTable(unsigned int capacity = 1024);
+
+		// false when another agent already holds the node at that time, reserving it again for the same agent is fine
+		bool Reserve(int idx, unsigned int time, int agent);
+		// the agent that holds the node at that time, -1 when it's free
+		int GetAgent(int idx, unsigned int time) const;
+		bool IsReserved(int idx, unsigned int time) const { return GetAgent(idx, time) != -1; }
+
+		void Clear();
+		size_t GetSize() const { return m_Size; }
+		size_t GetMemoryUsage() const { return m_Keys.capacity() * sizeof(unsigned long long) + (m_Agents.capacity() + m_UsedSlots.capacity()) * sizeof(int); }
+
+	private:
+		static constexpr unsigned long long m_EmptyKey = ~0ULL;
+
+		static unsigned long long GetKey(int idx, unsigned int time) { return static_cast<unsigned long long>(time) << 32 | static_cast<unsigned int>(idx); }
+		size_t GetSlot(unsigned long long key) const;
+		void Grow();
+
+		std::vector<unsigned long long> m_Keys; // size is a power of two
+		std::vector<int> m_Agents;
+		std::vector<unsigned int> m_UsedSlots; // in the order they were filled
+		size_t m_Size = 0;
+		int m_Shift; // 64 - log2(size), the hash keeps the top bits
+	};
+
+	inline ReservationTable::ReservationTable(unsigned int capacity)
+	{
+		unsigned int size = 16;
+		while (size < capacity)
+			size *= 2;
+
+		m_Keys.assign(size, m_EmptyKey);
+		m_Agents.assign(size, -1);
+		m_Shift = 64;
+		for (unsigned int i = size; i > 1; i /= 2)
+			--m_Shift;
+	}
+
+	inline bool ReservationTable::Reserve(int idx, unsigned int time, int agent)
+	{
+		//stay under 3/4 full, probe sequences get long after that
+		if ((m_Size + 1) * 4 > m_Keys.size() * 3)
+			Grow();
+
+		unsigned long long key = GetKey(idx, time);
+		size_t slot = GetSlot(key);
+		if (m_Keys[slot] == key)
+			return m_Agents[slot] == agent;
+
+		m_Keys[slot] = key;
+		m_Agents[slot] = agent;
+		m_UsedSlots.push_back(static_cast<unsigned int>(slot));
+		++m_Size;
+		return true;
+	}
+
+	inline int ReservationTable::GetAgent(int idx, unsigned int time) const
+	{
+		size_t slot = GetSlot(GetKey(idx, time));
+		return m_Keys[slot] == m_EmptyKey ? -1 : m_Agents[slot];
+	}
+
+	inline void ReservationTable::Clear()
+	{
+		if (m_Size == 0)
+			return;
+
+		for (unsigned int slot : m_UsedSlots)
+			m_Keys[slot] = m_EmptyKey;
+		m_UsedSlots.clear();
+		m_Size = 0;
+	}
+
+	inline size_t ReservationTable::GetSlot(unsigned long long key) const
+	{
+		//the slot with the key, or the empty slot where it would go
+		size_t mask = m_Keys.size() - 1;
+		size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> m_Shift);
+		while (m_Keys[slot] != key && m_Keys[slot] != m_EmptyKey)
+			slot = (slot + 1) & mask;
+
+		return slot;
+	}
+
+	inline void ReservationTable::Grow()
+	{
+		std::vector<unsigned long long> keys(m_Keys.size() * 2, m_EmptyKey);
+		std::vector<int> agents(m_Agents.size() * 2, -1);
+		keys.swap(m_Keys);
+		agents.swap(m_Agents);
+		--m_Shift;
+
+		for (unsigned int& usedSlot : m_UsedSlots)
+		{
+			size_t slot = GetSlot(keys[usedSlot]);
+			m_Keys[slot] = keys[usedSlot];
+			m_Agents[slot] = agents[usedSlot];
+			usedSlot = static_cast<unsigned int>(slot);
+		}
+	}
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "EIndexedOpenList.h"
+#include "EGridLineOfSight.h"
+
+namespace Elite
+{
+	// Any-angle A* over a GridGraph: a node can take its parent's parent as its own parent when it can see it,
+	// so the path is a list of corners instead of every cell on the way. Costs are straight line distances between cells.
+	// Lazy Theta* assumes the parent's parent is visible and only checks it when the node is expanded, which saves most
+	// line of sight checks for paths that are about as short.
+	template <class T_NodeType, class T_ConnectionType>
+	class ThetaStar
+	{
+	public:
+		// Without a line of sight object of its own the search makes one, share one to keep its cache between searches
+		ThetaStar(GridGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction, GridLineOfSight<T_NodeType, T_ConnectionType>* pLineOfSight = nullptr);
+		~ThetaStar();
+
+		// corners of the path, from start to goal
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pGoalNode);
+
+		void SetLazy(bool isLazy) { m_IsLazy = isLazy; }
+		int GetNrOfExpandedNodes() const { return m_NrOfExpandedNodes; }
+
+	private:
+		float GetDistance(int fromIdx, int toIdx) const { return m_pGraph->GetNodePos(fromIdx).Distance(m_pGraph->GetNodePos(toIdx)); }
+		float GetHeuristicCost(int fromIdx, int toIdx) const;
+
+		GridGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+		Heuristic m_HeuristicFunction;
+		GridLineOfSight<T_NodeType, T_ConnectionType>* m_pLineOfSight;
+		bool m_IsLineOfSightOwner;
+		bool m_IsLazy = false;
+		int m_NrOfExpandedNodes = 0;
+	};
+
+	template <class T_NodeType, class T_ConnectionType>
+	ThetaStar<T_NodeType, T_ConnectionType>::ThetaStar(GridGraph<T_NodeType, T_ConnectionType>* pGraph, Heuristic hFunction, GridLineOfSight<T_NodeType, T_ConnectionType>* pLineOfSight)
+		: m_pGraph(pGraph)
+		, m_HeuristicFunction(hFunction)
+		, m_pLineOfSight(pLineOfSight)
+		, m_IsLineOfSightOwner(pLineOfSight == nullptr)
+	{
+		if (m_IsLineOfSightOwner)
+			m_pLineOfSight = new GridLineOfSight<T_NodeType, T_ConnectionType>(pGraph);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	ThetaStar<T_NodeType, T_ConnectionType>::~ThetaStar()
+	{
+		if (m_IsLineOfSightOwner)
+			SAFE_DELETE(m_pLineOfSight);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> ThetaStar<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pGoalNode)
+	{
+		std::vector<T_NodeType*> path;
+		m_NrOfExpandedNodes = 0;
+
+		int startIdx = pStartNode->GetIndex();
+		int goalIdx = pGoalNode->GetIndex();
+		if (!m_pGraph->IsInSameComponent(startIdx, goalIdx))
+			return path;
+
+		IndexedOpenList openList(OpenList::binaryHeap, 0.f);
+		std::vector<float> costsSoFar(m_pGraph->GetNrOfNodes(), std::numeric_limits<float>::infinity());
+		std::vector<int> parents(m_pGraph->GetNrOfNodes(), invalid_node_index);
+		std::vector<bool> isClosed(m_pGraph->GetNrOfNodes(), false);
+
+		costsSoFar[startIdx] = 0.f;
+		parents[startIdx] = startIdx;
+		openList.Push(startIdx, 0.f, GetHeuristicCost(startIdx, goalIdx));
+
+		while (!openList.IsEmpty())
+		{
+			IndexedOpenList::Entry current = openList.Pop();
+
+			//a cheaper way to this node was pushed after this entry
+			if (isClosed[current.idx] || current.costSoFar > costsSoFar[current.idx])
+				continue;
+
+			int idx = current.idx;
+			isClosed[idx] = true;
+			++m_NrOfExpandedNodes;
+
+			//lazy: the parent was taken on trust, fall back to the best expanded neighbour when it isn't visible after all
+			if (m_IsLazy && !m_pLineOfSight->HasLineOfSight(parents[idx], idx))
+			{
+				costsSoFar[idx] = std::numeric_limits<float>::infinity();
+				for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(idx))
+				{
+					int neighbourIdx = pConnection->GetTo();
+					float cost = costsSoFar[neighbourIdx] + GetDistance(neighbourIdx, idx);
+					if (isClosed[neighbourIdx] && cost < costsSoFar[idx])
+					{
+						costsSoFar[idx] = cost;
+						parents[idx] = neighbourIdx;
+					}
+				}
+			}
+
+			if (idx == goalIdx)
+				break;
+
+			int parentIdx = parents[idx];
+			for (T_ConnectionType* pConnection : m_pGraph->GetNodeConnections(idx))
+			{
+				int nextIdx = pConnection->GetTo();
+				if (isClosed[nextIdx])
+					continue;
+
+				//path 2 goes straight from the parent, path 1 through this node
+				float costSoFar = costsSoFar[idx] + GetDistance(idx, nextIdx);
+				int nextParentIdx = idx;
+				if (m_IsLazy || m_pLineOfSight->HasLineOfSight(parentIdx, nextIdx))
+				{
+					float costFromParent = costsSoFar[parentIdx] + GetDistance(parentIdx, nextIdx);
+					if (costFromParent <= costSoFar)
+					{
+						costSoFar = costFromParent;
+						nextParentIdx = parentIdx;
+					}
+				}
+
+				if (costSoFar < costsSoFar[nextIdx])
+				{
+					costsSoFar[nextIdx] = costSoFar;
+					parents[nextIdx] = nextParentIdx;
+					openList.Push(nextIdx, costSoFar, GetHeuristicCost(nextIdx, goalIdx));
+				}
+			}
+		}
+
+		if (!isClosed[goalIdx])
+			return path;
+
+		for (int idx = goalIdx; idx != startIdx; idx = parents[idx])
+			path.push_back(m_pGraph->GetNode(idx));
+		path.push_back(pStartNode);
+		std::reverse(path.begin(), path.end());
+
+		return path;
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	float ThetaStar<T_NodeType, T_ConnectionType>::GetHeuristicCost(int fromIdx, int toIdx) const
+	{
+		Vector2 toDestination = m_pGraph->GetNodePos(toIdx) - m_pGraph->GetNodePos(fromIdx);
+		return m_HeuristicFunction(abs(toDestination.x), abs(toDestination.y));
+	}
+}
@@ -46,17 +46,7 @@ bool Elite::EGraphEditor::UpdateGraph(GridGraph<GridTerrainNode, GraphConnection
 		{
 			std::vector<TerrainType> terrainTypeVec{ TerrainType::Ground, TerrainType::Mud, TerrainType::Water };
 
-			pGraph->GetNode(idx)->SetTerrainType(terrainTypeVec[m_SelectedTerrainType]);
-			
-			switch (terrainTypeVec[m_SelectedTerrainType])
-			{
-			case TerrainType::Water:
-				pGraph->IsolateNode(idx);
-				break;
-			default:
-				pGraph->UnIsolateNode(idx);
-				break;
-			}
+			pGraph->SetTerrainType(idx, terrainTypeVec[m_SelectedTerrainType]);
 			return true;
 		}
 	}
@@ -3,24 +3,31 @@
 
 namespace Elite
 {
+	EGraphRenderer::~EGraphRenderer()
+	{
+		if (m_GridLayer != m_NoGridLayer)
+			DEBUGRENDERER2D->DestroyGridLayer(m_GridLayer);
+		if (m_TileLayer != m_NoGridLayer)
+			DEBUGRENDERER2D->DestroyGridLayer(m_TileLayer);
+	}
+
 	void EGraphRenderer::RenderCircleNode(Vector2 pos, std::string text /*= ""*/, float radius /*= 3.0f*/, Elite::Color col /*= DEFAULT_NODE_COLOR*/, float depth /*= 0.0f*/) const
 	{
-		DEBUGRENDERER2D->DrawSolidCircle(pos, radius, { 0,0 }, col, depth);
+		DEBUGRENDERER2D->DrawSolidCircleInstance(pos, radius, col, depth);
+		if (text.empty())
+			return;
+
 		const auto stringOffset = Vector2{ -0.5f, 1.f };
 		DEBUGRENDERER2D->DrawString(pos + stringOffset, text.c_str());
 	}
 
 	void EGraphRenderer::RenderRectNode(Vector2 pos, std::string text /*= ""*/, float width /* = 3.0f*/, Elite::Color col /*= DEFAULT_NODE_COLOR*/, float depth /*= 0.0f*/) const
 	{
-		Vector2 verts[4]
-		{
-			Vector2(pos.x - width / 2.0f, pos.y - width / 2.0f),
-			Vector2(pos.x - width / 2.0f, pos.y + width / 2.0f),
-			Vector2(pos.x + width / 2.0f, pos.y + width / 2.0f),
-			Vector2(pos.x + width / 2.0f, pos.y - width / 2.0f)
-		};
+		//Same half transparent fill as a solid polygon
+		DEBUGRENDERER2D->DrawSolidRectInstance(pos, width / 2.0f, 0.0f, Color(col.r, col.g, col.b, 0.5f), depth);
 
-		DEBUGRENDERER2D->DrawSolidPolygon(&verts[0], 4, col, depth);
+		if (text.empty())
+			return;
 
 		const auto stringOffset = Vector2{ -0.5f, 1.f };
 		DEBUGRENDERER2D->DrawString(pos + stringOffset, text.c_str());
@@ -33,6 +40,161 @@ namespace Elite
 		auto center = toPos + (fromPos - toPos) / 2;
 
 		DEBUGRENDERER2D->DrawSegment(toPos, fromPos, col, depth);
-		DEBUGRENDERER2D->DrawString(center, text.c_str());
+		if (!text.empty())
+			DEBUGRENDERER2D->DrawString(center, text.c_str());
+	}
+
+	void EGraphRenderer::ResetGridMesh(int columns, int rows) const
+	{
+		if (m_GridLayer != m_NoGridLayer && (columns != m_MeshColumns || rows != m_MeshRows))
+		{
+			DEBUGRENDERER2D->DestroyGridLayer(m_GridLayer);
+			m_GridLayer = m_NoGridLayer;
+		}
+
+		if (m_GridLayer == m_NoGridLayer)
+			m_GridLayer = DEBUGRENDERER2D->CreateGridLayer(columns, rows);
+
+		m_MeshColumns = columns;
+		m_MeshRows = rows;
+		m_MeshCells.assign(size_t(columns) * rows, 0);
+		m_MeshPalette.clear();
+		m_UploadedPaletteSize = 0;
+
+		//tiles are built again from scratch the next time they're needed
+		m_TileSize = 0;
+	}
+
+	unsigned char EGraphRenderer::GetPaletteIndex(const Elite::Color& nodeColor) const
+	{
+		// same fill as DrawSolidPolygon gives the node rectangles
+		const Color fillColor(0.5f * nodeColor.r, 0.5f * nodeColor.g, 0.5f * nodeColor.b, 0.5f);
+		for (size_t i = 0; i < m_MeshPalette.size(); ++i)
+		{
+			const Color& color = m_MeshPalette[i];
+			if (color.r == fillColor.r && color.g == fillColor.g && color.b == fillColor.b && color.a == fillColor.a)
+				return static_cast<unsigned char>(i);
+		}
+
+		assert(m_MeshPalette.size() < 256 && "<EGraphRenderer::GetPaletteIndex>: a grid mesh can have at most 256 node colors");
+		m_MeshPalette.push_back(fillColor);
+		return static_cast<unsigned char>(m_MeshPalette.size() - 1);
+	}
+
+	void EGraphRenderer::UploadGridMesh(int firstCol, int firstRow, int lastCol, int lastRow) const
+	{
+		if (m_MeshPalette.size() != m_UploadedPaletteSize)
+		{
+			DEBUGRENDERER2D->SetGridLayerPalette(m_GridLayer, m_MeshPalette.data(), int(m_MeshPalette.size()));
+			m_UploadedPaletteSize = m_MeshPalette.size();
+		}
+
+		const int width = lastCol - firstCol + 1;
+		const int height = lastRow - firstRow + 1;
+		DEBUGRENDERER2D->UpdateGridLayer(m_GridLayer, firstCol, firstRow, width, height, &m_MeshCells[size_t(firstRow) * m_MeshColumns + firstCol], m_MeshColumns);
+		m_NrOfUploadedCells += width * height;
+
+		if (m_DirtyLastCol < 0)
+		{
+			m_DirtyFirstCol = firstCol;
+			m_DirtyFirstRow = firstRow;
+			m_DirtyLastCol = lastCol;
+			m_DirtyLastRow = lastRow;
+			return;
+		}
+
+		m_DirtyFirstCol = firstCol < m_DirtyFirstCol ? firstCol : m_DirtyFirstCol;
+		m_DirtyFirstRow = firstRow < m_DirtyFirstRow ? firstRow : m_DirtyFirstRow;
+		m_DirtyLastCol = lastCol > m_DirtyLastCol ? lastCol : m_DirtyLastCol;
+		m_DirtyLastRow = lastRow > m_DirtyLastRow ? lastRow : m_DirtyLastRow;
+	}
+
+	void EGraphRenderer::UpdateTiles(int tileSize) const
+	{
+		const int tileColumns = (m_MeshColumns + tileSize - 1) / tileSize;
+		const int tileRows = (m_MeshRows + tileSize - 1) / tileSize;
+
+		//a new tile size needs a layer of another size, otherwise only the tiles over edited cells change
+		int firstTileCol = 0, firstTileRow = 0, lastTileCol = tileColumns - 1, lastTileRow = tileRows - 1;
+		if (tileSize != m_TileSize || m_TileLayer == m_NoGridLayer)
+		{
+			if (m_TileLayer != m_NoGridLayer)
+				DEBUGRENDERER2D->DestroyGridLayer(m_TileLayer);
+
+			m_TileLayer = DEBUGRENDERER2D->CreateGridLayer(tileColumns, tileRows);
+			m_TileSize = tileSize;
+			m_TileColumns = tileColumns;
+			m_TileCells.assign(size_t(tileColumns) * tileRows, 0);
+			m_UploadedTilePaletteSize = 0;
+		}
+		else if (m_DirtyLastCol >= 0)
+		{
+			firstTileCol = m_DirtyFirstCol / tileSize;
+			firstTileRow = m_DirtyFirstRow / tileSize;
+			lastTileCol = m_DirtyLastCol / tileSize;
+			lastTileRow = m_DirtyLastRow / tileSize;
+		}
+		else
+		{
+			return;
+		}
+
+		if (m_MeshPalette.size() != m_UploadedTilePaletteSize)
+		{
+			DEBUGRENDERER2D->SetGridLayerPalette(m_TileLayer, m_MeshPalette.data(), int(m_MeshPalette.size()));
+			m_UploadedTilePaletteSize = m_MeshPalette.size();
+		}
+
+		//every tile takes the color most of its cells have
+		int counts[256] = {};
+		for (int tileRow = firstTileRow; tileRow <= lastTileRow; ++tileRow)
+		{
+			for (int tileCol = firstTileCol; tileCol <= lastTileCol; ++tileCol)
+			{
+				const int lastCol = (tileCol + 1) * tileSize < m_MeshColumns ? (tileCol + 1) * tileSize : m_MeshColumns;
+				const int lastRow = (tileRow + 1) * tileSize < m_MeshRows ? (tileRow + 1) * tileSize : m_MeshRows;
+				unsigned char mostCommon = 0;
+				for (int row = tileRow * tileSize; row < lastRow; ++row)
+				{
+					for (int col = tileCol * tileSize; col < lastCol; ++col)
+					{
+						const unsigned char paletteIdx = m_MeshCells[size_t(row) * m_MeshColumns + col];
+						if (++counts[paletteIdx] > counts[mostCommon])
+							mostCommon = paletteIdx;
+					}
+				}
+
+				m_TileCells[size_t(tileRow) * m_TileColumns + tileCol] = mostCommon;
+				for (int row = tileRow * tileSize; row < lastRow; ++row)
+				{
+					for (int col = tileCol * tileSize; col < lastCol; ++col)
+						counts[m_MeshCells[size_t(row) * m_MeshColumns + col]] = 0;
+				}
+			}
+		}
+
+		DEBUGRENDERER2D->UpdateGridLayer(m_TileLayer, firstTileCol, firstTileRow, lastTileCol - firstTileCol + 1, lastTileRow - firstTileRow + 1,
+			&m_TileCells[size_t(firstTileRow) * m_TileColumns + firstTileCol], m_TileColumns);
+		m_DirtyLastCol = -1;
+	}
+
+	bool EGraphRenderer::GetVisibleCells(int columns, int rows, float cellSize, int& firstCol, int& firstRow, int& lastCol, int& lastRow) const
+	{
+		Vector2 lower, upper;
+		DEBUGRENDERER2D->GetActiveCamera()->GetWorldBounds(lower, upper);
+
+		//the grid starts at the origin
+		firstCol = int(floorf(lower.x / cellSize));
+		firstRow = int(floorf(lower.y / cellSize));
+		lastCol = int(floorf(upper.x / cellSize));
+		lastRow = int(floorf(upper.y / cellSize));
+		if (lastCol < 0 || lastRow < 0 || firstCol >= columns || firstRow >= rows)
+			return false;
+
+		firstCol = firstCol > 0 ? firstCol : 0;
+		firstRow = firstRow > 0 ? firstRow : 0;
+		lastCol = lastCol < columns - 1 ? lastCol : columns - 1;
+		lastRow = lastRow < rows - 1 ? lastRow : rows - 1;
+		return true;
 	}
-}
\ No newline at end of file
+}
@@ -12,13 +12,23 @@ namespace Elite
 	{
 	public:
 		EGraphRenderer() = default;
-		~EGraphRenderer() = default;
+		~EGraphRenderer();
 
+		// Only what the active camera sees is drawn. Labels, connections and cell outlines are left out once cells (or nodes) get smaller
+		// on screen than their thresholds, grid cells smaller than the tile threshold are drawn as 2x2, 4x4, ... tiles of their most common color.
 		template<class T_NodeType, class T_ConnectionType>
 		void RenderGraph(Graph2D<T_NodeType, T_ConnectionType>* pGraph, bool renderNodes, bool renderConnections) const;
 
+		// The cells are a retained mesh on the GPU, built on the first call and after that only updated for the cells edited since the last call
 		template<class T_NodeType, class T_ConnectionType>
 		void RenderGraph(GridGraph<T_NodeType, T_ConnectionType>* pGraph, bool renderNodes, bool renderNodeNumbers, bool renderConnections, bool renderConnectionsCosts) const;
+		int GetNrOfUploadedCells() const { return m_NrOfUploadedCells; } // cells sent to the GPU by the last grid render
+
+		// Level of detail thresholds, in pixels per cell (or node diameter) on screen
+		void SetLabelMinPixels(float pixels) { m_LabelMinPixels = pixels; }
+		void SetConnectionMinPixels(float pixels) { m_ConnectionMinPixels = pixels; }
+		void SetOutlineMinPixels(float pixels) { m_OutlineMinPixels = pixels; }
+		void SetTileMinPixels(float pixels) { m_TileMinPixels = pixels; }
 
 		template<class T_NodeType>
 		void RenderHighlighted(std::vector<T_NodeType*> path, Color col = HIGHLIGHTED_NODE_COLOR) const;
@@ -32,6 +42,42 @@ namespace Elite
 		void RenderCircleNode(Vector2 pos, std::string text = "", float radius = 3.0f, Elite::Color col = DEFAULT_NODE_COLOR, float depth = 0.0f) const;
 		
 		void RenderConnection(GraphConnection* con, Elite::Vector2 toPos, Elite::Vector2 fromPos, std::string text, Elite::Color col = DEFAULT_CONNECTION_COLOR, float depth = 0.0f) const;
+
+		// grid mesh helpers
+		template<class T_NodeType, class T_ConnectionType>
+		void UpdateGridMesh(GridGraph<T_NodeType, T_ConnectionType>* pGraph) const;
+		void ResetGridMesh(int columns, int rows) const;
+		unsigned char GetPaletteIndex(const Elite::Color& nodeColor) const;
+		void UploadGridMesh(int firstCol, int firstRow, int lastCol, int lastRow) const;
+		void UpdateTiles(int tileSize) const;
+		// cells of the grid the active camera sees (clamped to the grid), false when it sees none
+		bool GetVisibleCells(int columns, int rows, float cellSize, int& firstCol, int& firstRow, int& lastCol, int& lastRow) const;
+
+		// Grid mesh: a palette index per cell, the palette holds the fill colors of the node colors seen so far.
+		// Rendering is const, the mesh is a cache of the last rendered grid (by graph id, see IGraph::GetGraphId) and its edit stamp.
+		static const unsigned int m_NoGridLayer = 0xFFFFFFFF;
+		mutable unsigned int m_GridLayer = m_NoGridLayer;
+		mutable unsigned int m_MeshGraphId = 0;
+		mutable int m_MeshColumns = 0;
+		mutable int m_MeshRows = 0;
+		mutable unsigned int m_MeshEditStamp = 0;
+		mutable std::vector<unsigned char> m_MeshCells;
+		mutable std::vector<Elite::Color> m_MeshPalette;
+		mutable size_t m_UploadedPaletteSize = 0;
+		mutable int m_NrOfUploadedCells = 0;
+
+		// Tiles: a second layer with one cell per tileSize x tileSize cells of the mesh, cells edited since it was built are kept as one block
+		mutable unsigned int m_TileLayer = m_NoGridLayer;
+		mutable int m_TileSize = 0;
+		mutable int m_TileColumns = 0;
+		mutable std::vector<unsigned char> m_TileCells;
+		mutable size_t m_UploadedTilePaletteSize = 0;
+		mutable int m_DirtyFirstCol = 0, m_DirtyFirstRow = 0, m_DirtyLastCol = -1, m_DirtyLastRow = -1;
+
+		float m_LabelMinPixels = 32.f;
+		float m_ConnectionMinPixels = 8.f;
+		float m_OutlineMinPixels = 4.f;
+		float m_TileMinPixels = 2.f;
 	
 	
 		//C++ make the class non-copyable
@@ -43,100 +89,157 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	void EGraphRenderer::RenderGraph(Graph2D<T_NodeType, T_ConnectionType>* pGraph, bool renderNodes, bool renderConnections) const
 	{
-		for (auto node : pGraph->GetAllNodes())
+		Vector2 lower, upper;
+		const Camera2D* pCamera = DEBUGRENDERER2D->GetActiveCamera();
+		pCamera->GetWorldBounds(lower, upper);
+		const Rect view{ lower, upper.x - lower.x, upper.y - lower.y };
+		const float nodePixels = 2.f * DEFAULT_NODE_RADIUS * pCamera->GetPixelsPerUnit();
+		const bool renderLabels = nodePixels >= m_LabelMinPixels;
+
+		if (renderNodes)
 		{
-			if (node->GetIndex() == invalid_node_index)
-				continue;
+			//Nodes, as points once they're too small to make out a circle
+			pGraph->ForEachNodeInArea(view, [this, pGraph, renderLabels, nodePixels](int idx)
+				{
+					T_NodeType* pNode = pGraph->GetNode(idx);
+					if (nodePixels < m_TileMinPixels)
+						DEBUGRENDERER2D->DrawPoint(pGraph->GetNodePos(pNode), m_TileMinPixels, pNode->GetColor(), 0.0f);
+					else
+						RenderCircleNode(pGraph->GetNodePos(pNode), renderLabels ? std::to_string(idx) : "", DEFAULT_NODE_RADIUS, pNode->GetColor());
+				});
+		}
 
-			if (renderNodes)
-			{
-				//Node
-				RenderCircleNode(
-					pGraph->GetNodePos(node),
-					std::to_string(node->GetIndex()),
-					3.0f, 
-					node->GetColor()
-				);
-			}
-		
-			if (renderConnections)
-			{
-				//Connections
-				for (auto con : pGraph->GetNodeConnections(node->GetIndex()))
+		if (renderConnections && nodePixels >= m_ConnectionMinPixels)
+		{
+			//Connections
+			pGraph->ForEachConnectionInArea(view, [this, pGraph, renderLabels](int from, int to)
 				{
-					std::stringstream ss;
-					ss << std::fixed << std::setprecision(1) << con->GetCost();
-
-					RenderConnection(con,
-						pGraph->GetNodePos(con->GetTo()),
-						pGraph->GetNodePos(con->GetFrom()),
-						ss.str()
-					);
-				}
-			}
+					auto con = pGraph->GetConnection(from, to);
+					std::string text{};
+					if (renderLabels)
+					{
+						std::stringstream ss;
+						ss << std::fixed << std::setprecision(1) << con->GetCost();
+						text = ss.str();
+					}
+
+					RenderConnection(con, pGraph->GetNodePos(to), pGraph->GetNodePos(from), text);
+				});
 		}
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
 	void EGraphRenderer::RenderGraph(GridGraph<T_NodeType, T_ConnectionType>* pGraph, bool renderNodes, bool renderNodeNumbers, bool renderConnections, bool renderConnectionsCosts) const
 	{
+		m_NrOfUploadedCells = 0;
+		const float cellSize = float(pGraph->m_CellSize);
+		const float cellPixels = cellSize * DEBUGRENDERER2D->GetActiveCamera()->GetPixelsPerUnit();
+		int firstCol, firstRow, lastCol, lastRow;
+		const bool isVisible = GetVisibleCells(pGraph->GetColumns(), pGraph->GetRows(), cellSize, firstCol, firstRow, lastCol, lastRow);
+
 		if (renderNodes)
 		{
-			//Nodes/Grid
-			for (auto r = 0; r < pGraph->m_NrOfRows; ++r)
+			//Nodes/Grid, one quad for the whole grid (or its tiles when cells are too small to see)
+			UpdateGridMesh(pGraph);
+			if (cellPixels < m_TileMinPixels)
 			{
-				for (auto c = 0; c < pGraph->m_NrOfColumns; ++c)
-				{
-					int idx = r * pGraph->m_NrOfColumns + c;
-					Vector2 cellPos{ pGraph->GetNodeWorldPos(idx) };
-
-					int cellSize = pGraph->m_CellSize;
-					Vector2 verts[4]
-					{
-						Vector2(cellPos.x - cellSize / 2.0f, cellPos.y - cellSize / 2.0f),
-						Vector2(cellPos.x - cellSize / 2.0f, cellPos.y + cellSize / 2.0f),
-						Vector2(cellPos.x + cellSize / 2.0f, cellPos.y + cellSize / 2.0f),
-						Vector2(cellPos.x + cellSize / 2.0f, cellPos.y - cellSize / 2.0f)
-					};
+				int tileSize = 2;
+				while (cellPixels * tileSize < m_TileMinPixels)
+					tileSize *= 2;
 
-					//Grid
-					DEBUGRENDERER2D->DrawPolygon(&verts[0], 4, DEFAULT_NODE_COLOR, 0.0f);
+				UpdateTiles(tileSize);
+				DEBUGRENDERER2D->DrawGridLayer(m_TileLayer, ZeroVector2, cellSize * tileSize, DEFAULT_NODE_COLOR, 0.0f, 0.1f);
+			}
+			else
+			{
+				DEBUGRENDERER2D->DrawGridLayer(m_GridLayer, ZeroVector2, cellSize, DEFAULT_NODE_COLOR, cellPixels >= m_OutlineMinPixels ? 1.0f : 0.0f, 0.1f);
+			}
 
-					//Node
-					std::string text{};
-					if (renderNodeNumbers)
-					{
-						text = to_string(idx);
-					}
-					RenderRectNode(cellPos, text, float(cellSize), pGraph->GetNodeColor(pGraph->GetNode(idx)), 0.1f);
+			if (renderNodeNumbers && isVisible && cellPixels >= m_LabelMinPixels)
+			{
+				const auto stringOffset = Vector2{ -0.5f, 1.f };
+				for (int row = firstRow; row <= lastRow; ++row)
+				{
+					for (int col = firstCol; col <= lastCol; ++col)
+						DEBUGRENDERER2D->DrawString(pGraph->GetNodeWorldPos(col, row) + stringOffset, to_string(pGraph->GetIndex(col, row)).c_str());
 				}
 			}
 		}
 
-		if (renderConnections)
+		if (renderConnections && isVisible && cellPixels >= m_ConnectionMinPixels)
 		{
-			for (auto node : pGraph->GetAllNodes())
+			//Connections of the visible cells and the ring around them, both ends of a connection that crosses the view are in there
+			firstCol = firstCol > 0 ? firstCol - 1 : 0;
+			firstRow = firstRow > 0 ? firstRow - 1 : 0;
+			lastCol = lastCol < pGraph->GetColumns() - 1 ? lastCol + 1 : lastCol;
+			lastRow = lastRow < pGraph->GetRows() - 1 ? lastRow + 1 : lastRow;
+			for (int row = firstRow; row <= lastRow; ++row)
 			{
-				//Connections
-				for (auto con : pGraph->GetNodeConnections(node->GetIndex()))
+				for (int col = firstCol; col <= lastCol; ++col)
 				{
-					std::string text{ };
-					if (renderConnectionsCosts)
+					const int idx = pGraph->GetIndex(col, row);
+					for (auto con : pGraph->GetNodeConnections(idx))
 					{
-						std::stringstream ss;
-						ss << std::fixed << std::setprecision(1) << con->GetCost();
-						text = ss.str();
+						//undirected connections are drawn once
+						if (!pGraph->IsDirectionalGraph() && con->GetTo() < idx)
+							continue;
+
+						std::string text{ };
+						if (renderConnectionsCosts && cellPixels >= m_LabelMinPixels)
+						{
+							std::stringstream ss;
+							ss << std::fixed << std::setprecision(1) << con->GetCost();
+							text = ss.str();
+						}
+						RenderConnection(con,
+							pGraph->GetNodeWorldPos(con->GetTo()),
+							pGraph->GetNodeWorldPos(con->GetFrom()),
+							text
+						);
 					}
-					RenderConnection(con,
-						pGraph->GetNodeWorldPos(con->GetTo()),
-						pGraph->GetNodeWorldPos(con->GetFrom()),
-						text
-					);
 				}
 			}
 		}
 	}
 
+	template<class T_NodeType, class T_ConnectionType>
+	void EGraphRenderer::UpdateGridMesh(GridGraph<T_NodeType, T_ConnectionType>* pGraph) const
+	{
+		// a new graph, a graph that was rebuilt or more edits than the graph remembers: build the whole mesh again
+		std::vector<int> editedNodes;
+		if (m_GridLayer == m_NoGridLayer || m_MeshGraphId != pGraph->GetGraphId()
+			|| m_MeshColumns != pGraph->GetColumns() || m_MeshRows != pGraph->GetRows()
+			|| pGraph->GetEditStamp() < m_MeshEditStamp || !pGraph->GetEditedNodesSince(m_MeshEditStamp, editedNodes))
+		{
+			ResetGridMesh(pGraph->GetColumns(), pGraph->GetRows());
+			for (int idx = 0; idx < pGraph->GetNrOfNodes(); ++idx)
+				m_MeshCells[idx] = GetPaletteIndex(pGraph->GetNodeColor(pGraph->GetNode(idx)));
+
+			UploadGridMesh(0, 0, m_MeshColumns - 1, m_MeshRows - 1);
+		}
+		else if (!editedNodes.empty())
+		{
+			// one block around all edited cells, edits from the editor come one or a few at a time
+			int firstCol = m_MeshColumns, firstRow = m_MeshRows, lastCol = -1, lastRow = -1;
+			for (int idx : editedNodes)
+			{
+				m_MeshCells[idx] = GetPaletteIndex(pGraph->GetNodeColor(pGraph->GetNode(idx)));
+
+				const int col = idx % m_MeshColumns;
+				const int row = idx / m_MeshColumns;
+				firstCol = col < firstCol ? col : firstCol;
+				firstRow = row < firstRow ? row : firstRow;
+				lastCol = col > lastCol ? col : lastCol;
+				lastRow = row > lastRow ? row : lastRow;
+			}
+
+			UploadGridMesh(firstCol, firstRow, lastCol, lastRow);
+		}
+
+		m_MeshGraphId = pGraph->GetGraphId();
+		m_MeshEditStamp = pGraph->GetEditStamp();
+	}
+
 	template<class T_NodeType>
 	void EGraphRenderer::RenderHighlighted(std::vector<T_NodeType*> path, Color col /*= HIGHLIGHTED_NODE_COLOR*/) const
 	{
@@ -0,0 +1,596 @@
+#include "stdafx.h"
+#include "ENavMesh.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EIndexedOpenList.h"
+
+Elite::NavMesh::NavMesh(const Polygon& polygon)
+{
+	Build(polygon);
+}
+
+void Elite::NavMesh::Build(const Polygon& polygon)
+{
+	std::vector<Vector2> outerShape(polygon.GetPoints().begin(), polygon.GetPoints().end());
+	std::vector<std::vector<Vector2>> holes;
+	for (const Polygon& child : polygon.GetChildren())
+		holes.push_back(std::vector<Vector2>(child.GetPoints().begin(), child.GetPoints().end()));
+
+	Build(outerShape, holes);
+}
+
+void Elite::NavMesh::Build(const std::vector<Vector2>& outerShape, const std::vector<std::vector<Vector2>>& holes)
+{
+	m_Vertices.clear();
+	m_Indices.clear();
+	m_Neighbours.clear();
+	m_NextVertices.clear();
+	m_PrevVertices.clear();
+
+	//Store all rings with the walkable area on their left: the outer shape counter clockwise, holes clockwise
+	auto addRing = [this](const std::vector<Vector2>& ring, bool isHole)
+	{
+		const int count = static_cast<int>(ring.size());
+		if (count < 3)
+			return;
+
+		float doubleArea = 0.f;
+		for (int i = 0; i < count; ++i)
+			doubleArea += Cross(ring[i], ring[(i + 1) % count]);
+		const bool isReversed = (doubleArea > 0.f) == isHole;
+
+		const int firstIdx = static_cast<int>(m_Vertices.size());
+		for (int i = 0; i < count; ++i)
+		{
+			m_Vertices.push_back(isReversed ? ring[count - 1 - i] : ring[i]);
+			m_NextVertices.push_back(firstIdx + (i + 1) % count);
+			m_PrevVertices.push_back(firstIdx + (i + count - 1) % count);
+		}
+	};
+
+	addRing(outerShape, false);
+	for (const std::vector<Vector2>& hole : holes)
+		addRing(hole, true);
+
+	std::vector<std::pair<int, int>> diagonals;
+	PartitionMonotone(diagonals);
+
+	//Half edges of the rings and both sides of every diagonal, the pieces are the loops they form
+	const int nrOfVertices = static_cast<int>(m_Vertices.size());
+	std::vector<int> halfEdgeFrom;
+	std::vector<int> halfEdgeTo;
+	std::vector<std::vector<int>> outgoingHalfEdges(nrOfVertices);
+	auto addHalfEdge = [&](int fromIdx, int toIdx)
+	{
+		outgoingHalfEdges[fromIdx].push_back(static_cast<int>(halfEdgeFrom.size()));
+		halfEdgeFrom.push_back(fromIdx);
+		halfEdgeTo.push_back(toIdx);
+	};
+
+	for (int idx = 0; idx < nrOfVertices; ++idx)
+		addHalfEdge(idx, m_NextVertices[idx]);
+	for (const std::pair<int, int>& diagonal : diagonals)
+	{
+		addHalfEdge(diagonal.first, diagonal.second);
+		addHalfEdge(diagonal.second, diagonal.first);
+	}
+
+	//The piece left of (u, v) continues along the first edge out of v clockwise from (v, u)
+	auto getNextHalfEdge = [&](int halfEdge)
+	{
+		const int fromIdx = halfEdgeFrom[halfEdge];
+		const int idx = halfEdgeTo[halfEdge];
+		const Vector2 back = m_Vertices[fromIdx] - m_Vertices[idx];
+		const float backAngle = atan2f(back.y, back.x);
+
+		int nextHalfEdge = invalid_node_index;
+		float smallestAngle = std::numeric_limits<float>::infinity();
+		for (int outgoingHalfEdge : outgoingHalfEdges[idx])
+		{
+			const Vector2 direction = m_Vertices[halfEdgeTo[outgoingHalfEdge]] - m_Vertices[idx];
+			float angle = backAngle - atan2f(direction.y, direction.x);
+			while (angle <= 0.f)
+				angle += 2.f * static_cast<float>(M_PI);
+			while (angle > 2.f * static_cast<float>(M_PI))
+				angle -= 2.f * static_cast<float>(M_PI);
+
+			if (angle < smallestAngle)
+			{
+				smallestAngle = angle;
+				nextHalfEdge = outgoingHalfEdge;
+			}
+		}
+		return nextHalfEdge;
+	};
+
+	std::vector<bool> isHalfEdgeUsed(halfEdgeFrom.size(), false);
+	std::vector<bool> isOnLeftChain(nrOfVertices, false);
+	std::vector<int> piece;
+	for (int halfEdge = 0; halfEdge < static_cast<int>(halfEdgeFrom.size()); ++halfEdge)
+	{
+		if (isHalfEdgeUsed[halfEdge])
+			continue;
+
+		piece.clear();
+		for (int current = halfEdge; !isHalfEdgeUsed[current]; current = getNextHalfEdge(current))
+		{
+			isHalfEdgeUsed[current] = true;
+			piece.push_back(halfEdgeFrom[current]);
+		}
+		TriangulateMonotone(piece, isOnLeftChain);
+	}
+
+	BuildAdjacency();
+	MakeDelaunay();
+	m_TriangleBVH.Build(m_Vertices, m_Indices);
+
+	m_NextVertices = std::vector<int>();
+	m_PrevVertices = std::vector<int>();
+}
+
+int Elite::NavMesh::GetTriangleIdxAtPosition(const Vector2& pos) const
+{
+	const int triangleIdx = m_TriangleBVH.GetTriangleIdxAtPosition(pos);
+	return triangleIdx == -1 ? invalid_node_index : triangleIdx;
+}
+
+std::vector<Elite::Vector2> Elite::NavMesh::FindPath(const Vector2& startPos, const Vector2& goalPos)
+{
+	const int startTriangleIdx = GetTriangleIdxAtPosition(startPos);
+	const int goalTriangleIdx = GetTriangleIdxAtPosition(goalPos);
+	if (startTriangleIdx == invalid_node_index || goalTriangleIdx == invalid_node_index)
+		return {};
+
+	const std::vector<int> corridor = FindCorridor(startTriangleIdx, goalTriangleIdx, startPos, goalPos);
+	if (corridor.empty())
+		return {};
+
+	std::vector<Portal> portals{ { startPos, startPos } };
+	for (size_t i = 0; i + 1 < corridor.size(); ++i)
+	{
+		const int triangleIdx = corridor[i];
+		for (int edge = 0; edge < 3; ++edge)
+		{
+			if (m_Neighbours[triangleIdx * 3 + edge] != corridor[i + 1])
+				continue;
+
+			//looking out of a counter clockwise triangle, the end of the edge is on the left
+			portals.push_back({ m_Vertices[m_Indices[triangleIdx * 3 + (edge + 1) % 3]], m_Vertices[m_Indices[triangleIdx * 3 + edge]] });
+			break;
+		}
+	}
+	portals.push_back({ goalPos, goalPos });
+
+	return PullString(portals);
+}
+
+Elite::Vector2 Elite::NavMesh::GetTriangleCenter(int triangleIdx) const
+{
+	return (m_Vertices[m_Indices[triangleIdx * 3]] + m_Vertices[m_Indices[triangleIdx * 3 + 1]] + m_Vertices[m_Indices[triangleIdx * 3 + 2]]) / 3.f;
+}
+
+size_t Elite::NavMesh::GetMemoryUsage() const
+{
+	return sizeof(*this)
+		+ m_Vertices.capacity() * sizeof(Vector2)
+		+ (m_Indices.capacity() + m_Neighbours.capacity()) * sizeof(int)
+		+ m_TriangleBVH.GetMemoryUsage();
+}
+
+//=== Triangulation ===
+bool Elite::NavMesh::IsAbove(int vertexIdx, int otherVertexIdx) const
+{
+	//on the same height the left vertex goes first, as if the sweep line is tilted a little
+	const Vector2& pos = m_Vertices[vertexIdx];
+	const Vector2& otherPos = m_Vertices[otherVertexIdx];
+	return pos.y > otherPos.y || (pos.y == otherPos.y && pos.x < otherPos.x);
+}
+
+float Elite::NavMesh::GetSweepX(int edge) const
+{
+	const Vector2& from = m_Vertices[edge];
+	const Vector2& to = m_Vertices[m_NextVertices[edge]];
+	if (from.y == to.y)
+		return Clamp(m_SweepPos.x, from.x < to.x ? from.x : to.x, from.x < to.x ? to.x : from.x);
+
+	return from.x + (m_SweepPos.y - from.y) / (to.y - from.y) * (to.x - from.x);
+}
+
+void Elite::NavMesh::PartitionMonotone(std::vector<std::pair<int, int>>& diagonals)
+{
+	//Sweep from top to bottom, adding a diagonal up from every split vertex and down from every merge vertex
+	//(de Berg et al., Computational Geometry, chapter 3). Edge i runs from vertex i to the next vertex.
+	const int nrOfVertices = static_cast<int>(m_Vertices.size());
+	std::vector<int> sortedVertices(nrOfVertices);
+	for (int idx = 0; idx < nrOfVertices; ++idx)
+		sortedVertices[idx] = idx;
+	std::sort(sortedVertices.begin(), sortedVertices.end(), [this](int idx, int otherIdx) { return IsAbove(idx, otherIdx); });
+
+	std::set<int, EdgeOrder> status(EdgeOrder{ this });
+	std::vector<std::set<int, EdgeOrder>::iterator> statusPositions(nrOfVertices, status.end());
+	std::vector<int> helpers(nrOfVertices, invalid_node_index); // lowest vertex above the sweep line between the edge and the next edge to its right
+	std::vector<bool> isMergeVertex(nrOfVertices, false);
+
+	auto getLeftEdge = [&](int idx)
+	{
+		auto it = status.upper_bound(m_Vertices[idx].x);
+		assert(it != status.begin() && "<NavMesh::PartitionMonotone>: no edge left of a vertex, rings overlap or touch");
+		return *--it;
+	};
+	auto connectHelper = [&](int idx, int edge)
+	{
+		if (isMergeVertex[helpers[edge]])
+			diagonals.push_back({ idx, helpers[edge] });
+	};
+
+	for (int idx : sortedVertices)
+	{
+		m_SweepPos = m_Vertices[idx];
+		const int prevIdx = m_PrevVertices[idx];
+		const int nextIdx = m_NextVertices[idx];
+		const bool isPrevBelow = IsAbove(idx, prevIdx);
+		const bool isNextBelow = IsAbove(idx, nextIdx);
+		const bool isConvex = Cross(m_Vertices[idx] - m_Vertices[prevIdx], m_Vertices[nextIdx] - m_Vertices[idx]) > 0.f;
+
+		if (isPrevBelow && isNextBelow)
+		{
+			//split vertex: connect to the helper of the edge on its left
+			if (!isConvex)
+			{
+				const int leftEdge = getLeftEdge(idx);
+				diagonals.push_back({ idx, helpers[leftEdge] });
+				helpers[leftEdge] = idx;
+			}
+
+			statusPositions[idx] = status.insert(idx).first;
+			helpers[idx] = idx;
+		}
+		else if (!isPrevBelow && !isNextBelow)
+		{
+			//end or merge vertex
+			connectHelper(idx, prevIdx);
+			status.erase(statusPositions[prevIdx]);
+
+			if (!isConvex)
+			{
+				isMergeVertex[idx] = true;
+				const int leftEdge = getLeftEdge(idx);
+				connectHelper(idx, leftEdge);
+				helpers[leftEdge] = idx;
+			}
+		}
+		else if (isNextBelow)
+		{
+			//regular vertex with the walkable area on its right
+			connectHelper(idx, prevIdx);
+			status.erase(statusPositions[prevIdx]);
+			statusPositions[idx] = status.insert(idx).first;
+			helpers[idx] = idx;
+		}
+		else
+		{
+			//regular vertex with the walkable area on its left
+			const int leftEdge = getLeftEdge(idx);
+			connectHelper(idx, leftEdge);
+			helpers[leftEdge] = idx;
+		}
+	}
+}
+
+void Elite::NavMesh::TriangulateMonotone(const std::vector<int>& piece, std::vector<bool>& isOnLeftChain)
+{
+	//piece is counter clockwise, from the top vertex it runs down the left chain and back up the right chain
+	const int count = static_cast<int>(piece.size());
+	if (count < 3)
+		return;
+
+	int topPosition = 0;
+	int bottomPosition = 0;
+	for (int position = 1; position < count; ++position)
+	{
+		if (IsAbove(piece[position], piece[topPosition]))
+			topPosition = position;
+		if (IsAbove(piece[bottomPosition], piece[position]))
+			bottomPosition = position;
+	}
+
+	for (int position = (topPosition + 1) % count; position != bottomPosition; position = (position + 1) % count)
+		isOnLeftChain[piece[position]] = true;
+
+	std::vector<int> sortedVertices = piece;
+	std::sort(sortedVertices.begin(), sortedVertices.end(), [this](int idx, int otherIdx) { return IsAbove(idx, otherIdx); });
+
+	std::vector<int> stack{ sortedVertices[0], sortedVertices[1] };
+	for (int i = 2; i < count - 1; ++i)
+	{
+		const int idx = sortedVertices[i];
+		if (isOnLeftChain[idx] != isOnLeftChain[stack.back()])
+		{
+			//other chain: fan out to everything on the stack
+			while (stack.size() > 1)
+			{
+				const int stackIdx = stack.back();
+				stack.pop_back();
+				AddTriangle(idx, stackIdx, stack.back());
+			}
+			stack.clear();
+			stack.push_back(sortedVertices[i - 1]);
+			stack.push_back(idx);
+		}
+		else
+		{
+			//same chain: cut off the convex corners
+			int lastIdx = stack.back();
+			stack.pop_back();
+			while (!stack.empty())
+			{
+				const int otherIdx = stack.back();
+				const float turn = isOnLeftChain[idx]
+					? Cross(m_Vertices[lastIdx] - m_Vertices[otherIdx], m_Vertices[idx] - m_Vertices[lastIdx])
+					: Cross(m_Vertices[lastIdx] - m_Vertices[idx], m_Vertices[otherIdx] - m_Vertices[lastIdx]);
+				if (turn <= 0.f)
+					break;
+
+				AddTriangle(idx, lastIdx, otherIdx);
+				lastIdx = otherIdx;
+				stack.pop_back();
+			}
+			stack.push_back(lastIdx);
+			stack.push_back(idx);
+		}
+	}
+
+	const int bottomIdx = sortedVertices[count - 1];
+	while (stack.size() > 1)
+	{
+		const int stackIdx = stack.back();
+		stack.pop_back();
+		AddTriangle(bottomIdx, stackIdx, stack.back());
+	}
+
+	for (int idx : piece)
+		isOnLeftChain[idx] = false;
+}
+
+void Elite::NavMesh::AddTriangle(int vertexIdx1, int vertexIdx2, int vertexIdx3)
+{
+	const bool isClockwise = Cross(m_Vertices[vertexIdx2] - m_Vertices[vertexIdx1], m_Vertices[vertexIdx3] - m_Vertices[vertexIdx1]) < 0.f;
+	m_Indices.push_back(vertexIdx1);
+	m_Indices.push_back(isClockwise ? vertexIdx3 : vertexIdx2);
+	m_Indices.push_back(isClockwise ? vertexIdx2 : vertexIdx3);
+}
+
+void Elite::NavMesh::BuildAdjacency()
+{
+	//Neighbouring counter clockwise triangles share an edge in opposite directions
+	m_Neighbours.assign(m_Indices.size(), invalid_node_index);
+
+	std::unordered_map<unsigned long long, int> openEdges;
+	openEdges.reserve(m_Indices.size());
+	auto getKey = [](int fromIdx, int toIdx) { return static_cast<unsigned long long>(fromIdx) << 32 | static_cast<unsigned int>(toIdx); };
+
+	for (int corner = 0; corner < static_cast<int>(m_Indices.size()); ++corner)
+	{
+		const int fromIdx = m_Indices[corner];
+		const int toIdx = m_Indices[corner - corner % 3 + (corner + 1) % 3];
+
+		auto foundIt = openEdges.find(getKey(toIdx, fromIdx));
+		if (foundIt == openEdges.end())
+		{
+			openEdges.insert({ getKey(fromIdx, toIdx), corner });
+			continue;
+		}
+
+		m_Neighbours[corner] = foundIt->second / 3;
+		m_Neighbours[foundIt->second] = corner / 3;
+		openEdges.erase(foundIt);
+	}
+}
+
+void Elite::NavMesh::MakeDelaunay()
+{
+	//Lawson flips: an edge between two triangles is swapped for the other diagonal of their quad when the far corner of one
+	//lies inside the circumcircle of the other. Ring edges are on the border, so every shared edge may flip.
+	//Monotone pieces tend to fan out into long slivers, Delaunay triangles keep the middles of their edges close to the real paths.
+	auto isInCircumcircle = [this](int idx1, int idx2, int idx3, int idx)
+	{
+		const Vector2& pos = m_Vertices[idx];
+		const double ax = m_Vertices[idx1].x - pos.x, ay = m_Vertices[idx1].y - pos.y;
+		const double bx = m_Vertices[idx2].x - pos.x, by = m_Vertices[idx2].y - pos.y;
+		const double cx = m_Vertices[idx3].x - pos.x, cy = m_Vertices[idx3].y - pos.y;
+		const double determinant = (ax * ax + ay * ay) * (bx * cy - cx * by)
+			- (bx * bx + by * by) * (ax * cy - cx * ay)
+			+ (cx * cx + cy * cy) * (ax * by - bx * ay);
+		return determinant > 1e-9;
+	};
+	auto isCounterClockwise = [this](int idx1, int idx2, int idx3)
+	{
+		return Cross(m_Vertices[idx2] - m_Vertices[idx1], m_Vertices[idx3] - m_Vertices[idx1]) > 0.f;
+	};
+	auto replaceNeighbour = [this](int triangleIdx, int oldNeighbourIdx, int newNeighbourIdx)
+	{
+		if (triangleIdx == invalid_node_index)
+			return;
+
+		for (int corner = triangleIdx * 3; corner < triangleIdx * 3 + 3; ++corner)
+		{
+			if (m_Neighbours[corner] == oldNeighbourIdx)
+				m_Neighbours[corner] = newNeighbourIdx;
+		}
+	};
+
+	std::vector<int> cornersToCheck(m_Indices.size());
+	for (int corner = 0; corner < static_cast<int>(m_Indices.size()); ++corner)
+		cornersToCheck[corner] = corner;
+
+	while (!cornersToCheck.empty())
+	{
+		const int corner = cornersToCheck.back();
+		cornersToCheck.pop_back();
+
+		const int triangleIdx = corner / 3;
+		const int otherTriangleIdx = m_Neighbours[corner];
+		if (otherTriangleIdx == invalid_node_index)
+			continue;
+
+		//this triangle is (a, b, p) with the edge (a, b), the other one (b, a, q)
+		const int edge = corner % 3;
+		const int a = m_Indices[corner];
+		const int b = m_Indices[triangleIdx * 3 + (edge + 1) % 3];
+		const int p = m_Indices[triangleIdx * 3 + (edge + 2) % 3];
+		int otherEdge = 0;
+		while (m_Indices[otherTriangleIdx * 3 + otherEdge] != b)
+			++otherEdge;
+		const int q = m_Indices[otherTriangleIdx * 3 + (otherEdge + 2) % 3];
+
+		if (!isInCircumcircle(a, b, p, q) || !isCounterClockwise(a, q, p) || !isCounterClockwise(q, b, p))
+			continue;
+
+		const int neighbourBP = m_Neighbours[triangleIdx * 3 + (edge + 1) % 3];
+		const int neighbourPA = m_Neighbours[triangleIdx * 3 + (edge + 2) % 3];
+		const int neighbourAQ = m_Neighbours[otherTriangleIdx * 3 + (otherEdge + 1) % 3];
+		const int neighbourQB = m_Neighbours[otherTriangleIdx * 3 + (otherEdge + 2) % 3];
+
+		//(a, q, p) and (q, b, p) share the new edge (q, p)
+		m_Indices[triangleIdx * 3] = a;
+		m_Indices[triangleIdx * 3 + 1] = q;
+		m_Indices[triangleIdx * 3 + 2] = p;
+		m_Neighbours[triangleIdx * 3] = neighbourAQ;
+		m_Neighbours[triangleIdx * 3 + 1] = otherTriangleIdx;
+		m_Neighbours[triangleIdx * 3 + 2] = neighbourPA;
+
+		m_Indices[otherTriangleIdx * 3] = q;
+		m_Indices[otherTriangleIdx * 3 + 1] = b;
+		m_Indices[otherTriangleIdx * 3 + 2] = p;
+		m_Neighbours[otherTriangleIdx * 3] = neighbourQB;
+		m_Neighbours[otherTriangleIdx * 3 + 1] = neighbourBP;
+		m_Neighbours[otherTriangleIdx * 3 + 2] = triangleIdx;
+
+		replaceNeighbour(neighbourAQ, otherTriangleIdx, triangleIdx);
+		replaceNeighbour(neighbourBP, triangleIdx, otherTriangleIdx);
+
+		cornersToCheck.push_back(triangleIdx * 3);
+		cornersToCheck.push_back(triangleIdx * 3 + 2);
+		cornersToCheck.push_back(otherTriangleIdx * 3);
+		cornersToCheck.push_back(otherTriangleIdx * 3 + 1);
+	}
+}
+
+//=== Queries ===
+std::vector<int> Elite::NavMesh::FindCorridor(int startTriangleIdx, int goalTriangleIdx, const Vector2& startPos, const Vector2& goalPos)
+{
+	//A* over the triangles, a triangle's position is where the path enters it: the middle of the edge it crossed
+	const int nrOfTriangles = GetNrOfTriangles();
+	IndexedOpenList openList(OpenList::binaryHeap, 0.f);
+	std::vector<float> costsSoFar(nrOfTriangles, std::numeric_limits<float>::infinity());
+	std::vector<int> parents(nrOfTriangles, invalid_node_index);
+	std::vector<Vector2> entryPositions(nrOfTriangles);
+
+	m_NrOfExpandedTriangles = 0;
+	costsSoFar[startTriangleIdx] = 0.f;
+	entryPositions[startTriangleIdx] = startPos;
+	openList.Push(startTriangleIdx, 0.f, Distance(startPos, goalPos));
+
+	while (!openList.IsEmpty())
+	{
+		IndexedOpenList::Entry current = openList.Pop();
+
+		//a cheaper way to this triangle was pushed after this entry
+		if (current.costSoFar > costsSoFar[current.idx])
+			continue;
+
+		++m_NrOfExpandedTriangles;
+		if (current.idx == goalTriangleIdx)
+			break;
+
+		for (int edge = 0; edge < 3; ++edge)
+		{
+			const int neighbourIdx = m_Neighbours[current.idx * 3 + edge];
+			if (neighbourIdx == invalid_node_index)
+				continue;
+
+			const Vector2 entryPos = (m_Vertices[m_Indices[current.idx * 3 + edge]] + m_Vertices[m_Indices[current.idx * 3 + (edge + 1) % 3]]) / 2.f;
+			const float costSoFar = current.costSoFar + Distance(entryPositions[current.idx], entryPos);
+			if (costSoFar < costsSoFar[neighbourIdx])
+			{
+				costsSoFar[neighbourIdx] = costSoFar;
+				parents[neighbourIdx] = current.idx;
+				entryPositions[neighbourIdx] = entryPos;
+				openList.Push(neighbourIdx, costSoFar, Distance(entryPos, goalPos));
+			}
+		}
+	}
+
+	std::vector<int> corridor;
+	if (costsSoFar[goalTriangleIdx] == std::numeric_limits<float>::infinity())
+		return corridor;
+
+	for (int triangleIdx = goalTriangleIdx; triangleIdx != invalid_node_index; triangleIdx = parents[triangleIdx])
+		corridor.push_back(triangleIdx);
+	std::reverse(corridor.begin(), corridor.end());
+
+	return corridor;
+}
+
+std::vector<Elite::Vector2> Elite::NavMesh::PullString(const std::vector<Portal>& portals) const
+{
+	//Simple stupid funnel algorithm (Mononen): narrow the funnel portal by portal, when one side crosses over the other
+	//the other side's point is a corner of the path and the funnel restarts from there
+	auto getArea = [](const Vector2& apex, const Vector2& from, const Vector2& to) { return Cross(to - apex, from - apex); };
+
+	std::vector<Vector2> path{ portals.front().left };
+	Vector2 apex = portals.front().left;
+	Vector2 left = portals.front().left;
+	Vector2 right = portals.front().right;
+	int apexIdx = 0;
+	int leftIdx = 0;
+	int rightIdx = 0;
+
+	for (int i = 1; i < static_cast<int>(portals.size()); ++i)
+	{
+		const Portal& portal = portals[i];
+
+		//narrow the right side
+		if (getArea(apex, right, portal.right) <= 0.f)
+		{
+			if (apex == right || getArea(apex, left, portal.right) > 0.f)
+			{
+				right = portal.right;
+				rightIdx = i;
+			}
+			else
+			{
+				path.push_back(left);
+				apex = left;
+				apexIdx = leftIdx;
+				right = apex;
+				rightIdx = apexIdx;
+				i = apexIdx;
+				continue;
+			}
+		}
+
+		//narrow the left side
+		if (getArea(apex, left, portal.left) >= 0.f)
+		{
+			if (apex == left || getArea(apex, right, portal.left) < 0.f)
+			{
+				left = portal.left;
+				leftIdx = i;
+			}
+			else
+			{
+				path.push_back(right);
+				apex = right;
+				apexIdx = rightIdx;
+				left = apex;
+				leftIdx = apexIdx;
+				i = apexIdx;
+				continue;
+			}
+		}
+	}
+
+	if (path.back() != portals.back().left)
+		path.push_back(portals.back().left);
+
+	return path;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <set>
+#include "framework/EliteGeometry/EGeometry2DTypes.h"
+#include "framework/EliteAI/EliteGraphs/EGraphEnums.h"
+
+namespace Elite
+{
+	// Navigation mesh over the walkable area of a polygon with holes (the polygon's children).
+	// The area is split into y-monotone pieces with a sweep line and every piece is triangulated in one pass, O(n log n) in total,
+	// where Polygon::Triangulate clips ears one at a time.
+	// Triangles are kept in flat buffers: three vertex indices per triangle, counter clockwise, and per edge the triangle on the
+	// other side. Edge i of a triangle runs from its vertex i to vertex i + 1.
+	// Paths are found with A* over the triangles and pulled tight with the funnel algorithm.
+	class NavMesh final
+	{
+	public:
+		NavMesh() = default;
+		explicit NavMesh(const Polygon& polygon);
+
+		// The outer shape and holes can have any winding. They have to be simple and can't touch or overlap each other.
+		void Build(const Polygon& polygon);
+		void Build(const std::vector<Vector2>& outerShape, const std::vector<std::vector<Vector2>>& holes);
+
+		// invalid_node_index when the position is outside the mesh
+		int GetTriangleIdxAtPosition(const Vector2& pos) const;
+		// corners of the shortest path through the mesh, from start to goal. Empty when a point is outside the mesh or can't be reached.
+		std::vector<Vector2> FindPath(const Vector2& startPos, const Vector2& goalPos);
+
+		int GetNrOfTriangles() const { return static_cast<int>(m_Indices.size() / 3); }
+		const std::vector<Vector2>& GetVertices() const { return m_Vertices; }
+		const std::vector<int>& GetIndices() const { return m_Indices; }
+		const std::vector<int>& GetNeighbours() const { return m_Neighbours; }
+		Vector2 GetTriangleCenter(int triangleIdx) const;
+
+		int GetNrOfExpandedTriangles() const { return m_NrOfExpandedTriangles; }
+		size_t GetMemoryUsage() const; // approximate, in bytes
+
+	private:
+		struct Portal
+		{
+			Vector2 left;
+			Vector2 right;
+		};
+
+		// sweep line status: edges with the walkable area on their right, ordered left to right where they cross the sweep line
+		struct EdgeOrder
+		{
+			using is_transparent = void;
+
+			bool operator()(int edge, int otherEdge) const { return pNavMesh->GetSweepX(edge) < pNavMesh->GetSweepX(otherEdge); }
+			bool operator()(int edge, float x) const { return pNavMesh->GetSweepX(edge) < x; }
+			bool operator()(float x, int edge) const { return x < pNavMesh->GetSweepX(edge); }
+
+			const NavMesh* pNavMesh;
+		};
+
+		//Triangulation
+		bool IsAbove(int vertexIdx, int otherVertexIdx) const;
+		float GetSweepX(int edge) const;
+		void PartitionMonotone(std::vector<std::pair<int, int>>& diagonals);
+		// isOnLeftChain is scratch space with a flag per vertex, all false
+		void TriangulateMonotone(const std::vector<int>& piece, std::vector<bool>& isOnLeftChain);
+		void AddTriangle(int vertexIdx1, int vertexIdx2, int vertexIdx3);
+		void BuildAdjacency();
+		void MakeDelaunay();
+
+		//Queries
+		std::vector<int> FindCorridor(int startTriangleIdx, int goalTriangleIdx, const Vector2& startPos, const Vector2& goalPos);
+		std::vector<Vector2> PullString(const std::vector<Portal>& portals) const;
+
+		std::vector<Vector2> m_Vertices;
+		std::vector<int> m_Indices;
+		std::vector<int> m_Neighbours; // invalid_node_index on the border
+		TriangleBVH m_TriangleBVH;
+
+		// only used while building: the rings of the polygon as a linked list of vertex indices
+		std::vector<int> m_NextVertices;
+		std::vector<int> m_PrevVertices;
+		Vector2 m_SweepPos;
+
+		int m_NrOfExpandedTriangles = 0;
+	};
+}
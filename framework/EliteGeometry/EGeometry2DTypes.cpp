@@ -106,6 +106,9 @@ const std::vector<Elite::Triangle*>& Elite::Polygon::GetTriangles() const
 
 const std::vector<Elite::Line*>& Elite::Polygon::GetLines() const
 { return m_vpLines; }
+
+int Elite::Polygon::GetTriangleIdxAtPosition(const Vector2& pos) const
+{ return m_TriangleBVH.GetTriangleIdxAtPosition(pos); }
 #pragma endregion //MemberAccess
 //----------------------------------------------------------
 #pragma region GettersInformation
@@ -301,6 +304,22 @@ const std::vector<Elite::Triangle*>& Elite::Polygon::Triangulate()
 	Triangle* lastTriangle = new Triangle(tempCopy[0], tempCopy[1], tempCopy[2]);
 	m_vpTriangles.push_back(lastTriangle);
 
+	//Bounding volume hierarchy for point queries
+	std::vector<Vector2> corners;
+	std::vector<int> indices;
+	corners.reserve(m_vpTriangles.size() * 3);
+	indices.reserve(m_vpTriangles.size() * 3);
+	for (const auto t : m_vpTriangles)
+	{
+		indices.push_back(static_cast<int>(corners.size()));
+		corners.push_back(t->p1);
+		indices.push_back(static_cast<int>(corners.size()));
+		corners.push_back(t->p2);
+		indices.push_back(static_cast<int>(corners.size()));
+		corners.push_back(t->p3);
+	}
+	m_TriangleBVH.Build(corners, indices);
+
 	//Flag as triangulated for later use
 	m_isTriangulated = true; 
 
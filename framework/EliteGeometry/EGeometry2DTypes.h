@@ -8,6 +8,7 @@
 #define	ELITE_GEOMETRY_TYPES
 
 #include "EGeometry2DUtilities.h"
+#include "ETriangleBVH.h"
 
 namespace Elite 
 {
@@ -105,6 +106,7 @@ namespace Elite
 		const std::vector<Polygon>& GetChildren() const;
 		const std::vector<Triangle*>& GetTriangles() const;
 		const std::vector<Line*>& GetLines() const;
+		int GetTriangleIdxAtPosition(const Vector2& pos) const; //Index in GetTriangles(), -1 when outside
 
 		//Getters information
 		float GetPosVertMaxXPos() const;
@@ -131,6 +133,7 @@ namespace Elite
 		std::list<Vector2> m_vPoints; //Points that define this polygon
 		std::vector<Triangle*> m_vpTriangles; //Triangles create for this polygon, used for rendering
 		std::vector<Line*> m_vpLines; //Lines constructing this polygon!
+		TriangleBVH m_TriangleBVH; //Built by Triangulate, for point queries
 		bool m_isTriangulated = false;
 
 		//=== Functions ===
@@ -0,0 +1,221 @@
+#include "stdafx.h"
+#include "EPointHashGrid.h"
+#include <limits>
+#include <thread>
+
+namespace Elite
+{
+	PointHashGrid::PointHashGrid(float cellSize)
+		: m_CellSize(cellSize)
+		, m_InvCellSize(1.f / cellSize)
+	{
+		assert(cellSize > 0.f && "<PointHashGrid::PointHashGrid>: cell size has to be positive");
+	}
+
+	void PointHashGrid::Rebuild(const float* pXs, const float* pYs, int nrOfPoints)
+	{
+		//about one bucket per point, the table only grows
+		unsigned int nrOfBuckets = static_cast<unsigned int>(m_BucketStarts.size() > 1 ? m_BucketStarts.size() - 1 : 64);
+		while (nrOfBuckets < static_cast<unsigned int>(nrOfPoints))
+			nrOfBuckets *= 2;
+		m_BucketMask = nrOfBuckets - 1;
+		m_NrOfPoints = nrOfPoints;
+
+		m_BucketStarts.resize(nrOfBuckets + 1);
+		m_PointBuckets.resize(nrOfPoints);
+		m_SortedPoints.resize(nrOfPoints);
+		m_SortedIndices.resize(nrOfPoints);
+
+		int nrOfThreads = static_cast<int>(std::thread::hardware_concurrency());
+		if (nrOfPoints < m_ParallelThreshold || nrOfThreads < 2)
+			nrOfThreads = 1;
+		m_ThreadCounts.assign(static_cast<size_t>(nrOfThreads) * nrOfBuckets, 0);
+
+		//Every thread counts and later scatters its own block of points, the results don't depend on the number of threads
+		const int blockSize = (nrOfPoints + nrOfThreads - 1) / nrOfThreads;
+		auto runBlocks = [this, nrOfThreads, nrOfPoints, blockSize, nrOfBuckets](const auto& work)
+		{
+			std::vector<std::thread> threads;
+			for (int i = 1; i < nrOfThreads; ++i)
+			{
+				const int first = i * blockSize;
+				const int last = first + blockSize < nrOfPoints ? first + blockSize : nrOfPoints;
+				threads.emplace_back(work, first, last, &m_ThreadCounts[static_cast<size_t>(i) * nrOfBuckets]);
+			}
+			work(0, blockSize < nrOfPoints ? blockSize : nrOfPoints, m_ThreadCounts.data());
+
+			for (std::thread& thread : threads)
+				thread.join();
+		};
+
+		runBlocks([this, pXs, pYs](int first, int last, int* pCounts) { CountPoints(pXs, pYs, first, last, pCounts); });
+
+		//Buckets in order and within a bucket the threads in order, the counts become the offset every thread writes at
+		int offset = 0;
+		for (unsigned int bucket = 0; bucket < nrOfBuckets; ++bucket)
+		{
+			m_BucketStarts[bucket] = offset;
+			for (int thread = 0; thread < nrOfThreads; ++thread)
+			{
+				int& count = m_ThreadCounts[static_cast<size_t>(thread) * nrOfBuckets + bucket];
+				const int nrInBucket = count;
+				count = offset;
+				offset += nrInBucket;
+			}
+		}
+		m_BucketStarts[nrOfBuckets] = offset;
+
+		runBlocks([this, pXs, pYs](int first, int last, int* pOffsets) { ScatterPoints(pXs, pYs, first, last, pOffsets); });
+
+		m_MinColumn = m_MinRow = (std::numeric_limits<int>::max)();
+		m_MaxColumn = m_MaxRow = (std::numeric_limits<int>::min)();
+		for (int slot = 0; slot < nrOfPoints; ++slot)
+		{
+			const int col = m_SortedPoints[slot].col;
+			const int row = m_SortedPoints[slot].row;
+			m_MinColumn = col < m_MinColumn ? col : m_MinColumn;
+			m_MinRow = row < m_MinRow ? row : m_MinRow;
+			m_MaxColumn = col > m_MaxColumn ? col : m_MaxColumn;
+			m_MaxRow = row > m_MaxRow ? row : m_MaxRow;
+		}
+	}
+
+	void PointHashGrid::Update(const float* pXs, const float* pYs, int nrOfPoints)
+	{
+		if (nrOfPoints != m_NrOfPoints)
+		{
+			Rebuild(pXs, pYs, nrOfPoints);
+			return;
+		}
+
+		//The order only stays valid when every point is still in the cell it was sorted in
+		for (int slot = 0; slot < nrOfPoints; ++slot)
+		{
+			const int index = m_SortedIndices[slot];
+			SortedPoint& point = m_SortedPoints[slot];
+			int col, row;
+			GetCell({ pXs[index], pYs[index] }, col, row);
+			if (col != point.col || row != point.row)
+			{
+				Rebuild(pXs, pYs, nrOfPoints);
+				return;
+			}
+
+			point.x = pXs[index];
+			point.y = pYs[index];
+		}
+	}
+
+	int PointHashGrid::FindInRadius(const Vector2& pos, float radius, int* pResults, int maxResults) const
+	{
+		int nrOfResults = 0;
+		ForEachInRadius(pos, radius, [pResults, maxResults, &nrOfResults](int index, float)
+		{
+			if (nrOfResults < maxResults)
+				pResults[nrOfResults++] = index;
+		});
+		return nrOfResults;
+	}
+
+	int PointHashGrid::FindNearest(const Vector2& pos, int k, float maxDistance, int* pResults) const
+	{
+		if (m_NrOfPoints == 0 || k <= 0)
+			return 0;
+
+		//pResults keeps the slots of the best points so far, closest first, and gets the indices at the end
+		int nrOfResults = 0;
+		float worstDistanceSquared = maxDistance * maxDistance;
+		auto getDistanceSquared = [this, &pos](int slot)
+		{
+			const float dx = m_SortedPoints[slot].x - pos.x;
+			const float dy = m_SortedPoints[slot].y - pos.y;
+			return dx * dx + dy * dy;
+		};
+		auto consider = [&](int slot)
+		{
+			const float distanceSquared = getDistanceSquared(slot);
+			if (distanceSquared > worstDistanceSquared)
+				return;
+
+			int i = nrOfResults < k ? nrOfResults++ : k - 1;
+			for (; i > 0 && getDistanceSquared(pResults[i - 1]) > distanceSquared; --i)
+				pResults[i] = pResults[i - 1];
+			pResults[i] = slot;
+
+			if (nrOfResults == k)
+				worstDistanceSquared = getDistanceSquared(pResults[k - 1]);
+		};
+
+		//Rings of cells around the cell of pos, everything beyond ring r is at least r cells away
+		int column, row;
+		GetCell(pos, column, row);
+		for (int ring = 0; ; ++ring)
+		{
+			if (column - ring < m_MinColumn && column + ring > m_MaxColumn && row - ring < m_MinRow && row + ring > m_MaxRow)
+				break;
+
+			//far rings have more cells than there are points, finish with all points instead
+			const long long sideLength = 2LL * ring + 1;
+			if (sideLength * sideLength > m_NrOfPoints)
+			{
+				for (int slot = 0; slot < m_NrOfPoints; ++slot)
+				{
+					const int slotColumn = m_SortedPoints[slot].col;
+					const int slotRow = m_SortedPoints[slot].row;
+					//cells of earlier rings are done
+					if (slotColumn > column - ring && slotColumn < column + ring && slotRow > row - ring && slotRow < row + ring)
+						continue;
+					consider(slot);
+				}
+				break;
+			}
+
+			for (int ringRow = row - ring; ringRow <= row + ring; ++ringRow)
+			{
+				const bool isEdgeRow = ringRow == row - ring || ringRow == row + ring;
+				for (int ringColumn = column - ring; ringColumn <= column + ring; ringColumn += isEdgeRow || ring == 0 ? 1 : 2 * ring)
+				{
+					const unsigned int bucket = GetBucket(ringColumn, ringRow);
+					const int end = m_BucketStarts[bucket + 1];
+					for (int slot = m_BucketStarts[bucket]; slot < end; ++slot)
+					{
+						if (m_SortedPoints[slot].col == ringColumn && m_SortedPoints[slot].row == ringRow)
+							consider(slot);
+					}
+				}
+			}
+
+			const float searchedDistance = ring * m_CellSize;
+			if (searchedDistance * searchedDistance >= worstDistanceSquared)
+				break;
+		}
+
+		for (int i = 0; i < nrOfResults; ++i)
+			pResults[i] = m_SortedIndices[pResults[i]];
+		return nrOfResults;
+	}
+
+	void PointHashGrid::CountPoints(const float* pXs, const float* pYs, int first, int last, int* pCounts)
+	{
+		for (int index = first; index < last; ++index)
+		{
+			int col, row;
+			GetCell({ pXs[index], pYs[index] }, col, row);
+			const unsigned int bucket = GetBucket(col, row);
+			m_PointBuckets[index] = bucket;
+			++pCounts[bucket];
+		}
+	}
+
+	void PointHashGrid::ScatterPoints(const float* pXs, const float* pYs, int first, int last, int* pOffsets)
+	{
+		for (int index = first; index < last; ++index)
+		{
+			const int slot = pOffsets[m_PointBuckets[index]]++;
+			int col, row;
+			GetCell({ pXs[index], pYs[index] }, col, row);
+			m_SortedPoints[slot] = { pXs[index], pYs[index], col, row };
+			m_SortedIndices[slot] = index;
+		}
+	}
+}
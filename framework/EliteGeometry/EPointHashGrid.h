@@ -0,0 +1,119 @@
+#pragma once
+
+namespace Elite
+{
+	// Uniform grid for many points that all move every tick (agents). Unlike SpatialHashGrid nothing is kept per cell:
+	// a counting sort puts the points in cell order in flat arrays, so every cell is one range of those arrays.
+	// Cells are hashed into a power of two number of buckets, so the grid has no bounds. Cells sharing a bucket share its range.
+	// Neighbouring cells of a row hash to neighbouring buckets, a query reads a few runs of the arrays instead of a cell here and there.
+	// Cell (col, row) covers [col, col + 1[ * cellSize by [row, row + 1[ * cellSize, with the cell size of a GridGraph
+	// the cells are the graph's cells and GetCell returns the column and row of the node under a point.
+	// Queries never allocate, they call back or write into buffers of the caller.
+	class PointHashGrid final
+	{
+	public:
+		explicit PointHashGrid(float cellSize);
+
+		float GetCellSize() const { return m_CellSize; }
+		void GetCell(const Vector2& pos, int& col, int& row) const;
+		int GetNrOfPoints() const { return m_NrOfPoints; }
+
+		// Sorts the points, the index of a point is its index in pXs and pYs. Above the parallel threshold
+		// the points are split over the cores, every core counts and scatters its own part.
+		void Rebuild(const float* pXs, const float* pYs, int nrOfPoints);
+		// Same points with new positions: only refreshes the sorted positions when no point left its cell, rebuilds otherwise
+		void Update(const float* pXs, const float* pYs, int nrOfPoints);
+		void SetParallelThreshold(int nrOfPoints) { m_ParallelThreshold = nrOfPoints; }
+
+		// calls func(index, distanceSquared) for every point within radius of pos, positions as of the last rebuild or update
+		template <class T_Function>
+		void ForEachInRadius(const Vector2& pos, float radius, const T_Function& func) const;
+		// writes at most maxResults indices of points within radius of pos, returns how many it wrote
+		int FindInRadius(const Vector2& pos, float radius, int* pResults, int maxResults) const;
+		// writes the indices of the (at most) k points closest to pos within maxDistance, closest first, returns how many it wrote
+		int FindNearest(const Vector2& pos, int k, float maxDistance, int* pResults) const;
+
+	private:
+		float m_CellSize;
+		float m_InvCellSize;
+		int m_NrOfPoints = 0;
+		int m_ParallelThreshold = 16384;
+		unsigned int m_BucketMask = 0;
+		int m_MinColumn = 0, m_MinRow = 0, m_MaxColumn = -1, m_MaxRow = -1; // occupied cells, bounds the nearest search
+
+		std::vector<int> m_BucketStarts; // one past the last bucket is the number of points
+		std::vector<unsigned int> m_PointBuckets; // per point, in the order of the caller
+		// per point in cell order, the cell tells the cells of a shared bucket apart
+		struct SortedPoint
+		{
+			float x, y;
+			int col, row;
+		};
+		std::vector<SortedPoint> m_SortedPoints;
+		std::vector<int> m_SortedIndices;
+		std::vector<int> m_ThreadCounts; // per thread and bucket, counts and then write offsets
+
+		unsigned int GetBucket(int col, int row) const { return (static_cast<unsigned int>(col) + static_cast<unsigned int>(row) * 19349663u) & m_BucketMask; }
+		void CountPoints(const float* pXs, const float* pYs, int first, int last, int* pCounts);
+		void ScatterPoints(const float* pXs, const float* pYs, int first, int last, int* pOffsets);
+	};
+
+	inline void PointHashGrid::GetCell(const Vector2& pos, int& col, int& row) const
+	{
+		col = static_cast<int>(floorf(pos.x * m_InvCellSize));
+		row = static_cast<int>(floorf(pos.y * m_InvCellSize));
+	}
+
+	template <class T_Function>
+	void PointHashGrid::ForEachInRadius(const Vector2& pos, float radius, const T_Function& func) const
+	{
+		if (m_NrOfPoints == 0)
+			return;
+
+		int minColumn, minRow, maxColumn, maxRow;
+		GetCell({ pos.x - radius, pos.y - radius }, minColumn, minRow);
+		GetCell({ pos.x + radius, pos.y + radius }, maxColumn, maxRow);
+		minColumn = minColumn > m_MinColumn ? minColumn : m_MinColumn;
+		minRow = minRow > m_MinRow ? minRow : m_MinRow;
+		maxColumn = maxColumn < m_MaxColumn ? maxColumn : m_MaxColumn;
+		maxRow = maxRow < m_MaxRow ? maxRow : m_MaxRow;
+		if (minColumn > maxColumn || minRow > maxRow)
+			return;
+
+		const float radiusSquared = radius * radius;
+		//an area with more cells than points is cheaper to go over point by point
+		if (static_cast<long long>(maxColumn - minColumn + 1) * (maxRow - minRow + 1) > m_NrOfPoints)
+		{
+			for (int slot = 0; slot < m_NrOfPoints; ++slot)
+			{
+				const float dx = m_SortedPoints[slot].x - pos.x;
+				const float dy = m_SortedPoints[slot].y - pos.y;
+				const float distanceSquared = dx * dx + dy * dy;
+				if (distanceSquared <= radiusSquared)
+					func(m_SortedIndices[slot], distanceSquared);
+			}
+			return;
+		}
+
+		for (int row = minRow; row <= maxRow; ++row)
+		{
+			for (int col = minColumn; col <= maxColumn; ++col)
+			{
+				const unsigned int bucket = GetBucket(col, row);
+				const int end = m_BucketStarts[bucket + 1];
+				for (int slot = m_BucketStarts[bucket]; slot < end; ++slot)
+				{
+					const SortedPoint& point = m_SortedPoints[slot];
+					if (point.col != col || point.row != row)
+						continue;
+
+					const float dx = point.x - pos.x;
+					const float dy = point.y - pos.y;
+					const float distanceSquared = dx * dx + dy * dy;
+					if (distanceSquared <= radiusSquared)
+						func(m_SortedIndices[slot], distanceSquared);
+				}
+			}
+		}
+	}
+}
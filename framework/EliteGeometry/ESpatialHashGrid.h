@@ -0,0 +1,261 @@
+#pragma once
+
+#include <unordered_map>
+#include "EGeometry2DTypes.h"
+
+namespace Elite
+{
+	// Uniform grid over the plane for sets of many small items (nodes, short segments) that move around.
+	// Only cells that hold something are stored, in a hash map, so the grid has no bounds.
+	// Every item is kept in each cell its bounds overlap. Moving an item only touches the cells when that set of cells changes.
+	template <class T_Value>
+	class SpatialHashGrid
+	{
+	public:
+		explicit SpatialHashGrid(float cellSize);
+
+		// returns a handle for the item, handles of removed items are reused
+		int Insert(const T_Value& value, const Rect& bounds);
+		void Move(int handle, const Rect& bounds);
+		void Remove(int handle);
+		void Clear();
+
+		const T_Value& GetValue(int handle) const { return m_Items[handle].value; }
+		int GetSize() const { return static_cast<int>(m_Items.size() - m_FreeHandles.size()); }
+
+		// calls func(handle, value) once for every item whose bounds overlap the area
+		template <class T_Function>
+		void ForEachInArea(const Rect& area, const T_Function& func) const;
+
+		// Item with the smallest getDistance(value) that is at most maxDistance, -1 when there is none.
+		// getDistance may skip an item by returning infinity and should never be less than the distance from pos to the item's bounds.
+		template <class T_Distance>
+		int FindNearest(const Vector2& pos, float maxDistance, const T_Distance& getDistance) const;
+
+	private:
+		struct CellRange
+		{
+			int minColumn, minRow;
+			int maxColumn, maxRow;
+		};
+
+		struct Item
+		{
+			T_Value value;
+			Rect bounds;
+			CellRange cells;
+		};
+
+		CellRange GetCellRange(const Rect& bounds) const;
+		static long long GetKey(int column, int row) { return static_cast<long long>(static_cast<unsigned long long>(static_cast<unsigned int>(column)) << 32 | static_cast<unsigned int>(row)); }
+		void AddToCells(int handle, const CellRange& cells);
+		void RemoveFromCells(int handle, const CellRange& cells);
+
+		float m_CellSize;
+		std::unordered_map<long long, std::vector<int>> m_Cells;
+		std::vector<Item> m_Items;
+		std::vector<int> m_FreeHandles;
+		CellRange m_UsedCells{ 0, 0, -1, -1 }; // grows only, bounds the nearest search
+	};
+
+	template <class T_Value>
+	SpatialHashGrid<T_Value>::SpatialHashGrid(float cellSize)
+		: m_CellSize(cellSize)
+	{
+		assert(cellSize > 0.f && "<SpatialHashGrid::SpatialHashGrid>: cell size has to be positive");
+	}
+
+	template <class T_Value>
+	int SpatialHashGrid<T_Value>::Insert(const T_Value& value, const Rect& bounds)
+	{
+		int handle = static_cast<int>(m_Items.size());
+		if (m_FreeHandles.empty())
+		{
+			m_Items.push_back({ value, bounds, GetCellRange(bounds) });
+		}
+		else
+		{
+			handle = m_FreeHandles.back();
+			m_FreeHandles.pop_back();
+			m_Items[handle] = { value, bounds, GetCellRange(bounds) };
+		}
+
+		AddToCells(handle, m_Items[handle].cells);
+		return handle;
+	}
+
+	template <class T_Value>
+	void SpatialHashGrid<T_Value>::Move(int handle, const Rect& bounds)
+	{
+		m_Items[handle].bounds = bounds;
+
+		const CellRange cells = GetCellRange(bounds);
+		const CellRange& oldCells = m_Items[handle].cells;
+		if (cells.minColumn == oldCells.minColumn && cells.minRow == oldCells.minRow && cells.maxColumn == oldCells.maxColumn && cells.maxRow == oldCells.maxRow)
+			return;
+
+		RemoveFromCells(handle, oldCells);
+		m_Items[handle].cells = cells;
+		AddToCells(handle, cells);
+	}
+
+	template <class T_Value>
+	void SpatialHashGrid<T_Value>::Remove(int handle)
+	{
+		RemoveFromCells(handle, m_Items[handle].cells);
+		m_FreeHandles.push_back(handle);
+	}
+
+	template <class T_Value>
+	void SpatialHashGrid<T_Value>::Clear()
+	{
+		m_Cells.clear();
+		m_Items.clear();
+		m_FreeHandles.clear();
+		m_UsedCells = { 0, 0, -1, -1 };
+	}
+
+	template <class T_Value>
+	template <class T_Function>
+	void SpatialHashGrid<T_Value>::ForEachInArea(const Rect& area, const T_Function& func) const
+	{
+		const CellRange cells = GetCellRange(area);
+		for (int row = cells.minRow; row <= cells.maxRow; ++row)
+		{
+			for (int column = cells.minColumn; column <= cells.maxColumn; ++column)
+			{
+				auto foundIt = m_Cells.find(GetKey(column, row));
+				if (foundIt == m_Cells.end())
+					continue;
+
+				for (int handle : foundIt->second)
+				{
+					//an item in several cells of the area is only reported in the first of them
+					const CellRange& itemCells = m_Items[handle].cells;
+					if (column != (itemCells.minColumn > cells.minColumn ? itemCells.minColumn : cells.minColumn)
+						|| row != (itemCells.minRow > cells.minRow ? itemCells.minRow : cells.minRow))
+						continue;
+
+					if (IsOverlapping(area, m_Items[handle].bounds))
+						func(handle, m_Items[handle].value);
+				}
+			}
+		}
+	}
+
+	template <class T_Value>
+	template <class T_Distance>
+	int SpatialHashGrid<T_Value>::FindNearest(const Vector2& pos, float maxDistance, const T_Distance& getDistance) const
+	{
+		//search rings of cells around the cell of pos, everything beyond ring r is at least r cells away
+		const int column = static_cast<int>(floorf(pos.x / m_CellSize));
+		const int row = static_cast<int>(floorf(pos.y / m_CellSize));
+
+		int nearestHandle = -1;
+		float nearestDistance = maxDistance;
+		for (int ring = 0; ; ++ring)
+		{
+			if (column - ring < m_UsedCells.minColumn && column + ring > m_UsedCells.maxColumn
+				&& row - ring < m_UsedCells.minRow && row + ring > m_UsedCells.maxRow)
+				break;
+
+			//far searches in sparse grids look at more empty cells than there are items, go over every used cell instead
+			const long long sideLength = 2LL * ring + 1;
+			if (sideLength * sideLength > static_cast<long long>(m_Cells.size() / 4))
+			{
+				for (const auto& cell : m_Cells)
+				{
+					for (int handle : cell.second)
+					{
+						const CellRange& itemCells = m_Items[handle].cells;
+						if (cell.first != GetKey(itemCells.minColumn, itemCells.minRow))
+							continue;
+
+						const float distance = getDistance(m_Items[handle].value);
+						if (distance <= nearestDistance)
+						{
+							nearestDistance = distance;
+							nearestHandle = handle;
+						}
+					}
+				}
+				break;
+			}
+
+			for (int ringRow = row - ring; ringRow <= row + ring; ++ringRow)
+			{
+				const bool isEdgeRow = ringRow == row - ring || ringRow == row + ring;
+				for (int ringColumn = column - ring; ringColumn <= column + ring; ringColumn += isEdgeRow || ring == 0 ? 1 : 2 * ring)
+				{
+					auto foundIt = m_Cells.find(GetKey(ringColumn, ringRow));
+					if (foundIt == m_Cells.end())
+						continue;
+
+					for (int handle : foundIt->second)
+					{
+						const float distance = getDistance(m_Items[handle].value);
+						if (distance <= nearestDistance)
+						{
+							nearestDistance = distance;
+							nearestHandle = handle;
+						}
+					}
+				}
+			}
+
+			if (ring * m_CellSize >= nearestDistance)
+				break;
+		}
+
+		return nearestHandle;
+	}
+
+	template <class T_Value>
+	typename SpatialHashGrid<T_Value>::CellRange SpatialHashGrid<T_Value>::GetCellRange(const Rect& bounds) const
+	{
+		return CellRange{
+			static_cast<int>(floorf(bounds.bottomLeft.x / m_CellSize)),
+			static_cast<int>(floorf(bounds.bottomLeft.y / m_CellSize)),
+			static_cast<int>(floorf((bounds.bottomLeft.x + bounds.width) / m_CellSize)),
+			static_cast<int>(floorf((bounds.bottomLeft.y + bounds.height) / m_CellSize)) };
+	}
+
+	template <class T_Value>
+	void SpatialHashGrid<T_Value>::AddToCells(int handle, const CellRange& cells)
+	{
+		for (int row = cells.minRow; row <= cells.maxRow; ++row)
+		{
+			for (int column = cells.minColumn; column <= cells.maxColumn; ++column)
+				m_Cells[GetKey(column, row)].push_back(handle);
+		}
+
+		if (m_UsedCells.minColumn > m_UsedCells.maxColumn)
+		{
+			m_UsedCells = cells;
+			return;
+		}
+
+		m_UsedCells.minColumn = cells.minColumn < m_UsedCells.minColumn ? cells.minColumn : m_UsedCells.minColumn;
+		m_UsedCells.minRow = cells.minRow < m_UsedCells.minRow ? cells.minRow : m_UsedCells.minRow;
+		m_UsedCells.maxColumn = cells.maxColumn > m_UsedCells.maxColumn ? cells.maxColumn : m_UsedCells.maxColumn;
+		m_UsedCells.maxRow = cells.maxRow > m_UsedCells.maxRow ? cells.maxRow : m_UsedCells.maxRow;
+	}
+
+	template <class T_Value>
+	void SpatialHashGrid<T_Value>::RemoveFromCells(int handle, const CellRange& cells)
+	{
+		for (int row = cells.minRow; row <= cells.maxRow; ++row)
+		{
+			for (int column = cells.minColumn; column <= cells.maxColumn; ++column)
+			{
+				auto foundIt = m_Cells.find(GetKey(column, row));
+				std::vector<int>& handles = foundIt->second;
+				*std::find(handles.begin(), handles.end(), handle) = handles.back();
+				handles.pop_back();
+
+				if (handles.empty())
+					m_Cells.erase(foundIt);
+			}
+		}
+	}
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+namespace Elite
+{
+	// Bounding volume hierarchy over a fixed set of triangles, for point location in triangulated polygons and navmeshes.
+	// Built top down, every node is split at the median of its triangle centers along its longest side.
+	// Nodes sit in one array with both children next to each other, triangle corners are copied in leaf order.
+	class TriangleBVH final
+	{
+	public:
+		// three vertex indices per triangle
+		void Build(const std::vector<Vector2>& vertices, const std::vector<int>& indices);
+		void Clear();
+
+		// first triangle that holds the position (edges included), -1 when there is none
+		int GetTriangleIdxAtPosition(const Vector2& pos) const;
+		// calls func(triangleIdx) for every triangle whose bounds overlap the box from min to max
+		template <class T_Function>
+		void ForEachInArea(const Vector2& min, const Vector2& max, const T_Function& func) const;
+
+		bool IsEmpty() const { return m_Nodes.empty(); }
+		size_t GetMemoryUsage() const; // approximate, in bytes
+
+	private:
+		struct Node
+		{
+			Vector2 min;
+			Vector2 max;
+			int first; // leaf: first triangle in leaf order, inner node: left child (the right one follows it)
+			int count; // number of triangles in a leaf, 0 for inner nodes
+		};
+
+		static const int m_MaxLeafSize = 4;
+
+		void BuildNode(int nodeIdx, int first, int count, const std::vector<Vector2>& centers);
+
+		std::vector<Node> m_Nodes;
+		std::vector<int> m_TriangleIndices; // in leaf order
+		std::vector<Vector2> m_Corners; // three per triangle, in leaf order
+	};
+
+	inline void TriangleBVH::Build(const std::vector<Vector2>& vertices, const std::vector<int>& indices)
+	{
+		Clear();
+
+		const int nrOfTriangles = static_cast<int>(indices.size() / 3);
+		if (nrOfTriangles == 0)
+			return;
+
+		std::vector<Vector2> centers(nrOfTriangles);
+		m_TriangleIndices.resize(nrOfTriangles);
+		for (int triangleIdx = 0; triangleIdx < nrOfTriangles; ++triangleIdx)
+		{
+			m_TriangleIndices[triangleIdx] = triangleIdx;
+			centers[triangleIdx] = (vertices[indices[triangleIdx * 3]] + vertices[indices[triangleIdx * 3 + 1]] + vertices[indices[triangleIdx * 3 + 2]]) / 3.f;
+		}
+
+		m_Corners.reserve(indices.size());
+		m_Nodes.reserve(2 * nrOfTriangles / m_MaxLeafSize + 1);
+		m_Nodes.push_back({});
+		BuildNode(0, 0, nrOfTriangles, centers);
+
+		//bounds come from the corners, which are only known in leaf order once every leaf is made, children before their parent
+		for (int leafTriangle = 0; leafTriangle < nrOfTriangles; ++leafTriangle)
+		{
+			for (int corner = 0; corner < 3; ++corner)
+				m_Corners.push_back(vertices[indices[m_TriangleIndices[leafTriangle] * 3 + corner]]);
+		}
+
+		for (int nodeIdx = static_cast<int>(m_Nodes.size()) - 1; nodeIdx >= 0; --nodeIdx)
+		{
+			Node& node = m_Nodes[nodeIdx];
+			if (node.count == 0)
+			{
+				const Node& left = m_Nodes[node.first];
+				const Node& right = m_Nodes[node.first + 1];
+				node.min = { left.min.x < right.min.x ? left.min.x : right.min.x, left.min.y < right.min.y ? left.min.y : right.min.y };
+				node.max = { left.max.x > right.max.x ? left.max.x : right.max.x, left.max.y > right.max.y ? left.max.y : right.max.y };
+				continue;
+			}
+
+			node.min = m_Corners[node.first * 3];
+			node.max = m_Corners[node.first * 3];
+			for (int cornerIdx = node.first * 3; cornerIdx < (node.first + node.count) * 3; ++cornerIdx)
+			{
+				const Vector2& corner = m_Corners[cornerIdx];
+				node.min = { corner.x < node.min.x ? corner.x : node.min.x, corner.y < node.min.y ? corner.y : node.min.y };
+				node.max = { corner.x > node.max.x ? corner.x : node.max.x, corner.y > node.max.y ? corner.y : node.max.y };
+			}
+		}
+	}
+
+	inline void TriangleBVH::BuildNode(int nodeIdx, int first, int count, const std::vector<Vector2>& centers)
+	{
+		if (count <= m_MaxLeafSize)
+		{
+			m_Nodes[nodeIdx].first = first;
+			m_Nodes[nodeIdx].count = count;
+			return;
+		}
+
+		Vector2 min = centers[m_TriangleIndices[first]];
+		Vector2 max = min;
+		for (int i = first + 1; i < first + count; ++i)
+		{
+			const Vector2& center = centers[m_TriangleIndices[i]];
+			min = { center.x < min.x ? center.x : min.x, center.y < min.y ? center.y : min.y };
+			max = { center.x > max.x ? center.x : max.x, center.y > max.y ? center.y : max.y };
+		}
+
+		const bool isSplitOnX = max.x - min.x >= max.y - min.y;
+		const int half = count / 2;
+		std::nth_element(m_TriangleIndices.begin() + first, m_TriangleIndices.begin() + first + half, m_TriangleIndices.begin() + first + count,
+			[&centers, isSplitOnX](int triangleIdx, int otherTriangleIdx)
+			{ return isSplitOnX ? centers[triangleIdx].x < centers[otherTriangleIdx].x : centers[triangleIdx].y < centers[otherTriangleIdx].y; });
+
+		//children always come after their parent
+		const int leftIdx = static_cast<int>(m_Nodes.size());
+		m_Nodes[nodeIdx].first = leftIdx;
+		m_Nodes[nodeIdx].count = 0;
+		m_Nodes.push_back({});
+		m_Nodes.push_back({});
+
+		BuildNode(leftIdx, first, half, centers);
+		BuildNode(leftIdx + 1, first + half, count - half, centers);
+	}
+
+	inline void TriangleBVH::Clear()
+	{
+		m_Nodes.clear();
+		m_TriangleIndices.clear();
+		m_Corners.clear();
+	}
+
+	inline size_t TriangleBVH::GetMemoryUsage() const
+	{
+		return m_Nodes.capacity() * sizeof(Node) + m_TriangleIndices.capacity() * sizeof(int) + m_Corners.capacity() * sizeof(Vector2);
+	}
+
+	inline int TriangleBVH::GetTriangleIdxAtPosition(const Vector2& pos) const
+	{
+		if (m_Nodes.empty())
+			return -1;
+
+		int stack[64];
+		int stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize > 0)
+		{
+			const Node& node = m_Nodes[stack[--stackSize]];
+			if (pos.x < node.min.x || pos.x > node.max.x || pos.y < node.min.y || pos.y > node.max.y)
+				continue;
+
+			if (node.count == 0)
+			{
+				stack[stackSize++] = node.first;
+				stack[stackSize++] = node.first + 1;
+				continue;
+			}
+
+			for (int leafTriangle = node.first; leafTriangle < node.first + node.count; ++leafTriangle)
+			{
+				//inside when pos isn't on the outer side of any edge, for either winding
+				const Vector2* pCorners = &m_Corners[leafTriangle * 3];
+				bool hasNegative = false;
+				bool hasPositive = false;
+				for (int corner = 0; corner < 3; ++corner)
+				{
+					const float side = Cross(pCorners[(corner + 1) % 3] - pCorners[corner], pos - pCorners[corner]);
+					hasNegative |= side < -FLT_EPSILON;
+					hasPositive |= side > FLT_EPSILON;
+				}
+
+				if (!hasNegative || !hasPositive)
+					return m_TriangleIndices[leafTriangle];
+			}
+		}
+
+		return -1;
+	}
+
+	template <class T_Function>
+	void TriangleBVH::ForEachInArea(const Vector2& min, const Vector2& max, const T_Function& func) const
+	{
+		if (m_Nodes.empty())
+			return;
+
+		int stack[64];
+		int stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize > 0)
+		{
+			const Node& node = m_Nodes[stack[--stackSize]];
+			if (node.max.x < min.x || node.min.x > max.x || node.max.y < min.y || node.min.y > max.y)
+				continue;
+
+			if (node.count == 0)
+			{
+				stack[stackSize++] = node.first;
+				stack[stackSize++] = node.first + 1;
+				continue;
+			}
+
+			for (int leafTriangle = node.first; leafTriangle < node.first + node.count; ++leafTriangle)
+				func(m_TriangleIndices[leafTriangle]);
+		}
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <array>
+
+namespace Elite
+{
+	// Fixed size array whose copies share its elements in chunks, a chunk is only copied once one of them writes to it.
+	// Copying the array costs a pointer. Like the graphs that use it (see IGraph), copies are taken on the thread that writes.
+	template<class T>
+	class CopyOnWriteArray final
+	{
+	public:
+		CopyOnWriteArray() : m_pChunks(make_shared<ChunkVector>()) {}
+
+		// drops the old elements, copies keep them
+		void Assign(size_t size, const T& value);
+		size_t GetSize() const { return m_Size; }
+
+		const T& operator[](size_t idx) const { return (*(*m_pChunks)[idx >> m_ChunkShift])[idx & (m_ChunkSize - 1)]; }
+		void Set(size_t idx, const T& value) { GetChunkForWriting(idx)[idx & (m_ChunkSize - 1)] = value; }
+
+	private:
+		static const int m_ChunkShift = 6;
+		static const size_t m_ChunkSize = size_t(1) << m_ChunkShift;
+
+		using Chunk = std::array<T, m_ChunkSize>; // the last one can be partly unused
+		using ChunkVector = std::vector<shared_ptr<Chunk>>;
+
+		shared_ptr<ChunkVector> m_pChunks;
+		size_t m_Size = 0;
+
+		Chunk& GetChunkForWriting(size_t idx);
+	};
+
+	template<class T>
+	inline void CopyOnWriteArray<T>::Assign(size_t size, const T& value)
+	{
+		m_pChunks = make_shared<ChunkVector>();
+		for (size_t first = 0; first < size; first += m_ChunkSize)
+		{
+			m_pChunks->push_back(make_shared<Chunk>());
+			m_pChunks->back()->fill(value);
+		}
+		m_Size = size;
+	}
+
+	template<class T>
+	inline typename CopyOnWriteArray<T>::Chunk& CopyOnWriteArray<T>::GetChunkForWriting(size_t idx)
+	{
+		assert(idx < m_Size && "<CopyOnWriteArray::Set>: invalid index");
+
+		if (m_pChunks.use_count() > 1)
+			m_pChunks = make_shared<ChunkVector>(*m_pChunks);
+
+		shared_ptr<Chunk>& pChunk = (*m_pChunks)[idx >> m_ChunkShift];
+		if (pChunk.use_count() > 1)
+			pChunk = make_shared<Chunk>(*pChunk);
+
+		return *pChunk;
+	}
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Elite
+{
+	// Read only view of a whole file, the OS pages it in when it's first touched and can share it between processes.
+	class MappedFile final
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile() { Close(); }
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// false when the file doesn't exist, is empty or can't be mapped
+		bool Open(const std::string& path);
+		void Close();
+
+		bool IsOpen() const { return m_pData != nullptr; }
+		const char* GetData() const { return m_pData; }
+		size_t GetSize() const { return m_Size; }
+
+	private:
+		const char* m_pData = nullptr;
+		size_t m_Size = 0;
+#ifdef _WIN32
+		HANDLE m_File = INVALID_HANDLE_VALUE;
+		HANDLE m_Mapping = nullptr;
+#else
+		int m_File = -1;
+#endif
+	};
+
+#ifdef _WIN32
+	inline bool MappedFile::Open(const std::string& path)
+	{
+		Close();
+
+		m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		LARGE_INTEGER size{};
+		if (m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_File, &size) || size.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+
+		m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_Mapping)
+			m_pData = static_cast<const char*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+
+		if (!m_pData)
+		{
+			Close();
+			return false;
+		}
+
+		m_Size = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+	inline void MappedFile::Close()
+	{
+		if (m_pData)
+			UnmapViewOfFile(m_pData);
+		if (m_Mapping)
+			CloseHandle(m_Mapping);
+		if (m_File != INVALID_HANDLE_VALUE)
+			CloseHandle(m_File);
+
+		m_pData = nullptr;
+		m_Size = 0;
+		m_Mapping = nullptr;
+		m_File = INVALID_HANDLE_VALUE;
+	}
+#else
+	inline bool MappedFile::Open(const std::string& path)
+	{
+		Close();
+
+		m_File = open(path.c_str(), O_RDONLY);
+		struct stat fileStat{};
+		if (m_File == -1 || fstat(m_File, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			Close();
+			return false;
+		}
+
+		void* pData = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, m_File, 0);
+		if (pData == MAP_FAILED)
+		{
+			Close();
+			return false;
+		}
+
+		m_pData = static_cast<const char*>(pData);
+		m_Size = static_cast<size_t>(fileStat.st_size);
+		return true;
+	}
+
+	inline void MappedFile::Close()
+	{
+		if (m_pData)
+			munmap(const_cast<char*>(m_pData), m_Size);
+		if (m_File != -1)
+			close(m_File);
+
+		m_pData = nullptr;
+		m_Size = 0;
+		m_File = -1;
+	}
+#endif
+}
@@ -13,6 +13,7 @@ namespace Elite
 #if (PLATFORM_ID == PLATFORM_WINDOWS)
 	class SDLWindow;
 #endif
+	class NullWindow;
 
 	/*! EInputManager: manager class that controls all the input, captured from active platform & window*/
 	class EInputManager final : public ESingleton<EInputManager>
@@ -27,15 +28,26 @@ namespace Elite
 		bool IsMouseMoving() { return IsMousePresent(eMouseMotion); }
 		MouseData GetMouseData(InputType type, InputMouseButton button = InputMouseButton(0));
 
+		//Fixed ticks: events of a frame that ran no tick are kept for the next one, so none get lost.
+		//Once a tick has seen them they're consumed, later ticks of the same frame don't handle them again.
+		void KeepEventsForNextFrame() { m_KeepEvents = true; }
+		void ConsumeEvents() { m_InputContainer.clear(); }
+
 	private:
 		//=== Friends ===
 		//Our window has access to add input events to our queue, our application can later use these events
 #if (PLATFORM_ID == PLATFORM_WINDOWS)
 		friend SDLWindow;
 #endif
+		friend NullWindow;
 
 		//=== Internal Functions
-		void Flush(){ m_InputContainer.clear();};
+		void Flush()
+		{
+			if (!m_KeepEvents)
+				m_InputContainer.clear();
+			m_KeepEvents = false;
+		};
 		void AddInputAction(const InputAction& inputAction) 
 		{ m_InputContainer.push_back(inputAction); };
 
@@ -44,6 +56,7 @@ namespace Elite
 
 		//=== Datamembers ===
 		std::vector<InputAction> m_InputContainer;
+		bool m_KeepEvents = false;
 	};
 }
 #endif
\ No newline at end of file
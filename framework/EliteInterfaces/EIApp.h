@@ -13,6 +13,8 @@ public:
 	//App Functions
 	virtual void Start() = 0;
 	virtual void Update(float deltaTime) = 0;
+	//Once per frame after the ticks, for the immediate UI (Update runs zero or more times a frame)
+	virtual void UpdateUI() {}
 	virtual void Render(float deltaTime) const = 0;
 
 protected:
@@ -47,6 +47,27 @@ void PhysicsWorld::Initialize()
 	m_pDebugRenderer = pDebugRenderer; //Store pointer in void pointer to delete later
 }
 
+template<>
+void PhysicsWorld::Step(float timeStep)
+{
+	if (!m_pPhysicsWorld)
+		return;
+
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	//Fixtures keep their RigidBody as userdata
+	for (b2Body* pBody = m_pPhysicsWorld->GetBodyList(); pBody != nullptr; pBody = pBody->GetNext())
+	{
+		const b2Fixture* pFixture = pBody->GetFixtureList();
+		if (pFixture && pFixture->GetUserData())
+			static_cast<RigidBody*>(pFixture->GetUserData())->StorePreviousState();
+	}
+
+	const Box2DPhysicsSettings physicsSettings;
+	m_pPhysicsWorld->Step(timeStep, physicsSettings.velocityIterations, physicsSettings.positionIterations);
+	m_StepTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
 template<>
 void PhysicsWorld::Simulate(float elapsedTime)
 {
@@ -63,7 +84,7 @@ void PhysicsWorld::Simulate(float elapsedTime)
 
 	while (m_FrameTimeAccumulator >= frameTime)
 	{
-		m_pPhysicsWorld->Step(frameTime, physicsSettings.velocityIterations, physicsSettings.positionIterations);
+		Step(frameTime);
 		m_FrameTimeAccumulator -= frameTime;
 	}
 }
@@ -12,6 +12,7 @@ Elite::RigidBodyBase<Elite::Vector2, Elite::Vector2>::RigidBodyBase(const RigidB
 {
 	//Store define information
 	m_RigidBodyInformation = define;
+	m_PreviousPosition = initialTransform.position;
 
 	//Define body
 	b2BodyDef bd;
@@ -146,6 +147,7 @@ void Elite::RigidBodyBase<Elite::Vector2, Elite::Vector2>::SetPosition(const Vec
 {
 	auto pBody = static_cast<b2Body*>(m_pBody);
 	pBody->SetTransform(b2Vec2(pos.x, pos.y), pBody->GetAngle());
+	m_PreviousPosition = pos;
 }
 
 template<>
@@ -163,6 +165,33 @@ void Elite::RigidBodyBase<Elite::Vector2, Elite::Vector2>::SetRotation(const Vec
 	pBody->SetTransform(pBody->GetPosition(), rot.x);
 }
 
+template<>
+void Elite::RigidBodyBase<Elite::Vector2, Elite::Vector2>::StorePreviousState()
+{
+	m_PreviousPosition = GetPosition();
+	m_PreviousRotation = GetRotation();
+}
+
+template<>
+Elite::Vector2 Elite::RigidBodyBase<Elite::Vector2, Elite::Vector2>::GetInterpolatedPosition(float alpha)
+{
+	return m_PreviousPosition + (GetPosition() - m_PreviousPosition) * alpha;
+}
+
+template<>
+Elite::Vector2 Elite::RigidBodyBase<Elite::Vector2, Elite::Vector2>::GetInterpolatedRotation(float alpha)
+{
+	//Along the shortest arc, orientations set from atan2 jump between -pi and pi
+	const float pi = static_cast<float>(E_PI);
+	float delta = GetRotation().x - m_PreviousRotation.x;
+	while (delta > pi)
+		delta -= 2.f * pi;
+	while (delta < -pi)
+		delta += 2.f * pi;
+	const float rotation = m_PreviousRotation.x + delta * alpha;
+	return Vector2(rotation, rotation);
+}
+
 template<>
 void Elite::RigidBodyBase<Elite::Vector2, Elite::Vector2>::SetMass(float m)
 {
@@ -22,6 +22,8 @@ namespace Elite
 
 		//=== World Functions ===
 		void Simulate(float elapsedTime = 0.f);
+		void Step(float timeStep); //exactly one step, for a caller that runs its own fixed timestep
+		float GetStepTime() const { return m_StepTime; } //ms spent in the last Step
 		void RenderDebug() const;
 
 		physicsWorldType GetWorld() const { return m_pPhysicsWorld; }
@@ -36,6 +38,7 @@ namespace Elite
 		physicsWorldType m_pPhysicsWorld;
 		void* m_pDebugRenderer = nullptr;
 		float m_FrameTimeAccumulator = 0.f;
+		float m_StepTime = 0.f;
 
 		//=== Internal Functions ===
 		void Initialize();
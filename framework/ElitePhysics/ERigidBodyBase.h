@@ -37,6 +37,12 @@ namespace Elite
 		orientationType GetRotation();
 		void SetRotation(const orientationType& rot);
 
+		//State before the last physics step, rendering blends it with the current one (alpha 0 is the previous state).
+		//SetPosition teleports: it moves the previous state as well.
+		void StorePreviousState();
+		translationType GetInterpolatedPosition(float alpha);
+		orientationType GetInterpolatedRotation(float alpha);
+
 		void SetMass(float m);
 		float GetMass();
 
@@ -67,6 +73,8 @@ namespace Elite
 		void* m_pBody = nullptr;
 		RigidBodyUserData m_pUserData = {};
 		PhysicsFlags m_UserDefinedFlags = PhysicsFlags::Default;
+		translationType m_PreviousPosition = {};
+		orientationType m_PreviousRotation = {};
 
 		//=== Internal Functions ===
 		void Initialize();
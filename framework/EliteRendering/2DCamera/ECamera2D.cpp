@@ -79,6 +79,16 @@ Elite::Vector2 Camera2D::ConvertWorldToScreen(const Elite::Vector2& worldPoint)
 	return ps;
 }
 
+void Camera2D::GetWorldBounds(Elite::Vector2& lower, Elite::Vector2& upper) const
+{
+	const auto ratio = float(m_width) / float(m_height);
+	Elite::Vector2 extents(ratio, 1.0f);
+	extents *= m_zoom;
+
+	lower = m_center - extents;
+	upper = m_center + extents;
+}
+
 // Convert from world coordinates to normalized device coordinates.
 // http://www.songho.ca/opengl/gl_projectionmatrix.html
 void Camera2D::BuildProjectionMatrix(float* m, float zBias) const
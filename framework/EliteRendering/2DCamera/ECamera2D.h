@@ -20,6 +20,9 @@ public:
 	Elite::Vector2 ConvertScreenToWorld(const Elite::Vector2& screenPoint) const;
 	Elite::Vector2 ConvertWorldToScreen(const Elite::Vector2& worldPoint) const;
 	void BuildProjectionMatrix(float* m, float zBias) const;
+	//Visible part of the world, lower is the bottom left corner and upper the top right one
+	void GetWorldBounds(Elite::Vector2& lower, Elite::Vector2& upper) const;
+	float GetPixelsPerUnit() const { return float(m_height) / (2.0f * m_zoom); }
 	void SetZoom(float z) { m_zoom = z; }
 	void SetCenter(Elite::Vector2 c) { m_center = c; }
 	void SetZoomLocked(bool state) { m_isZoomLocked = state; }
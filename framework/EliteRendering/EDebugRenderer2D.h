@@ -47,6 +47,18 @@ namespace Elite
 
 		inline float NextDepthSlice();
 
+		//--- Retained Grid Layers ---
+		unsigned int CreateGridLayer(int columns, int rows);
+		void DestroyGridLayer(unsigned int layer);
+		void SetGridLayerPalette(unsigned int layer, const Color* pColors, int count);
+		void UpdateGridLayer(unsigned int layer, int col, int row, int width, int height, const unsigned char* pIndices, int rowLength);
+		void DrawGridLayer(unsigned int layer, const Elite::Vector2& bottomLeft, float cellSize, const Color& outlineColor, float outlineWidth, float depth);
+
+		//--- Instanced Shapes ---
+		void DrawSolidCircleInstance(const Elite::Vector2& center, float radius, const Color& color, float depth);
+		void DrawSolidRectInstance(const Elite::Vector2& center, float halfWidth, float rotation, const Color& color, float depth);
+		void DrawArrowInstance(const Elite::Vector2& position, float radius, float rotation, const Color& color, float depth);
+
 	protected:
 		//General
 		Camera2D* m_pActiveCamera = nullptr;
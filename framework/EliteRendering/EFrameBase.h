@@ -6,6 +6,10 @@
 /*=============================================================================*/
 #ifndef ELITE_FRAME_BASE
 #define	ELITE_FRAME_BASE
+
+//Frames that can be submitted while the render thread is still drawing an older one (double buffering on top of the recording lists)
+#define ELITE_FRAMES_IN_FLIGHT 2
+
 namespace Elite
 {
 	template<typename Impl>
@@ -19,6 +23,8 @@ namespace Elite
 		//=== Functions ===
 		void CreateFrame(EliteWindow* pWindow);
 		void SubmitAndFlipFrame();
+		void StartRenderThread(); //after all rendering resources are created
+		void StopRenderThread(); //before any rendering resource gets destroyed
 
 	protected:
 		EliteWindow* m_pWindow = nullptr;
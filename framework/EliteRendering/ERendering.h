@@ -17,7 +17,12 @@ typedef void* EliteRenderingContext;
 #include "EDebugRenderer2D.h"
 
 /* --- PLATFORM-SPECIFIC DEFINES & INCLUDES --- */
-#if (PLATFORM_ID == PLATFORM_WINDOWS)
+#if defined(ELITE_HEADLESS)
+	#include "NullIntegration/NullDebugRenderer2D/NullDebugRenderer2D.h"
+	typedef Elite::NullDebugRenderer2D EliteDebugRenderer2D;
+	#include "NullIntegration/NullFrame/NullFrame.h"
+	typedef Elite::NullFrame EliteFrame;
+#elif (PLATFORM_ID == PLATFORM_WINDOWS)
 	#include "SDLIntegration/SDLDebugRenderer2D/SDLDebugRenderer2D.h"
 	typedef Elite::SDLDebugRenderer2D EliteDebugRenderer2D;
 	#include "SDLIntegration/SDLFrame/SDLFrame.h"
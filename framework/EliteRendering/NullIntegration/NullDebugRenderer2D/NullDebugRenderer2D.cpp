@@ -0,0 +1,127 @@
+//Precompiled Header [ALWAYS ON TOP IN CPP]
+#include "stdafx.h"
+#ifdef ELITE_HEADLESS
+#include "NullDebugRenderer2D.h"
+using namespace Elite;
+
+//Immediate Draw Auto Layering Settings, same as the SDL renderer
+#define DEPTH_SLICE_OFFSET 0.0005f
+#define DEPTH_SLICE_MIN -0.5f//far
+#define DEPTH_SLICE_MAX 0.5f//close
+
+//Functions
+void NullDebugRenderer2D::Initialize(Camera2D* pActiveCamera)
+{
+	m_pActiveCamera = pActiveCamera;
+	m_CurrDepthSlice = DEPTH_SLICE_MAX;
+}
+
+void NullDebugRenderer2D::Render()
+{
+	//The draw calls the SDL renderer makes: one per non empty list, grid layer draw and kind of shape instance
+	const FrameSubmissions& frame = m_CurrFrame;
+	m_LastFrameStats.nrOfVertices = frame.nrOfLineVertices + frame.nrOfTriangleVertices + frame.nrOfPoints;
+	m_LastFrameStats.nrOfShapeInstances = frame.nrOfCircleInstances + frame.nrOfRectInstances + frame.nrOfArrowInstances;
+	m_LastFrameStats.nrOfDrawCalls = frame.nrOfGridLayerDraws
+		+ (frame.nrOfLineVertices > 0) + (frame.nrOfTriangleVertices > 0) + (frame.nrOfPoints > 0)
+		+ (frame.nrOfCircleInstances > 0) + (frame.nrOfRectInstances > 0) + (frame.nrOfArrowInstances > 0);
+
+	m_TotalStats.nrOfVertices += m_LastFrameStats.nrOfVertices;
+	m_TotalStats.nrOfShapeInstances += m_LastFrameStats.nrOfShapeInstances;
+	m_TotalStats.nrOfDrawCalls += m_LastFrameStats.nrOfDrawCalls;
+	++m_NrOfFrames;
+
+	m_CurrFrame = {};
+	m_CurrDepthSlice = DEPTH_SLICE_MAX;
+}
+
+void NullDebugRenderer2D::DrawPolygon(Elite::Polygon* polygon, const Color& color, float depth)
+{
+	m_CurrFrame.nrOfLineVertices += 2 * polygon->GetPoints().size();
+	for (auto& child : polygon->GetChildren())
+		m_CurrFrame.nrOfLineVertices += 2 * child.GetPoints().size();
+}
+
+void NullDebugRenderer2D::DrawSolidPolygon(Elite::Polygon* polygon, const Color& color, float depth, bool triangulate)
+{
+	//Triangulates when the SDL renderer would, apps may rely on the polygon being triangulated afterwards
+	const size_t nrOfTriangles = triangulate || !polygon->IsTriangulated() ? polygon->Triangulate().size() : polygon->GetTriangles().size();
+
+	//Triangles, a point in each of them and their wireframe
+	m_CurrFrame.nrOfTriangleVertices += 3 * nrOfTriangles;
+	m_CurrFrame.nrOfPoints += nrOfTriangles;
+	m_CurrFrame.nrOfLineVertices += 6 * nrOfTriangles;
+}
+
+void NullDebugRenderer2D::DrawSolidPolygon(const Elite::Vector2* points, int count, const Color& color, float depth, bool triangulate)
+{
+	if (triangulate)
+	{
+		Elite::Polygon polygon(points, count);
+		m_CurrFrame.nrOfTriangleVertices += 3 * polygon.Triangulate().size();
+	}
+	else if (count > 2)
+	{
+		m_CurrFrame.nrOfTriangleVertices += 3 * (count - 2);
+	}
+
+	m_CurrFrame.nrOfLineVertices += 2 * count;
+}
+
+void NullDebugRenderer2D::DrawSolidCircle(const Elite::Vector2& center, float radius, const Elite::Vector2& axis, const Color& color, float depth)
+{
+	//16 triangles, 16 outline segments and the axis
+	m_CurrFrame.nrOfTriangleVertices += 48;
+	m_CurrFrame.nrOfLineVertices += 34;
+}
+
+float NullDebugRenderer2D::NextDepthSlice()
+{
+	m_CurrDepthSlice -= DEPTH_SLICE_OFFSET;
+
+	if (m_CurrDepthSlice < DEPTH_SLICE_MIN)
+		m_CurrDepthSlice = DEPTH_SLICE_MAX;
+
+	return m_CurrDepthSlice;
+}
+
+//Retained Grid Layers
+unsigned int NullDebugRenderer2D::CreateGridLayer(int columns, int rows)
+{
+	assert(columns > 0 && rows > 0 && "<NullDebugRenderer2D::CreateGridLayer>: a layer needs cells");
+
+	//Reuse the slot of a destroyed layer
+	unsigned int layer = 0;
+	while (layer < m_GridLayers.size() && m_GridLayers[layer].columns != 0)
+		++layer;
+	if (layer == m_GridLayers.size())
+		m_GridLayers.push_back({});
+
+	m_GridLayers[layer] = { columns, rows };
+	return layer;
+}
+
+void NullDebugRenderer2D::DestroyGridLayer(unsigned int layer)
+{
+	if (layer < m_GridLayers.size())
+		m_GridLayers[layer] = {};
+}
+
+void NullDebugRenderer2D::SetGridLayerPalette(unsigned int layer, const Color* pColors, int count)
+{
+	assert(layer < m_GridLayers.size() && m_GridLayers[layer].columns != 0 && "<NullDebugRenderer2D::SetGridLayerPalette>: invalid layer");
+	assert(count >= 0 && count <= 256 && "<NullDebugRenderer2D::SetGridLayerPalette>: a palette has at most 256 colors");
+}
+
+void NullDebugRenderer2D::UpdateGridLayer(unsigned int layer, int col, int row, int width, int height, const unsigned char* pIndices, int rowLength)
+{
+	assert(layer < m_GridLayers.size() && m_GridLayers[layer].columns != 0 && "<NullDebugRenderer2D::UpdateGridLayer>: invalid layer");
+	assert(col >= 0 && row >= 0 && col + width <= m_GridLayers[layer].columns && row + height <= m_GridLayers[layer].rows && "<NullDebugRenderer2D::UpdateGridLayer>: block lies outside the layer");
+}
+
+void NullDebugRenderer2D::DrawGridLayer(unsigned int layer, const Elite::Vector2& bottomLeft, float cellSize, const Color& outlineColor, float outlineWidth, float depth)
+{
+	assert(layer < m_GridLayers.size() && m_GridLayers[layer].columns != 0 && "<NullDebugRenderer2D::DrawGridLayer>: invalid layer");
+	++m_CurrFrame.nrOfGridLayerDraws;
+}
+#endif
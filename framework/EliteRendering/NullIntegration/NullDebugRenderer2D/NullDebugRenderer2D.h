@@ -0,0 +1,106 @@
+/*=============================================================================*/
+// Copyright 2017-2018
+// Authors: Matthieu Delaere, Thomas Goussaert
+/*=============================================================================
+NullDebugRenderer2D.h: 2D debug renderer that draws nothing, for headless runs.
+=============================================================================*/
+#ifndef ELITE_NULL_RENDERER_2D_H
+#define ELITE_NULL_RENDERER_2D_H
+
+//--- Includes ---
+#include "../../EDebugRenderer2D.h"
+#include "../../ERenderingTypes.h"
+#include "../../../EliteGeometry/EGeometry2DTypes.h"
+
+namespace Elite
+{
+	//Same interface as the SDL renderer, every draw only counts the vertices (or instances) it would submit
+	//and Render counts the draw calls the SDL renderer would make for them.
+	class NullDebugRenderer2D final : public EDebugRenderer2D<NullDebugRenderer2D>, public ESingleton<NullDebugRenderer2D>
+	{
+	public:
+		struct FrameStats
+		{
+			size_t nrOfVertices = 0;
+			size_t nrOfShapeInstances = 0;
+			unsigned int nrOfDrawCalls = 0;
+		};
+
+		//--- Constructor & Destructor ---
+		NullDebugRenderer2D() = default;
+		~NullDebugRenderer2D() = default;
+
+		//--- Functions ---
+		void Initialize(Camera2D* pActiveCamera);
+		void Render();
+		unsigned int LoadShadersToProgram(const char* vertexShaderPath, const char* fragmentShaderPath) { return 0; }
+		unsigned int LoadShadersToProgramFromEmbeddedSource(const char* vertexShader, const char* fragmentShader) { return 0; }
+
+		//--- User Functions ---
+		void DrawPolygon(Elite::Polygon* polygon, const Color& color, float depth);
+		void DrawPolygon(Elite::Polygon* polygon, const Color& color) { DrawPolygon(polygon, color, NextDepthSlice()); }
+		void DrawPolygon(const Elite::Vector2* points, int count, const Color& color, float depth) { m_CurrFrame.nrOfLineVertices += 2 * count; }
+		void DrawSolidPolygon(Elite::Polygon* polygon, const Color& color, float depth, bool triangulate = false);
+		void DrawSolidPolygon(const Elite::Polygon* polygon, const Color& color, float depth) { DrawSolidPolygon(const_cast<Elite::Polygon*>(polygon), color, depth, false); }
+		void DrawSolidPolygon(const Elite::Vector2* points, int count, const Color& color, float depth, bool triangulate = false);
+		void DrawCircle(const Elite::Vector2& center, float radius, const Color& color, float depth) { m_CurrFrame.nrOfLineVertices += 32; }
+		void DrawSolidCircle(const Elite::Vector2& center, float radius, const Elite::Vector2& axis, const Color& color, float depth);
+		void DrawSolidCircle(const Elite::Vector2& center, float radius, const Elite::Vector2& axis, const Color& color) { DrawSolidCircle(center, radius, axis, color, NextDepthSlice()); }
+		void DrawSegment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Color& color, float depth) { m_CurrFrame.nrOfLineVertices += 2; }
+		void DrawSegment(const Elite::Vector2& p1, const Elite::Vector2& p2, const Color& color) { DrawSegment(p1, p2, color, NextDepthSlice()); }
+		void DrawDirection(const Elite::Vector2& p, const Elite::Vector2& dir, float length, const Color& color, float depth = 0.9f) { m_CurrFrame.nrOfLineVertices += 2; }
+		void DrawTransform(const Elite::Vector2& p, const Elite::Vector2& xAxis, const Elite::Vector2& yAxis, float depth) { m_CurrFrame.nrOfLineVertices += 4; }
+		void DrawPoint(const Elite::Vector2& p, float size, const Color& color, float depth = 0.9f) { ++m_CurrFrame.nrOfPoints; }
+		void DrawString(int x, int y, const char* string, ...) const {}
+		void DrawString(const Elite::Vector2& pw, const char* string, ...) const {}
+
+		float NextDepthSlice();
+
+		//--- Retained Grid Layers ---
+		unsigned int CreateGridLayer(int columns, int rows);
+		void DestroyGridLayer(unsigned int layer);
+		void SetGridLayerPalette(unsigned int layer, const Color* pColors, int count);
+		void UpdateGridLayer(unsigned int layer, int col, int row, int width, int height, const unsigned char* pIndices, int rowLength);
+		void DrawGridLayer(unsigned int layer, const Elite::Vector2& bottomLeft, float cellSize, const Color& outlineColor, float outlineWidth, float depth);
+
+		//--- Instanced Shapes ---
+		void DrawSolidCircleInstance(const Elite::Vector2& center, float radius, const Color& color, float depth) { ++m_CurrFrame.nrOfCircleInstances; }
+		void DrawSolidRectInstance(const Elite::Vector2& center, float halfWidth, float rotation, const Color& color, float depth) { ++m_CurrFrame.nrOfRectInstances; }
+		void DrawArrowInstance(const Elite::Vector2& position, float radius, float rotation, const Color& color, float depth) { ++m_CurrFrame.nrOfArrowInstances; }
+
+		//--- Stats ---
+		const FrameStats& GetLastFrameStats() const { return m_LastFrameStats; }
+		const FrameStats& GetTotalStats() const { return m_TotalStats; } //summed over every rendered frame
+		unsigned int GetNrOfFrames() const { return m_NrOfFrames; }
+		size_t GetNrOfStreamedVertices() const { return m_LastFrameStats.nrOfVertices; }
+		unsigned int GetNrOfStreamStalls() const { return 0; }
+		bool IsStreamPersistentlyMapped() const { return false; }
+
+	private:
+		struct GridLayer
+		{
+			int columns = 0; //0 once destroyed
+			int rows = 0;
+		};
+
+		//Submissions of the frame that's being built, per list the SDL renderer keeps
+		struct FrameSubmissions
+		{
+			size_t nrOfLineVertices = 0;
+			size_t nrOfTriangleVertices = 0;
+			size_t nrOfPoints = 0;
+			size_t nrOfCircleInstances = 0;
+			size_t nrOfRectInstances = 0;
+			size_t nrOfArrowInstances = 0;
+			unsigned int nrOfGridLayerDraws = 0;
+		};
+
+		//--- Datamembers ---
+		FrameSubmissions m_CurrFrame = {};
+		FrameStats m_LastFrameStats = {};
+		FrameStats m_TotalStats = {};
+		unsigned int m_NrOfFrames = 0;
+		std::vector<GridLayer> m_GridLayers;
+	};
+}
+#endif
@@ -0,0 +1,17 @@
+//=== General Includes ===
+#include "stdafx.h"
+#ifdef ELITE_HEADLESS
+#include "NullFrame.h"
+#include "../../ERendering.h"
+#include "../../../EliteUI/EImmediateUI.h"
+using namespace Elite;
+
+//=== Functions ===
+void NullFrame::SubmitAndFlipFrame(EImmediateUI* pImmediateUI)
+{
+	//Still ends the frame of the renderer and the UI, so their counters and containers are reset
+	DEBUGRENDERER2D->Render();
+	if (pImmediateUI)
+		pImmediateUI->Render();
+}
+#endif
@@ -0,0 +1,29 @@
+/*=============================================================================*/
+// Copyright 2017-2018 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// NullFrame.h: Frame without a rendering context, for headless runs.
+/*=============================================================================*/
+#ifndef ELITE_NULLFRAME
+#define	ELITE_NULLFRAME
+namespace Elite
+{
+	class EImmediateUI;
+
+	//Submits to the null debug renderer, there is nothing to flip
+	class NullFrame final : public EFrameBase<NullFrame>
+	{
+	public:
+		//=== Constructors & Destructors ===
+		NullFrame() {};
+		~NullFrame() = default;
+
+		//=== Functions ===
+		void CreateFrame(EliteWindow* pWindow) { m_pWindow = pWindow; m_Context = nullptr; }
+		void SubmitAndFlipFrame(EImmediateUI* pImmediateUI = nullptr);
+		//Nothing waits on a display, frames stay on the calling thread
+		void StartRenderThread() {}
+		void StopRenderThread() {}
+	};
+}
+#endif
@@ -1,5 +1,6 @@
 //Precompiled Header [ALWAYS ON TOP IN CPP]
 #include "stdafx.h"
+#ifndef ELITE_HEADLESS
 #include "SDLDebugRenderer2D.h"
 using namespace Elite;
 
@@ -9,6 +10,9 @@ using namespace Elite;
 #define DEPTH_SLICE_MIN -0.5f//far
 #define DEPTH_SLICE_MAX 0.5f//close
 
+//Streaming Settings
+#define STREAM_REGION_INITIAL_CAPACITY 16384//vertices
+
 //Functions
 void SDLDebugRenderer2D::Initialize(Camera2D* pActiveCamera)
 {
@@ -20,6 +24,9 @@ void SDLDebugRenderer2D::Initialize(Camera2D* pActiveCamera)
 	m_vPoints.reserve(initialSize);
 	m_vLines.reserve(initialSize);
 	m_vTriangles.reserve(initialSize);
+	m_vCircleInstances.reserve(initialSize);
+	m_vRectInstances.reserve(initialSize);
+	m_vArrowInstances.reserve(initialSize);
 
 	//Create the programs we use in our framework
 	m_programID = DEBUGRENDERER2D->LoadShadersToProgramFromEmbeddedSource(DefaultVertexShaderSource, DefaultFragmentShaderSource);
@@ -30,21 +37,14 @@ void SDLDebugRenderer2D::Initialize(Camera2D* pActiveCamera)
 
 	//Generate buffers and Link attributes
 	glGenVertexArrays(1, &m_vaoId);
-	glGenBuffers(1, m_bufferIDs);
-	glBindVertexArray(m_vaoId);
-	glBindBuffer(GL_ARRAY_BUFFER, m_bufferIDs[0]);
-
-	//Specify the INTERLEAVED layout in vertices vector (MIND the SIZE and the STRIDE)!
-	glVertexAttribPointer(m_positionAttribute, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
-	glEnableVertexAttribArray(m_positionAttribute);
-	glVertexAttribPointer(m_colorAttribute, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, color)));
-	glEnableVertexAttribArray(m_colorAttribute);
-	glVertexAttribPointer(m_sizeAttribute, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, size)));
-	glEnableVertexAttribArray(m_sizeAttribute);
+	m_isStreamPersistentlyMapped = gl3wIsSupported(4, 4) != 0;
+	CreateStreamBuffer(STREAM_REGION_INITIAL_CAPACITY);
 
-	//Cleanup
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	//Retained grid layers have their own program and quad
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &m_maxTextureSize);
+	InitializeGridLayers();
+	//Instanced shapes as well
+	InitializeShapeInstances();
 
 	//Support Depth
 	glEnable(GL_DEPTH_TEST);
@@ -60,6 +60,51 @@ void SDLDebugRenderer2D::Initialize(Camera2D* pActiveCamera)
 
 void SDLDebugRenderer2D::Render()
 {
+	SubmitFrame(0);
+	RenderFrame(0);
+}
+
+void SDLDebugRenderer2D::SubmitFrame(int slot)
+{
+	assert(slot >= 0 && slot < ELITE_FRAMES_IN_FLIGHT && "<SDLDebugRenderer2D::SubmitFrame>: invalid slot");
+	RecordedFrame& frame = m_Frames[slot];
+
+	//Swap instead of copy, the slot's old lists become the next recording lists and keep their capacity
+	frame.lines.swap(m_vLines);
+	frame.triangles.swap(m_vTriangles);
+	frame.points.swap(m_vPoints);
+	frame.circleInstances.swap(m_vCircleInstances);
+	frame.rectInstances.swap(m_vRectInstances);
+	frame.arrowInstances.swap(m_vArrowInstances);
+	frame.gridLayerDraws.swap(m_vGridLayerDraws);
+	frame.gridLayerCommands.swap(m_vGridLayerCommands);
+	frame.gridLayerData.swap(m_vGridLayerData);
+	m_vLines.clear();
+	m_vTriangles.clear();
+	m_vPoints.clear();
+	m_vCircleInstances.clear();
+	m_vRectInstances.clear();
+	m_vArrowInstances.clear();
+	m_vGridLayerDraws.clear();
+	m_vGridLayerCommands.clear();
+	m_vGridLayerData.clear();
+
+	//The camera keeps moving while the frame is drawn
+	m_pActiveCamera->BuildProjectionMatrix(frame.projection, 0.0f);
+	m_nrOfStreamedVertices = frame.lines.size() + frame.triangles.size() + frame.points.size();
+
+	//Reset DepthSlice
+	m_CurrDepthSlice = DEPTH_SLICE_MAX;
+}
+
+void SDLDebugRenderer2D::RenderFrame(int slot)
+{
+	assert(slot >= 0 && slot < ELITE_FRAMES_IN_FLIGHT && "<SDLDebugRenderer2D::RenderFrame>: invalid slot");
+	const RecordedFrame& frame = m_Frames[slot];
+
+	//Texture work recorded with the frame goes first, draws of this frame can depend on it
+	ExecuteGridLayerCommands(frame);
+
 	//Clear color
 	glClear(GL_COLOR_BUFFER_BIT);
 	glClear(GL_DEPTH_BUFFER_BIT);
@@ -71,44 +116,59 @@ void SDLDebugRenderer2D::Render()
 	glBindVertexArray(m_vaoId);
 	glBindBuffer(GL_ARRAY_BUFFER, m_bufferIDs[0]);
 
-	//Build projection matrix and push to program
-	float proj[16] = { 0.0f };
-	m_pActiveCamera->BuildProjectionMatrix(proj, 0.0f);
-	glUniformMatrix4fv(m_projectionUniform, 1, GL_FALSE, proj);
+	//Push the projection of the frame to the program
+	glUniformMatrix4fv(m_projectionUniform, 1, GL_FALSE, frame.projection);
 
-	//Copy Data and Draw Lines
-	int size = m_vLines.size();
+	//Draw Grid Layers (switches programs, so rebind ours afterwards)
+	if (!frame.gridLayerDraws.empty())
+	{
+		RenderGridLayers(frame);
+		glUseProgram(m_programID);
+		glBindVertexArray(m_vaoId);
+		glBindBuffer(GL_ARRAY_BUFFER, m_bufferIDs[0]);
+	}
+
+	//Copy Data, lines, triangles and points are stored one after the other
+	int first = StreamVertices(frame);
+
+	//Draw Lines
+	int size = frame.lines.size();
 	if (size > 0)
 	{
-		glBufferData(GL_ARRAY_BUFFER, size * sizeof(Vertex), &m_vLines.front(), GL_DYNAMIC_DRAW);
-		glDrawArrays(GL_LINES, 0, size);
+		glDrawArrays(GL_LINES, first, size);
+		first += size;
 	}
 
-	//Copy Data and Draw Triangles
-	size = m_vTriangles.size();
+	//Draw Triangles
+	size = frame.triangles.size();
 	if (size > 0)
 	{
-		glBufferData(GL_ARRAY_BUFFER, size * sizeof(Vertex), &m_vTriangles.front(), GL_DYNAMIC_DRAW);
 		glEnable(GL_BLEND);
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glDrawArrays(GL_TRIANGLES, 0, size);
+		glDrawArrays(GL_TRIANGLES, first, size);
 		glDisable(GL_BLEND);
+		first += size;
 	}
 	
-	//Copy Data and Draw Point
-	size = m_vPoints.size();
+	//Draw Point
+	size = frame.points.size();
 	if (size > 0)
 	{
-		glBufferData(GL_ARRAY_BUFFER, size * sizeof(Vertex), &m_vPoints.front(), GL_DYNAMIC_DRAW);
 		glEnable(GL_PROGRAM_POINT_SIZE);
-		glDrawArrays(GL_POINTS, 0, size);
+		glDrawArrays(GL_POINTS, first, size);
 		glDisable(GL_PROGRAM_POINT_SIZE);
 	}
 
-	//Cleanup containers
-	m_vTriangles.clear();
-	m_vLines.clear();
-	m_vPoints.clear();
+	//The region can be written again once the GPU gets past these draws
+	if (!frame.lines.empty() || !frame.triangles.empty() || !frame.points.empty())
+	{
+		m_streamFences[m_currStreamRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_currStreamRegion = (m_currStreamRegion + 1) % m_NrOfStreamRegions;
+	}
+
+	//Draw Instanced Shapes (switches programs)
+	RenderShapeInstances(frame);
+
 	//Cleanup OpenGL
 	glDisable(GL_PROGRAM_POINT_SIZE);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -116,9 +176,6 @@ void SDLDebugRenderer2D::Render()
 	glUseProgram(0);
 	glFlush();
 
-	//Reset DepthSlice
-	m_CurrDepthSlice = DEPTH_SLICE_MAX;
-
 	//Search for errors
 	GLenum errCode = glGetError();
 	if (errCode != GL_NO_ERROR)
@@ -133,10 +190,430 @@ void SDLDebugRenderer2D::Shutdown()
 	m_vPoints.clear();
 	m_vLines.clear();
 	m_vTriangles.clear();
+	for (RecordedFrame& frame : m_Frames)
+		frame = {};
 
+	for (GLsync& fence : m_streamFences)
+	{
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+	if (m_pStreamVertices)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, m_bufferIDs[0]);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		m_pStreamVertices = nullptr;
+	}
 	glDeleteBuffers(1, m_bufferIDs);
+	m_bufferIDs[0] = 0;
+	m_streamRegionCapacity = 0;
 	glDeleteVertexArrays(1, &m_vaoId);
 	glDeleteProgram(m_programID);
+
+	m_vCircleInstances.clear();
+	m_vRectInstances.clear();
+	m_vArrowInstances.clear();
+	glDeleteBuffers(1, &m_shapeMeshBufferID);
+	glDeleteBuffers(1, &m_shapeInstanceBufferID);
+	glDeleteVertexArrays(1, &m_shapeVaoId);
+	glDeleteProgram(m_shapeProgramID);
+	m_shapeInstanceCapacity = 0;
+
+	for (unsigned int layer = 0; layer < m_GridLayers.size(); ++layer)
+		DeleteGridLayerTextures(layer);
+	m_GridLayers.clear();
+	m_RecordedGridLayers.clear();
+	m_vGridLayerDraws.clear();
+	m_vGridLayerCommands.clear();
+	m_vGridLayerData.clear();
+	glDeleteBuffers(1, &m_gridBufferID);
+	glDeleteVertexArrays(1, &m_gridVaoId);
+	glDeleteProgram(m_gridProgramID);
+}
+
+//Streaming Vertex Buffer
+void SDLDebugRenderer2D::CreateStreamBuffer(size_t regionCapacity)
+{
+	//Nothing may still read from the old buffer's regions, GL keeps the buffer alive until the GPU is done with it
+	for (GLsync& fence : m_streamFences)
+	{
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	glBindVertexArray(m_vaoId);
+	if (m_bufferIDs[0] != 0)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, m_bufferIDs[0]);
+		if (m_pStreamVertices)
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+		glDeleteBuffers(1, m_bufferIDs);
+		m_pStreamVertices = nullptr;
+	}
+
+	glGenBuffers(1, m_bufferIDs);
+	glBindBuffer(GL_ARRAY_BUFFER, m_bufferIDs[0]);
+	const GLsizeiptr bufferSize = GLsizeiptr(regionCapacity * m_NrOfStreamRegions * sizeof(Vertex));
+	if (m_isStreamPersistentlyMapped)
+	{
+		//Mapped once for the lifetime of the buffer, coherent so writes don't need to be flushed
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_ARRAY_BUFFER, bufferSize, nullptr, flags);
+		m_pStreamVertices = static_cast<Vertex*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bufferSize, flags));
+		if (!m_pStreamVertices)
+		{
+			//Storage is immutable, so mapping every frame needs a new buffer
+			glDeleteBuffers(1, m_bufferIDs);
+			glGenBuffers(1, m_bufferIDs);
+			glBindBuffer(GL_ARRAY_BUFFER, m_bufferIDs[0]);
+			m_isStreamPersistentlyMapped = false;
+		}
+	}
+	if (!m_isStreamPersistentlyMapped)
+		glBufferData(GL_ARRAY_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+	m_streamRegionCapacity = regionCapacity;
+	m_currStreamRegion = 0;
+
+	//Specify the INTERLEAVED layout in vertices vector (MIND the SIZE and the STRIDE)!
+	glVertexAttribPointer(m_positionAttribute, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
+	glEnableVertexAttribArray(m_positionAttribute);
+	glVertexAttribPointer(m_colorAttribute, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, color)));
+	glEnableVertexAttribArray(m_colorAttribute);
+	glVertexAttribPointer(m_sizeAttribute, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, size)));
+	glEnableVertexAttribArray(m_sizeAttribute);
+
+	//Cleanup
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+int SDLDebugRenderer2D::StreamVertices(const RecordedFrame& frame)
+{
+	const size_t nrOfVertices = frame.lines.size() + frame.triangles.size() + frame.points.size();
+	if (nrOfVertices == 0)
+		return 0;
+
+	//Grow geometrically, so a scene that keeps growing only reallocates a few times
+	if (nrOfVertices > m_streamRegionCapacity)
+	{
+		size_t regionCapacity = m_streamRegionCapacity;
+		while (regionCapacity < nrOfVertices)
+			regionCapacity *= 2;
+
+		CreateStreamBuffer(regionCapacity);
+		glBindVertexArray(m_vaoId);
+		glBindBuffer(GL_ARRAY_BUFFER, m_bufferIDs[0]);
+	}
+
+	//Wait until the GPU has drawn the frame that last used this region, only when the CPU runs more than two frames ahead
+	GLsync& fence = m_streamFences[m_currStreamRegion];
+	if (fence)
+	{
+		if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+		{
+			++m_nrOfStreamStalls;
+			while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+		}
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	const size_t firstVertex = m_currStreamRegion * m_streamRegionCapacity;
+	Vertex* pVertices = m_pStreamVertices ? m_pStreamVertices + firstVertex
+		: static_cast<Vertex*>(glMapBufferRange(GL_ARRAY_BUFFER, GLintptr(firstVertex * sizeof(Vertex)), GLsizeiptr(nrOfVertices * sizeof(Vertex)),
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+
+	pVertices = std::copy(frame.lines.begin(), frame.lines.end(), pVertices);
+	pVertices = std::copy(frame.triangles.begin(), frame.triangles.end(), pVertices);
+	std::copy(frame.points.begin(), frame.points.end(), pVertices);
+
+	if (!m_pStreamVertices)
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+
+	return int(firstVertex);
+}
+
+//Retained Grid Layers
+void SDLDebugRenderer2D::InitializeGridLayers()
+{
+	m_gridProgramID = LoadShadersToProgramFromEmbeddedSource(GridVertexShaderSource, GridFragmentShaderSource);
+
+	//Unit quad, the vertex shader stretches it over the grid
+	const float corners[8] = { 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 1.f, 1.f };
+	glGenVertexArrays(1, &m_gridVaoId);
+	glGenBuffers(1, &m_gridBufferID);
+	glBindVertexArray(m_gridVaoId);
+	glBindBuffer(GL_ARRAY_BUFFER, m_gridBufferID);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+	glEnableVertexAttribArray(0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+unsigned int SDLDebugRenderer2D::CreateGridLayer(int columns, int rows)
+{
+	assert(columns > 0 && rows > 0 && columns <= m_maxTextureSize && rows <= m_maxTextureSize && "<SDLDebugRenderer2D::CreateGridLayer>: the cells have to fit in one texture");
+
+	//Reuse the slot of a destroyed layer, the render side follows the same slots when it replays the commands
+	unsigned int layer = 0;
+	while (layer < m_RecordedGridLayers.size() && m_RecordedGridLayers[layer].columns != 0)
+		++layer;
+	if (layer == m_RecordedGridLayers.size())
+		m_RecordedGridLayers.push_back({});
+
+	m_RecordedGridLayers[layer].columns = columns;
+	m_RecordedGridLayers[layer].rows = rows;
+	m_vGridLayerCommands.push_back({ GridLayerCommand::Type::Create, layer, 0, 0, columns, rows, 0 });
+	return layer;
+}
+
+void SDLDebugRenderer2D::DestroyGridLayer(unsigned int layer)
+{
+	if (layer >= m_RecordedGridLayers.size() || m_RecordedGridLayers[layer].columns == 0)
+		return;
+
+	m_RecordedGridLayers[layer] = {};
+	m_vGridLayerCommands.push_back({ GridLayerCommand::Type::Destroy, layer, 0, 0, 0, 0, 0 });
+}
+
+void SDLDebugRenderer2D::SetGridLayerPalette(unsigned int layer, const Color* pColors, int count)
+{
+	assert(layer < m_RecordedGridLayers.size() && m_RecordedGridLayers[layer].columns != 0 && "<SDLDebugRenderer2D::SetGridLayerPalette>: invalid layer");
+	assert(count >= 0 && count <= 256 && "<SDLDebugRenderer2D::SetGridLayerPalette>: a palette has at most 256 colors");
+
+	if (count == 0)
+		return;
+
+	const size_t dataOffset = m_vGridLayerData.size();
+	const unsigned char* pBytes = reinterpret_cast<const unsigned char*>(pColors);
+	m_vGridLayerData.insert(m_vGridLayerData.end(), pBytes, pBytes + count * sizeof(Color));
+	m_vGridLayerCommands.push_back({ GridLayerCommand::Type::SetPalette, layer, 0, 0, count, 1, dataOffset });
+}
+
+void SDLDebugRenderer2D::UpdateGridLayer(unsigned int layer, int col, int row, int width, int height, const unsigned char* pIndices, int rowLength)
+{
+	assert(layer < m_RecordedGridLayers.size() && m_RecordedGridLayers[layer].columns != 0 && "<SDLDebugRenderer2D::UpdateGridLayer>: invalid layer");
+	assert(col >= 0 && row >= 0 && col + width <= m_RecordedGridLayers[layer].columns && row + height <= m_RecordedGridLayers[layer].rows && "<SDLDebugRenderer2D::UpdateGridLayer>: block lies outside the layer");
+
+	if (width <= 0 || height <= 0)
+		return;
+
+	//The caller's cells can change before the frame is drawn, so the block is copied tightly packed
+	const size_t dataOffset = m_vGridLayerData.size();
+	for (int r = 0; r < height; ++r)
+	{
+		const unsigned char* pRow = pIndices + static_cast<size_t>(r) * rowLength;
+		m_vGridLayerData.insert(m_vGridLayerData.end(), pRow, pRow + width);
+	}
+	m_vGridLayerCommands.push_back({ GridLayerCommand::Type::Update, layer, col, row, width, height, dataOffset });
+}
+
+void SDLDebugRenderer2D::DrawGridLayer(unsigned int layer, const Elite::Vector2& bottomLeft, float cellSize, const Color& outlineColor, float outlineWidth, float depth)
+{
+	assert(layer < m_RecordedGridLayers.size() && m_RecordedGridLayers[layer].columns != 0 && "<SDLDebugRenderer2D::DrawGridLayer>: invalid layer");
+	m_vGridLayerDraws.push_back({ layer, bottomLeft, cellSize, outlineColor, outlineWidth, depth });
+}
+
+void SDLDebugRenderer2D::ExecuteGridLayerCommands(const RecordedFrame& frame)
+{
+	for (const GridLayerCommand& command : frame.gridLayerCommands)
+	{
+		if (command.type == GridLayerCommand::Type::Create)
+		{
+			if (command.layer >= m_GridLayers.size())
+				m_GridLayers.resize(command.layer + 1);
+
+			GridLayer& gridLayer = m_GridLayers[command.layer];
+			gridLayer.columns = command.width;
+			gridLayer.rows = command.height;
+
+			//Integer texture, so indices are fetched as they are: no filtering, no mipmaps
+			const std::vector<unsigned char> indices(static_cast<size_t>(command.width) * command.height, 0);
+			glGenTextures(1, &gridLayer.cellTextureID);
+			glBindTexture(GL_TEXTURE_2D, gridLayer.cellTextureID);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, command.width, command.height, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, indices.data());
+
+			const std::vector<Color> palette(256, Color{});
+			glGenTextures(1, &gridLayer.paletteTextureID);
+			glBindTexture(GL_TEXTURE_2D, gridLayer.paletteTextureID);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, 256, 1, 0, GL_RGBA, GL_FLOAT, palette.data());
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+		else if (command.type == GridLayerCommand::Type::Destroy)
+		{
+			DeleteGridLayerTextures(command.layer);
+		}
+		else if (command.type == GridLayerCommand::Type::SetPalette)
+		{
+			glBindTexture(GL_TEXTURE_2D, m_GridLayers[command.layer].paletteTextureID);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, command.width, 1, GL_RGBA, GL_FLOAT, frame.gridLayerData.data() + command.dataOffset);
+		}
+		else
+		{
+			glBindTexture(GL_TEXTURE_2D, m_GridLayers[command.layer].cellTextureID);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, command.col, command.row, command.width, command.height, GL_RED_INTEGER, GL_UNSIGNED_BYTE,
+				frame.gridLayerData.data() + command.dataOffset);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void SDLDebugRenderer2D::DeleteGridLayerTextures(unsigned int layer)
+{
+	if (layer >= m_GridLayers.size() || m_GridLayers[layer].cellTextureID == 0)
+		return;
+
+	glDeleteTextures(1, &m_GridLayers[layer].cellTextureID);
+	glDeleteTextures(1, &m_GridLayers[layer].paletteTextureID);
+	m_GridLayers[layer] = {};
+}
+
+void SDLDebugRenderer2D::RenderGridLayers(const RecordedFrame& frame)
+{
+	glUseProgram(m_gridProgramID);
+	glBindVertexArray(m_gridVaoId);
+	glUniformMatrix4fv(glGetUniformLocation(m_gridProgramID, "projectionMatrix"), 1, GL_FALSE, frame.projection);
+	glUniform1i(glGetUniformLocation(m_gridProgramID, "cells"), 0);
+	glUniform1i(glGetUniformLocation(m_gridProgramID, "palette"), 1);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	for (const GridLayerDraw& draw : frame.gridLayerDraws)
+	{
+		const GridLayer& gridLayer = m_GridLayers[draw.layer];
+		if (gridLayer.cellTextureID == 0)
+			continue;
+
+		glUniform2f(glGetUniformLocation(m_gridProgramID, "gridOrigin"), draw.bottomLeft.x, draw.bottomLeft.y);
+		glUniform2f(glGetUniformLocation(m_gridProgramID, "gridSize"), float(gridLayer.columns), float(gridLayer.rows));
+		glUniform1f(glGetUniformLocation(m_gridProgramID, "cellSize"), draw.cellSize);
+		glUniform1f(glGetUniformLocation(m_gridProgramID, "depth"), draw.depth);
+		glUniform4f(glGetUniformLocation(m_gridProgramID, "outlineColor"), draw.outlineColor.r, draw.outlineColor.g, draw.outlineColor.b, draw.outlineColor.a);
+		glUniform1f(glGetUniformLocation(m_gridProgramID, "outlineWidth"), draw.outlineWidth);
+
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, gridLayer.cellTextureID);
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, gridLayer.paletteTextureID);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
+
+	glDisable(GL_BLEND);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+//Instanced Shapes
+void SDLDebugRenderer2D::InitializeShapeInstances()
+{
+	m_shapeProgramID = LoadShadersToProgramFromEmbeddedSource(ShapeVertexShaderSource, ShapeFragmentShaderSource);
+	m_shapeUniform = glGetUniformLocation(m_shapeProgramID, "shape");
+
+	//Unit rect (also used for circles) as two triangles, then the arrow pointing down before it's rotated
+	const float corners[18] = {
+		-1.f, -1.f, 1.f, -1.f, 1.f, 1.f,
+		-1.f, -1.f, 1.f, 1.f, -1.f, 1.f,
+		0.f, -1.f, 0.5f, 0.8660254f, -0.5f, 0.8660254f };
+	glGenVertexArrays(1, &m_shapeVaoId);
+	glGenBuffers(1, &m_shapeMeshBufferID);
+	glGenBuffers(1, &m_shapeInstanceBufferID);
+	glBindVertexArray(m_shapeVaoId);
+	glBindBuffer(GL_ARRAY_BUFFER, m_shapeMeshBufferID);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+	glEnableVertexAttribArray(0);
+
+	//Instance attributes advance once per shape, their pointers are set per draw
+	for (unsigned int attribute = 1; attribute <= 3; ++attribute)
+	{
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribDivisor(attribute, 1);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+void SDLDebugRenderer2D::RenderShapeInstances(const RecordedFrame& frame)
+{
+	const size_t nrOfInstances = frame.circleInstances.size() + frame.rectInstances.size() + frame.arrowInstances.size();
+	if (nrOfInstances == 0)
+		return;
+
+	//Orphan the storage every frame so the upload doesn't wait for last frame's draws, only reallocate when it needs to grow
+	glBindVertexArray(m_shapeVaoId);
+	glBindBuffer(GL_ARRAY_BUFFER, m_shapeInstanceBufferID);
+	if (nrOfInstances > m_shapeInstanceCapacity)
+	{
+		m_shapeInstanceCapacity = m_shapeInstanceCapacity > 0 ? m_shapeInstanceCapacity : 512;
+		while (m_shapeInstanceCapacity < nrOfInstances)
+			m_shapeInstanceCapacity *= 2;
+	}
+	glBufferData(GL_ARRAY_BUFFER, m_shapeInstanceCapacity * sizeof(ShapeInstance), nullptr, GL_STREAM_DRAW);
+
+	GLintptr offset = 0;
+	const std::vector<ShapeInstance>* instanceLists[3] = { &frame.circleInstances, &frame.rectInstances, &frame.arrowInstances };
+	for (const std::vector<ShapeInstance>* pInstances : instanceLists)
+	{
+		if (pInstances->empty())
+			continue;
+
+		glBufferSubData(GL_ARRAY_BUFFER, offset, pInstances->size() * sizeof(ShapeInstance), pInstances->data());
+		offset += pInstances->size() * sizeof(ShapeInstance);
+	}
+
+	glUseProgram(m_shapeProgramID);
+	glUniformMatrix4fv(glGetUniformLocation(m_shapeProgramID, "projectionMatrix"), 1, GL_FALSE, frame.projection);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	//One draw per kind of shape, circles and rects share the rect mesh
+	const int meshFirst[3] = { 0, 0, 6 };
+	const int meshCount[3] = { 6, 6, 3 };
+	offset = 0;
+	for (int shape = 0; shape < 3; ++shape)
+	{
+		const std::vector<ShapeInstance>& instances = *instanceLists[shape];
+		if (instances.empty())
+			continue;
+
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ShapeInstance), reinterpret_cast<void*>(offset + offsetof(ShapeInstance, position)));
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ShapeInstance), reinterpret_cast<void*>(offset + offsetof(ShapeInstance, color)));
+		glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(ShapeInstance), reinterpret_cast<void*>(offset + offsetof(ShapeInstance, depth)));
+		glUniform1i(m_shapeUniform, shape);
+		glDrawArraysInstanced(GL_TRIANGLES, meshFirst[shape], meshCount[shape], GLsizei(instances.size()));
+		offset += instances.size() * sizeof(ShapeInstance);
+	}
+
+	glDisable(GL_BLEND);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+void SDLDebugRenderer2D::DrawSolidCircleInstance(const Elite::Vector2& center, float radius, const Color& color, float depth)
+{
+	m_vCircleInstances.push_back({ center, radius, 0.f, color, depth });
+}
+
+void SDLDebugRenderer2D::DrawSolidRectInstance(const Elite::Vector2& center, float halfWidth, float rotation, const Color& color, float depth)
+{
+	m_vRectInstances.push_back({ center, halfWidth, rotation, color, depth });
+}
+
+void SDLDebugRenderer2D::DrawArrowInstance(const Elite::Vector2& position, float radius, float rotation, const Color& color, float depth)
+{
+	m_vArrowInstances.push_back({ position, radius, rotation, color, depth });
 }
 
 void SDLDebugRenderer2D::DrawPolygon(Elite::Polygon* polygon, const Color& color, float depth)
@@ -638,4 +1115,5 @@ unsigned int SDLDebugRenderer2D::LoadShadersToProgramFromEmbeddedSource(const ch
 
 	//IMPORTANT, return our program ID!
 	return programID;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
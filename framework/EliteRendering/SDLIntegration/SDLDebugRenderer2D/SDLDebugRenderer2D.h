@@ -12,6 +12,7 @@ DebugRenderer2D.h: OpenGL immediate 2D debug renderer, used for drawing 2D shape
 #include "../../ERenderingTypes.h"
 #include "../../../EliteGeometry/EGeometry2DTypes.h"
 #include "../../Shaders.h"
+#include <atomic>
 
 namespace Elite
 {
@@ -24,7 +25,12 @@ namespace Elite
 
 		//--- Functions ---
 		void Initialize(Camera2D* pActiveCamera);
-		void Render();
+		void Render(); //SubmitFrame and RenderFrame in one go, on the thread that owns the context
+		//Moves everything recorded since the last submit into a frame slot, the recording lists are free again when it returns.
+		//Draw calls only touch the recording lists of the calling thread, so they need no locking.
+		void SubmitFrame(int slot);
+		//Draws a submitted slot, on the thread that owns the GL context (the render thread while one runs)
+		void RenderFrame(int slot);
 		unsigned int LoadShadersToProgram(const char* vertexShaderPath, const char* fragmentShaderPath);
 		unsigned int LoadShadersToProgramFromEmbeddedSource(const char* vertexShader, const char* fragmentShader);
 
@@ -48,7 +54,84 @@ namespace Elite
 
 		inline float NextDepthSlice();
 
+		//--- Retained Grid Layers ---
+		//Cells keep a palette index in a texture that stays on the GPU, only the cells that change get uploaded again.
+		//A layer is drawn as a single quad, so the cost of a frame doesn't depend on the number of cells.
+		unsigned int CreateGridLayer(int columns, int rows);
+		void DestroyGridLayer(unsigned int layer);
+		//colors for the palette indices, at most 256
+		void SetGridLayerPalette(unsigned int layer, const Color* pColors, int count);
+		//uploads the block of cells starting at (col, row), pIndices holds rowLength indices per row
+		void UpdateGridLayer(unsigned int layer, int col, int row, int width, int height, const unsigned char* pIndices, int rowLength);
+		//draws the layer this frame, outlines are outlineWidth pixels wide (0 draws none)
+		void DrawGridLayer(unsigned int layer, const Elite::Vector2& bottomLeft, float cellSize, const Color& outlineColor, float outlineWidth, float depth);
+
+		//--- Instanced Shapes ---
+		//A shape is stored as a single instance and expanded by the vertex shader, each kind of shape costs one draw call.
+		//Filled with half the color and outlined with the color (except arrows), rotations are in radians.
+		void DrawSolidCircleInstance(const Elite::Vector2& center, float radius, const Color& color, float depth);
+		void DrawSolidRectInstance(const Elite::Vector2& center, float halfWidth, float rotation, const Color& color, float depth);
+		void DrawArrowInstance(const Elite::Vector2& position, float radius, float rotation, const Color& color, float depth);
+
+		//--- Streaming Stats ---
+		size_t GetNrOfStreamedVertices() const { return m_nrOfStreamedVertices; } //vertices sent by the last submitted frame
+		unsigned int GetNrOfStreamStalls() const { return m_nrOfStreamStalls.load(); } //frames that had to wait for the GPU to free a region
+		bool IsStreamPersistentlyMapped() const { return m_isStreamPersistentlyMapped; }
+
 	private:
+		struct GridLayer
+		{
+			unsigned int cellTextureID = 0;
+			unsigned int paletteTextureID = 0;
+			int columns = 0;
+			int rows = 0;
+		};
+
+		struct ShapeInstance
+		{
+			Elite::Vector2 position;
+			float size; //radius, or half the width of a rect
+			float rotation;
+			Color color;
+			float depth;
+		};
+
+		struct GridLayerDraw
+		{
+			unsigned int layer;
+			Elite::Vector2 bottomLeft;
+			float cellSize;
+			Color outlineColor;
+			float outlineWidth;
+			float depth;
+		};
+
+		//Texture work is recorded as well and replayed in order before the frame is drawn, the data lives in the frame
+		struct GridLayerCommand
+		{
+			enum class Type { Create, Destroy, SetPalette, Update };
+			Type type;
+			unsigned int layer;
+			int col, row; //Update
+			int width, height; //Create: columns and rows, SetPalette: number of colors
+			size_t dataOffset; //in bytes, SetPalette and Update
+		};
+
+		//Everything a frame needs to be drawn without looking at the recording side
+		struct RecordedFrame
+		{
+			std::vector<Vertex> lines;
+			std::vector<Vertex> triangles;
+			std::vector<Vertex> points;
+			std::vector<ShapeInstance> circleInstances;
+			std::vector<ShapeInstance> rectInstances;
+			std::vector<ShapeInstance> arrowInstances;
+			std::vector<GridLayerDraw> gridLayerDraws;
+			std::vector<GridLayerCommand> gridLayerCommands;
+			std::vector<unsigned char> gridLayerData;
+			float projection[16] = {};
+		};
+
 		//--- Datamembers ---
 		//PROGRAM, VERTEX & ATTRIBUTE DATA
 		unsigned int m_programID = 0;
@@ -59,7 +142,55 @@ namespace Elite
 		unsigned int m_vaoId = 0;
 		unsigned int m_bufferIDs[1];
 
+		//STREAMING VERTEX BUFFER
+		//The buffer is split in regions, every frame writes all its vertices in the next one. A fence per region tells
+		//when the GPU is done drawing from it, so vertices still in flight never get overwritten and the storage never gets reallocated.
+		//TODO: not measured on a GPU yet. Compare vertices per second against the per frame glBufferData path (before this buffer)
+		//in a stress scene, the A* app on a large grid with connections on, for both the persistent and the unsynchronized path,
+		//and check the stall counter stays at 0.
+		static const int m_NrOfStreamRegions = 3;
+		bool m_isStreamPersistentlyMapped = false; //GL 4.4 buffer storage, otherwise every frame maps its region unsynchronized
+		Vertex* m_pStreamVertices = nullptr; //the whole buffer while it is persistently mapped
+		size_t m_streamRegionCapacity = 0; //in vertices
+		int m_currStreamRegion = 0;
+		GLsync m_streamFences[m_NrOfStreamRegions] = {};
+		size_t m_nrOfStreamedVertices = 0;
+		std::atomic<unsigned int> m_nrOfStreamStalls{ 0 }; //counted on the render thread
+
+		//GRID LAYERS
+		unsigned int m_gridProgramID = 0;
+		unsigned int m_gridVaoId = 0;
+		unsigned int m_gridBufferID = 0;
+		std::vector<GridLayer> m_GridLayers; //render side, destroyed layers keep a zeroed slot
+		std::vector<GridLayer> m_RecordedGridLayers; //recording side, only the sizes are used
+		int m_maxTextureSize = 0;
+		std::vector<GridLayerDraw> m_vGridLayerDraws;
+		std::vector<GridLayerCommand> m_vGridLayerCommands;
+		std::vector<unsigned char> m_vGridLayerData;
+
+		//INSTANCED SHAPES
+		unsigned int m_shapeProgramID = 0;
+		int m_shapeUniform = 0;
+		unsigned int m_shapeVaoId = 0;
+		unsigned int m_shapeMeshBufferID = 0; //unit rect followed by the unit arrow
+		unsigned int m_shapeInstanceBufferID = 0;
+		size_t m_shapeInstanceCapacity = 0;
+		std::vector<ShapeInstance> m_vCircleInstances;
+		std::vector<ShapeInstance> m_vRectInstances;
+		std::vector<ShapeInstance> m_vArrowInstances;
+
+		//FRAME SLOTS
+		RecordedFrame m_Frames[ELITE_FRAMES_IN_FLIGHT];
+
 		//Functions
+		void CreateStreamBuffer(size_t regionCapacity);
+		int StreamVertices(const RecordedFrame& frame); //copies the frame's vertices in the next region, returns the index of the first one
+		void InitializeGridLayers();
+		void ExecuteGridLayerCommands(const RecordedFrame& frame);
+		void DeleteGridLayerTextures(unsigned int layer);
+		void RenderGridLayers(const RecordedFrame& frame);
+		void InitializeShapeInstances();
+		void RenderShapeInstances(const RecordedFrame& frame);
 		void Shutdown();
 	};
 }
@@ -1,5 +1,6 @@
 //=== General Includes ===
 #include "stdafx.h"
+#ifndef ELITE_HEADLESS
 #include "SDLFrame.h"
 #include "../../ERendering.h"
 #include "../../../EliteUI/EImmediateUI.h"
@@ -8,6 +9,8 @@ using namespace Elite;
 //=== Constructors & Destructors ===
 SDLFrame::~SDLFrame()
 {
+	StopRenderThread();
+
 	//Destroy Context
 	SDL_GL_DeleteContext(m_Context);
 }
@@ -39,19 +42,116 @@ void SDLFrame::CreateFrame(EliteWindow* pWindow)
 
 void SDLFrame::SubmitAndFlipFrame(EImmediateUI* pImmediateUI)
 {
-	//Set Viewport Size
 	auto windowParams = m_pWindow->GetCurrentWindowParameters();
-	glViewport(0, 0, windowParams.width, windowParams.height);
+	if (!m_RenderThread.joinable())
+	{
+		//Set Viewport Size
+		glViewport(0, 0, windowParams.width, windowParams.height);
+
+		//Set clear color and clear current render target
+		glClearColor(m_ClearColor.r, m_ClearColor.g, m_ClearColor.b, m_ClearColor.a);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	//Set clear color and clear current render target
-	glClearColor(m_ClearColor.r, m_ClearColor.g, m_ClearColor.b, m_ClearColor.a);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		//Render all current scenegraph elements
+		DEBUGRENDERER2D->Render();
+		if (pImmediateUI)
+			pImmediateUI->Render();
+
+		//Swap buffers (aka Flip)
+		SDL_GL_SwapWindow(m_pWindow->GetRawWindowHandle());
+		return;
+	}
 
-	//Render all current scenegraph elements
-	DEBUGRENDERER2D->Render();
+	//Wait for a free slot, only blocks when the render thread is a whole frame behind
+	unsigned int frame = 0;
+	{
+		std::unique_lock<std::mutex> lock(m_FrameMutex);
+		m_FrameCondition.wait(lock, [this]() { return m_NrOfSubmittedFrames - m_NrOfRenderedFrames < ELITE_FRAMES_IN_FLIGHT; });
+		frame = m_NrOfSubmittedFrames;
+	}
+
+	//The render thread never touches this slot until it's handed over below
+	const int slot = int(frame % ELITE_FRAMES_IN_FLIGHT);
+	DEBUGRENDERER2D->SubmitFrame(slot);
 	if (pImmediateUI)
-		pImmediateUI->Render();
+		pImmediateUI->SubmitFrame(slot);
+	m_SubmittedFrames[slot] = { pImmediateUI, windowParams.width, windowParams.height };
+
+	{
+		std::lock_guard<std::mutex> lock(m_FrameMutex);
+		++m_NrOfSubmittedFrames;
+	}
+	m_FrameCondition.notify_all();
+}
+
+void SDLFrame::StartRenderThread()
+{
+	if (m_RenderThread.joinable())
+		return;
+
+	//A context is current on one thread at a time
+	SDL_GL_MakeCurrent(m_pWindow->GetRawWindowHandle(), nullptr);
+	m_StopRenderThread = false;
+	m_RenderThread = std::thread(&SDLFrame::RenderThreadLoop, this);
+}
+
+void SDLFrame::StopRenderThread()
+{
+	if (!m_RenderThread.joinable())
+		return;
 
-	//Swap buffers (aka Flip)
-	SDL_GL_SwapWindow(m_pWindow->GetRawWindowHandle());
-}
\ No newline at end of file
+	//Frames that are already submitted still get drawn
+	{
+		std::lock_guard<std::mutex> lock(m_FrameMutex);
+		m_StopRenderThread = true;
+	}
+	m_FrameCondition.notify_all();
+	m_RenderThread.join();
+
+	//Resources get destroyed on this thread again
+	SDL_GL_MakeCurrent(m_pWindow->GetRawWindowHandle(), m_Context);
+}
+
+void SDLFrame::RenderThreadLoop()
+{
+	SDL_GL_MakeCurrent(m_pWindow->GetRawWindowHandle(), m_Context);
+
+	while (true)
+	{
+		unsigned int frame = 0;
+		{
+			std::unique_lock<std::mutex> lock(m_FrameMutex);
+			m_FrameCondition.wait(lock, [this]() { return m_NrOfRenderedFrames != m_NrOfSubmittedFrames || m_StopRenderThread; });
+			if (m_NrOfRenderedFrames == m_NrOfSubmittedFrames)
+				break;
+			frame = m_NrOfRenderedFrames;
+		}
+
+		const int slot = int(frame % ELITE_FRAMES_IN_FLIGHT);
+		const SubmittedFrame& submittedFrame = m_SubmittedFrames[slot];
+
+		//Set Viewport Size
+		glViewport(0, 0, submittedFrame.width, submittedFrame.height);
+
+		//Set clear color and clear current render target
+		glClearColor(m_ClearColor.r, m_ClearColor.g, m_ClearColor.b, m_ClearColor.a);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		//Render the recorded frame
+		DEBUGRENDERER2D->RenderFrame(slot);
+		if (submittedFrame.pImmediateUI)
+			submittedFrame.pImmediateUI->RenderFrame(slot);
+
+		//Swap buffers (aka Flip), waits for VSync on this thread instead of the update
+		SDL_GL_SwapWindow(m_pWindow->GetRawWindowHandle());
+
+		{
+			std::lock_guard<std::mutex> lock(m_FrameMutex);
+			++m_NrOfRenderedFrames;
+		}
+		m_FrameCondition.notify_all();
+	}
+
+	SDL_GL_MakeCurrent(m_pWindow->GetRawWindowHandle(), nullptr);
+}
+#endif
\ No newline at end of file
@@ -6,6 +6,11 @@
 /*=============================================================================*/
 #ifndef ELITE_SDLFRAME
 #define	ELITE_SDLFRAME
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 namespace Elite
 {
 	//Override the typedef with the correct type (by default void*)
@@ -26,8 +31,28 @@ namespace Elite
 		void CreateFrame(EliteWindow* pWindow);
 		void SubmitAndFlipFrame(EImmediateUI* pImmediateUI = nullptr);
 
+		//While the render thread runs it owns the GL context: a submitted frame is drawn while the next one gets updated and recorded.
+		//Without it everything is drawn on the calling thread, as before.
+		void StartRenderThread();
+		void StopRenderThread();
+
 	private:
+		struct SubmittedFrame
+		{
+			EImmediateUI* pImmediateUI = nullptr;
+			int width = 0;
+			int height = 0;
+		};
+
+		std::thread m_RenderThread;
+		std::mutex m_FrameMutex;
+		std::condition_variable m_FrameCondition;
+		SubmittedFrame m_SubmittedFrames[ELITE_FRAMES_IN_FLIGHT];
+		unsigned int m_NrOfSubmittedFrames = 0; //guarded by m_FrameMutex
+		unsigned int m_NrOfRenderedFrames = 0; //guarded by m_FrameMutex
+		bool m_StopRenderThread = false; //guarded by m_FrameMutex
 
+		void RenderThreadLoop();
 	};
 }
 #endif
\ No newline at end of file
@@ -52,4 +52,85 @@ static const char* ImGuiFragmentShaderSource =
 "// Output data\n"
 "out vec4 color;\n"
 "void main(void)\n"
-"{ color = f_color * texture(_texture, f_uv.st); }\n";
\ No newline at end of file
+"{ color = f_color * texture(_texture, f_uv.st); }\n";
+
+// Retained grid layers: one quad over the whole grid, every fragment looks up its cell's palette index and the palette color.
+// Outlines are drawn where the fragment is within outlineWidth pixels of a cell edge.
+static const char* GridVertexShaderSource =
+"#version 400\n"
+"// Input vertex data\n"
+"uniform mat4 projectionMatrix;\n"
+"uniform vec2 gridOrigin;\n"
+"uniform vec2 gridSize;\n"
+"uniform float cellSize;\n"
+"uniform float depth;\n"
+"layout(location = 0) in vec2 v_corner;\n"
+"// Output vertex data\n"
+"out vec2 f_cell;\n"
+"void main(void)\n"
+"{\n"
+"	f_cell = v_corner * gridSize;\n"
+"	gl_Position = projectionMatrix * vec4(gridOrigin + f_cell * cellSize, 0.0f, 1.0f);\n"
+"	gl_Position.z = depth;\n"
+"}\n";
+
+static const char* GridFragmentShaderSource =
+"#version 400\n"
+"// Input data\n"
+"uniform usampler2D cells;\n"
+"uniform sampler2D palette;\n"
+"uniform vec4 outlineColor;\n"
+"uniform float outlineWidth;\n"
+"in vec2 f_cell;\n"
+"// Output data\n"
+"out vec4 color;\n"
+"void main(void)\n"
+"{\n"
+"	ivec2 cell = clamp(ivec2(floor(f_cell)), ivec2(0), textureSize(cells, 0) - 1);\n"
+"	color = texelFetch(palette, ivec2(int(texelFetch(cells, cell, 0).r), 0), 0);\n"
+"	vec2 edgeDistance = min(fract(f_cell), 1.0f - fract(f_cell)) / fwidth(f_cell);\n"
+"	if (min(edgeDistance.x, edgeDistance.y) < 0.5f * outlineWidth)\n"
+"		color = outlineColor;\n"
+"}\n";
+
+// Instanced shapes: a unit shape per vertex, moved, scaled and rotated by the instance. Circles are quads that discard the corners.
+// Inside is filled with half the instance color, a one pixel rim with the full color (not for arrows).
+static const char* ShapeVertexShaderSource =
+"#version 400\n"
+"// Input vertex data\n"
+"uniform mat4 projectionMatrix;\n"
+"layout(location = 0) in vec2 v_corner;\n"
+"layout(location = 1) in vec4 i_transform;\n" //position, size, rotation
+"layout(location = 2) in vec4 i_color;\n"
+"layout(location = 3) in float i_depth;\n"
+"// Output vertex data\n"
+"out vec2 f_local;\n"
+"out vec4 f_color;\n"
+"void main(void)\n"
+"{\n"
+"	f_local = v_corner;\n"
+"	f_color = i_color;\n"
+"	float s = sin(i_transform.w);\n"
+"	float c = cos(i_transform.w);\n"
+"	vec2 position = i_transform.xy + i_transform.z * vec2(c * v_corner.x - s * v_corner.y, s * v_corner.x + c * v_corner.y);\n"
+"	gl_Position = projectionMatrix * vec4(position, 0.0f, 1.0f);\n"
+"	gl_Position.z = i_depth;\n"
+"}\n";
+
+static const char* ShapeFragmentShaderSource =
+"#version 400\n"
+"// Input data\n"
+"uniform int shape;\n" //0 circle, 1 rect, 2 arrow
+"in vec2 f_local;\n"
+"in vec4 f_color;\n"
+"// Output data\n"
+"out vec4 color;\n"
+"void main(void)\n"
+"{\n"
+"	float edgeDistance = 1.0f - (shape == 0 ? length(f_local) : max(abs(f_local.x), abs(f_local.y)));\n"
+"	if (edgeDistance < 0.0f)\n"
+"		discard;\n"
+"	color = vec4(0.5f * f_color.rgb, f_color.a);\n"
+"	if (shape != 2 && edgeDistance < length(fwidth(f_local)))\n"
+"		color = vec4(f_color.rgb, 1.0f);\n"
+"}\n";
@@ -30,6 +30,27 @@ namespace Elite
 		
 		void ForceElapsedUpperbound(bool force, float upperBound = 0.03f)
 		{ m_ForceElapsedUpperBound = force; m_ElapsedUpperBound = upperBound; }
+
+		//=== Fixed Timestep ===
+		//Update() adds the elapsed time to an accumulator that is consumed in ticks of a fixed length:
+		//while (TIMER->ConsumeTick()) { Simulate(TIMER->GetTickElapsed()); }
+		bool ConsumeTick();
+		void SetTickRate(float ticksPerSecond)
+		{ assert(ticksPerSecond > 0.f && "<ETimer::SetTickRate>: tick rate has to be positive"); m_TickElapsed = 1.f / ticksPerSecond; m_TickAccumulator = 0.f; }
+		float GetTickElapsed() const { return m_TickElapsed; }
+		//A frame that is too slow runs at most this many ticks and drops the rest, so it doesn't make the next frame slower as well
+		void SetMaxTicksPerFrame(unsigned int maxTicks) { m_MaxTicksPerFrame = maxTicks > 0 ? maxTicks : 1; }
+		//Part of a tick that is left in the accumulator: render state = previous tick + (current tick - previous tick) * alpha
+		float GetInterpolationAlpha() const { return m_IsFastForwarding ? 1.f : m_TickAccumulator / m_TickElapsed; }
+		unsigned int GetNrOfTicksThisFrame() const { return m_NrOfTicksThisFrame; }
+		unsigned long long GetNrOfTicks() const { return m_NrOfTicks; }
+		unsigned long long GetNrOfDroppedTicks() const { return m_NrOfDroppedTicks; }
+
+		//Simulation only: ticks run back to back, regardless of real time, until a frame has used frameBudget seconds.
+		//Only the last state of every batch gets rendered, meant for soak tests.
+		void SetFastForward(bool fastForward, float frameBudget = 0.1f)
+		{ m_IsFastForwarding = fastForward; m_FastForwardBudget = frameBudget; m_TickAccumulator = 0.f; }
+		bool IsFastForwarding() const { return m_IsFastForwarding; }
 	
 	private:
 		//=== Datamembers ===
@@ -51,6 +72,15 @@ namespace Elite
 		unsigned int m_FPS = 0;
 		unsigned int m_FPSCount = 0;
 		float m_FPSTimer = 0.0f;
+
+		float m_TickElapsed = 1.f / 60.f; //same as the physics rate, so a tick is one physics step
+		float m_TickAccumulator = 0.0f;
+		unsigned int m_MaxTicksPerFrame = 5;
+		unsigned int m_NrOfTicksThisFrame = 0;
+		unsigned long long m_NrOfTicks = 0;
+		unsigned long long m_NrOfDroppedTicks = 0;
+		bool m_IsFastForwarding = false;
+		float m_FastForwardBudget = 0.1f;
 	};
 }
 #endif
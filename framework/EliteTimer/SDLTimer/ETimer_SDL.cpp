@@ -70,6 +70,10 @@ void Elite::ETimer<PLATFORM_WINDOWS>::Update()
 
 	m_TotalTime = (float)(((m_CurrentTime - m_PausedTime) - m_BaseTime) * m_SecondsPerCount);
 
+	//FIXED TIMESTEP
+	m_TickAccumulator += m_ElapsedTime;
+	m_NrOfTicksThisFrame = 0;
+
 	//FPS LOGIC
 	m_FPSTimer += m_ElapsedTime;
 	++m_FPSCount;
@@ -81,6 +85,41 @@ void Elite::ETimer<PLATFORM_WINDOWS>::Update()
 	}
 }
 
+template<>
+bool Elite::ETimer<PLATFORM_WINDOWS>::ConsumeTick()
+{
+	if (m_IsStopped)
+		return false;
+
+	if (m_IsFastForwarding)
+	{
+		//At least one tick per frame, then as many as fit in the budget
+		const float frameTime = (float)((SDL_GetPerformanceCounter() - m_CurrentTime) * m_SecondsPerCount);
+		if (m_NrOfTicksThisFrame > 0 && frameTime >= m_FastForwardBudget)
+			return false;
+	}
+	else
+	{
+		if (m_TickAccumulator < m_TickElapsed)
+			return false;
+
+		//Spiral of death guard: drop whole ticks, keep the remainder so alpha stays continuous
+		if (m_NrOfTicksThisFrame >= m_MaxTicksPerFrame)
+		{
+			const unsigned int nrOfDropped = (unsigned int)(m_TickAccumulator / m_TickElapsed);
+			m_NrOfDroppedTicks += nrOfDropped;
+			m_TickAccumulator -= nrOfDropped * m_TickElapsed;
+			m_TickAccumulator = m_TickAccumulator < m_TickElapsed ? m_TickAccumulator : 0.f;
+			return false;
+		}
+		m_TickAccumulator -= m_TickElapsed;
+	}
+
+	++m_NrOfTicksThisFrame;
+	++m_NrOfTicks;
+	return true;
+}
+
 template<>
 void Elite::ETimer<PLATFORM_WINDOWS>::Stop()
 {
@@ -1,10 +1,11 @@
 #include "stdafx.h"
 #include "EImmediateUI.h"
 
-#ifdef PLATFORM_WINDOWS
+#if defined(PLATFORM_WINDOWS) && !defined(ELITE_HEADLESS)
 //Statics
 float Elite::EImmediateUI::m_sMouseWheel = 0.0f;
 bool Elite::EImmediateUI::m_sMousePressed[3] = { false, false, false };
+Elite::EImmediateUI::UIFrame* Elite::EImmediateUI::m_spCaptureFrame = nullptr;
 GLuint Elite::EImmediateUI::m_programID = 0;
 GLuint Elite::EImmediateUI::m_vboID = 0, Elite::EImmediateUI::m_vaoID = 0, Elite::EImmediateUI::m_elementsID = 0;
 GLint Elite::EImmediateUI::m_textureUniform = 0, Elite::EImmediateUI::m_projectionUniform = 0;
@@ -120,7 +121,18 @@ void Elite::EImmediateUI::Initialize(EliteRawWindow pWindow)
 
 void Elite::EImmediateUI::Render()
 {
+	SubmitFrame(0);
+	RenderFrame(0);
+}
+
+void Elite::EImmediateUI::SubmitFrame(int slot)
+{
+	assert(slot >= 0 && slot < ELITE_FRAMES_IN_FLIGHT && "<EImmediateUI::SubmitFrame>: invalid slot");
+	//ImGui skips the callback when there's nothing to draw, an empty display size keeps the slot from drawing old lists
+	m_spCaptureFrame = &m_Frames[slot];
+	m_spCaptureFrame->displaySize = ImVec2(0.f, 0.f);
 	ImGui::Render();
+	m_spCaptureFrame = nullptr;
 }
 
 void Elite::EImmediateUI::EventProcessing()
@@ -169,13 +181,36 @@ void Elite::EImmediateUI::EventProcessing()
 
 void Elite::EImmediateUI::StaticRender(ImDrawData* drawData)
 {
-	// Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
+	//Called from ImGui::Render, only copies: drawing happens in RenderFrame
+	if (!m_spCaptureFrame)
+		return;
+	UIFrame& frame = *m_spCaptureFrame;
 	ImGuiIO& io = ImGui::GetIO();
-	int fbWidth = (int)(io.DisplaySize.x * io.DisplayFramebufferScale.x);
-	int fbHeight = (int)(io.DisplaySize.y * io.DisplayFramebufferScale.y);
+	frame.displaySize = io.DisplaySize;
+	frame.framebufferScale = io.DisplayFramebufferScale;
+	frame.drawLists.resize(drawData->CmdListsCount);
+	drawData->ScaleClipRects(io.DisplayFramebufferScale);
+
+	for (int n = 0; n < drawData->CmdListsCount; n++)
+	{
+		const ImDrawList* cmd_list = drawData->CmdLists[n];
+		UIDrawList& drawList = frame.drawLists[n];
+		drawList.vertices.assign(cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Data + cmd_list->VtxBuffer.Size);
+		drawList.indices.assign(cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Data + cmd_list->IdxBuffer.Size);
+		drawList.commands.assign(cmd_list->CmdBuffer.Data, cmd_list->CmdBuffer.Data + cmd_list->CmdBuffer.Size);
+	}
+}
+
+void Elite::EImmediateUI::RenderFrame(int slot)
+{
+	assert(slot >= 0 && slot < ELITE_FRAMES_IN_FLIGHT && "<EImmediateUI::RenderFrame>: invalid slot");
+	const UIFrame& frame = m_Frames[slot];
+
+	// Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
+	int fbWidth = (int)(frame.displaySize.x * frame.framebufferScale.x);
+	int fbHeight = (int)(frame.displaySize.y * frame.framebufferScale.y);
 	if (fbWidth == 0 || fbHeight == 0)
 		return;
-	drawData->ScaleClipRects(io.DisplayFramebufferScale);
 
 	// Backup GL state
 	GLint last_program; glGetIntegerv(GL_CURRENT_PROGRAM, &last_program);
@@ -208,8 +243,8 @@ void Elite::EImmediateUI::StaticRender(ImDrawData* drawData)
 	glViewport(0, 0, (GLsizei)fbWidth, (GLsizei)fbHeight);
 	const float ortho_projection[4][4] =
 	{
-		{ 2.0f / io.DisplaySize.x, 0.0f,                   0.0f, 0.0f },
-		{ 0.0f,                  2.0f / -io.DisplaySize.y, 0.0f, 0.0f },
+		{ 2.0f / frame.displaySize.x, 0.0f,                   0.0f, 0.0f },
+		{ 0.0f,                  2.0f / -frame.displaySize.y, 0.0f, 0.0f },
 		{ 0.0f,                  0.0f,                  -1.0f, 0.0f },
 		{ -1.0f,                  1.0f,                   0.0f, 1.0f },
 	};
@@ -218,25 +253,21 @@ void Elite::EImmediateUI::StaticRender(ImDrawData* drawData)
 	glUniformMatrix4fv(m_projectionUniform, 1, GL_FALSE, &ortho_projection[0][0]);
 	glBindVertexArray(m_vaoID);
 
-	for (int n = 0; n < drawData->CmdListsCount; n++)
+	for (const UIDrawList& drawList : frame.drawLists)
 	{
-		const ImDrawList* cmd_list = drawData->CmdLists[n];
 		const ImDrawIdx* idx_buffer_offset = 0;
 
 		glBindBuffer(GL_ARRAY_BUFFER, m_vboID);
-		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert), (GLvoid*)cmd_list->VtxBuffer.Data, GL_STREAM_DRAW);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)drawList.vertices.size() * sizeof(ImDrawVert), (const GLvoid*)drawList.vertices.data(), GL_STREAM_DRAW);
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_elementsID);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), (GLvoid*)cmd_list->IdxBuffer.Data, GL_STREAM_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)drawList.indices.size() * sizeof(ImDrawIdx), (const GLvoid*)drawList.indices.data(), GL_STREAM_DRAW);
 
-		for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+		for (const ImDrawCmd& cmd : drawList.commands)
 		{
-			const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
-			if (pcmd->UserCallback)
-			{
-				pcmd->UserCallback(cmd_list, pcmd);
-			}
-			else
+			const ImDrawCmd* pcmd = &cmd;
+			//Callbacks expect the ImDrawList, which is gone by now (the framework doesn't add any)
+			if (!pcmd->UserCallback)
 			{
 				glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->TextureId);
 				glScissor((int)pcmd->ClipRect.x, (int)(fbHeight - pcmd->ClipRect.w), (int)(pcmd->ClipRect.z - pcmd->ClipRect.x), (int)(pcmd->ClipRect.w - pcmd->ClipRect.y));
@@ -11,7 +11,37 @@ struct ImDrawData;
 
 namespace Elite
 {
-#ifdef PLATFORM_WINDOWS
+#if defined(ELITE_HEADLESS)
+	//Nothing to draw in, frames are still built so apps can keep calling ImGui
+	class EImmediateUI final
+	{
+	public:
+		//--- Constructor & Destructor ---
+		EImmediateUI() = default;
+		~EImmediateUI() { ImGui::Shutdown(); }
+
+		//--- UI Functions ---
+		void Initialize(EliteRawWindow pWindow)
+		{
+			//ImGui needs the font atlas, it's never uploaded
+			unsigned char* pixels;
+			int width, height;
+			ImGui::GetIO().Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+		}
+		void Render() { ImGui::Render(); }
+		void EventProcessing() {}
+		static void StaticRender(ImDrawData* drawData) {}
+		void NewFrame(EliteRawWindow pWindow, float deltaTime)
+		{
+			const WindowParams params{};
+			ImGuiIO& io = ImGui::GetIO();
+			io.DisplaySize = ImVec2(float(params.width), float(params.height));
+			io.DeltaTime = deltaTime > 0.f ? deltaTime : 1.f / 60.f;
+			ImGui::NewFrame();
+		}
+		bool FocussedOnUI() { return false; }
+	};
+#elif defined(PLATFORM_WINDOWS)
 	class EImmediateUI final
 	{
 	public:
@@ -21,17 +51,35 @@ namespace Elite
 
 		//--- UI Functions ---
 		void Initialize(EliteRawWindow pWindow);
-		void Render();
+		void Render(); //SubmitFrame and RenderFrame in one go
+		void SubmitFrame(int slot); //ends the ImGui frame and copies its draw data in the slot
+		void RenderFrame(int slot); //draws a submitted slot, on the thread that owns the GL context
 		void EventProcessing();
 		static void StaticRender(ImDrawData* drawData);
 		void NewFrame(EliteRawWindow pWindow, float deltaTime);
 		bool FocussedOnUI();
 
 	private:
+		//ImGui reuses its draw lists next frame, a slot keeps its own copy
+		struct UIDrawList
+		{
+			std::vector<ImDrawVert> vertices;
+			std::vector<ImDrawIdx> indices;
+			std::vector<ImDrawCmd> commands;
+		};
+		struct UIFrame
+		{
+			std::vector<UIDrawList> drawLists;
+			ImVec2 displaySize;
+			ImVec2 framebufferScale;
+		};
+
 		//--- Datamembers ---
 		static float m_sMouseWheel;
 		static bool m_sMousePressed[3];
 		unsigned int m_atlasTextureID = 0;
+		UIFrame m_Frames[ELITE_FRAMES_IN_FLIGHT];
+		static UIFrame* m_spCaptureFrame; //slot StaticRender copies into
 
 		static GLuint m_programID;
 		static GLuint m_vboID, m_vaoID, m_elementsID;
@@ -47,7 +95,7 @@ namespace Elite
 		EImmediateUI(const EImmediateUI&) = default;
 		EImmediateUI& operator=(const EImmediateUI&) = default;
 	};
-#elif
+#else
 	class EImmediateUI final
 	{
 	public:
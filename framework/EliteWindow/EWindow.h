@@ -14,7 +14,10 @@ typedef void* EliteRawWindow;
 #include "EWindowBase.h"
 
 /* --- PLATFORM-SPECIFIC DEFINES & INCLUDES --- */
-#if (PLATFORM_ID == PLATFORM_WINDOWS)
+#if defined(ELITE_HEADLESS)
+	#include "NullWindow/NullWindow.h"
+	typedef Elite::NullWindow EliteWindow;
+#elif (PLATFORM_ID == PLATFORM_WINDOWS)
 	#include "SDLWindow/SDLWindow.h"
 	typedef Elite::SDLWindow EliteWindow;
 #elif (PLATFORM_ID == PLATFORM_PS4)
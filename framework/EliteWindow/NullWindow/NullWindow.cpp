@@ -0,0 +1,29 @@
+//=== General Includes ===
+#include "stdafx.h"
+#ifdef ELITE_HEADLESS
+#include "NullWindow.h"
+using namespace Elite;
+
+//=== Window Functions ===
+void NullWindow::CreateEWindow(const WindowParams& params)
+{
+	m_WindowParameters = params;
+	m_NrOfFrames = 0;
+}
+
+void NullWindow::ProcedureEWindow()
+{
+	//No events to poll, input only gets flushed
+	EInputManager::GetInstance()->Flush();
+
+	++m_NrOfFrames;
+	if (m_FrameLimit > 0 && m_NrOfFrames >= m_FrameLimit)
+		m_ShutdownRequested = true;
+}
+
+void NullWindow::ResizeEWindow(unsigned int width, unsigned int height)
+{
+	m_WindowParameters.width = width;
+	m_WindowParameters.height = height;
+}
+#endif
@@ -0,0 +1,39 @@
+/*=============================================================================*/
+// Copyright 2017-2018 Elite Engine
+// Authors: Matthieu Delaere
+/*=============================================================================*/
+// NullWindow.h: Window without a display, for headless runs (benchmarks, build servers).
+/*=============================================================================*/
+#ifndef ELITE_NULLWINDOW
+#define	ELITE_NULLWINDOW
+
+namespace Elite
+{
+	//Headless window, asks for shutdown by itself once the frame limit is reached
+	class NullWindow final : public EWindowBase<NullWindow>
+	{
+	public:
+		//=== Constructors & Destructors ===
+		NullWindow() = default;
+		~NullWindow() = default;
+
+		//=== Window Functions ===
+		void CreateEWindow(const WindowParams& params);
+		void SetWindowPosition(int x, int y) {}
+		void ProcedureEWindow();
+		void ResizeEWindow(unsigned int width, unsigned int height);
+		void RequestShutdown() { m_ShutdownRequested = true; }
+
+		//0 runs until RequestShutdown is called
+		void SetFrameLimit(unsigned int nrOfFrames) { m_FrameLimit = nrOfFrames; }
+		unsigned int GetNrOfFrames() const { return m_NrOfFrames; }
+
+		EliteRawWindow GetRawWindowHandle() const { return nullptr; };
+
+	private:
+		//=== Datamembers ===
+		unsigned int m_FrameLimit = 0;
+		unsigned int m_NrOfFrames = 0;
+	};
+}
+#endif
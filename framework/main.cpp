@@ -31,6 +31,12 @@ bool gRequestShutdown = false;
 int main(int argc, char* argv[])
 {
 	int x{}, y{};
+#ifdef ELITE_HEADLESS
+	//Soak runs opt in with a trailing --fast-forward, the other arguments stay as they are
+	const bool fastForward{ argc > 1 && string(argv[argc - 1]) == "--fast-forward" };
+	if (fastForward)
+		--argc;
+#endif
 	bool runExeWithCoordinates{ argc == 3 };
 
 	if (runExeWithCoordinates)
@@ -50,7 +56,17 @@ int main(int argc, char* argv[])
 		if (runExeWithCoordinates)
 			pWindow->SetWindowPosition(x, y);
 
-		//Create Frame (can later be extended by creating FrameManager for MultiThreaded Rendering)
+#ifdef ELITE_HEADLESS
+		//Headless runs stop by themselves, after the number of frames given as only argument
+		const unsigned int frameLimit = argc == 2 ? stoul(string(argv[1])) : 1000;
+		pWindow->SetFrameLimit(frameLimit);
+		//Soak runs: the simulation goes as fast as it can, each frame only renders the last tick of its batch.
+		//Frames then take the whole fast forward budget, so the frame stats below measure the simulation instead of rendering.
+		TIMER->SetFastForward(fastForward);
+		const auto runStart = std::chrono::high_resolution_clock::now();
+#endif
+
+		//Create Frame (draws on its own render thread once started)
 		EliteFrame* pFrame = new EliteFrame();
 		ELITE_ASSERT(pFrame, "Frame has not been created.");
 		pFrame->CreateFrame(pWindow);
@@ -92,6 +108,9 @@ int main(int argc, char* argv[])
 		//Boot application
 		myApp->Start();
 
+		//Everything that needs the GL context on this thread is created, from here on frames are drawn while the next one updates
+		pFrame->StartRenderThread();
+
 		//Application Loop
 		while (!pWindow->ShutdownRequested())
 		{
@@ -108,18 +127,42 @@ int main(int argc, char* argv[])
 			//New frame Immediate UI (Flush)
 			pImmediateUI->NewFrame(pWindow->GetRawWindowHandle(), elapsed);
 
-			//Update (Physics, App)
-			PHYSICSWORLD->Simulate(elapsed);
-			pCamera->Update();
-			myApp->Update(elapsed);
-
-			//Render and Present Frame
+			//Update (Camera, Physics, App) in fixed ticks, so the simulation doesn't depend on the frame rate
+			while (TIMER->ConsumeTick())
+			{
+				if (TIMER->GetNrOfTicksThisFrame() > 1)
+					INPUTMANAGER->ConsumeEvents();
+				pCamera->Update();
+				PHYSICSWORLD->Step(TIMER->GetTickElapsed());
+				myApp->Update(TIMER->GetTickElapsed());
+			}
+			if (TIMER->GetNrOfTicksThisFrame() == 0)
+				INPUTMANAGER->KeepEventsForNextFrame();
+
+			//Immediate UI once per frame, whatever the number of ticks
+			myApp->UpdateUI();
+
+			//Record and Submit Frame, the render thread presents it
 			PHYSICSWORLD->RenderDebug();
 			myApp->Render(elapsed);
 			pFrame->SubmitAndFlipFrame(pImmediateUI);
 		}
 
-		//Reversed Deletion
+#ifdef ELITE_HEADLESS
+		//Throughput of the run, there's no window to show it in
+		const double runTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - runStart).count();
+		const unsigned int nrOfFrames = DEBUGRENDERER2D->GetNrOfFrames();
+		const auto& totals = DEBUGRENDERER2D->GetTotalStats();
+		const double perFrame = nrOfFrames > 0 ? 1.0 / nrOfFrames : 0.0;
+		printf("%u frames in %.3f s: %.3f ms/frame, %.0f vertices/frame, %.0f instances/frame, %.1f draw calls/frame, %.2f M vertices/s\n",
+			nrOfFrames, runTime, runTime * 1000.0 * perFrame, totals.nrOfVertices * perFrame, totals.nrOfShapeInstances * perFrame,
+			totals.nrOfDrawCalls * perFrame, runTime > 0.0 ? totals.nrOfVertices / runTime / 1e6 : 0.0);
+		printf("%llu ticks: %.0f ticks/s, %.1f simulated seconds per real second\n", TIMER->GetNrOfTicks(),
+			runTime > 0.0 ? TIMER->GetNrOfTicks() / runTime : 0.0, runTime > 0.0 ? TIMER->GetNrOfTicks() * TIMER->GetTickElapsed() / runTime : 0.0);
+#endif
+
+		//Reversed Deletion, the context comes back to this thread first
+		pFrame->StopRenderThread();
 		SAFE_DELETE(myApp);
 		SAFE_DELETE(pImmediateUI);
 		SAFE_DELETE(pCamera);
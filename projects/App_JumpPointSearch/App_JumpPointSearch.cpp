@@ -6,12 +6,14 @@
 #include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EJPS.h"
 #include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EAStar.h"
 #include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EBFS.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EThetaStar.h"
 
 using namespace Elite;
 
 //Destructor
 App_PathfindingJPS::~App_PathfindingJPS()
 {
+	SAFE_DELETE(m_pLineOfSight);
 	SAFE_DELETE(m_pGridGraph);
 }
 
@@ -27,6 +29,9 @@ void App_PathfindingJPS::Start()
 	//Create Graph
 	MakeGridGraph();
 
+	//Line of sight checks are cached, share them between smoothing and Theta*
+	m_pLineOfSight = new GridLineOfSight<GridTerrainNode, GraphConnection>(m_pGridGraph);
+
 	startPathIdx = 0;
 	endPathIdx = 7;
 }
@@ -63,10 +68,6 @@ void App_PathfindingJPS::Update(float deltaTime)
 		m_UpdatePath = true;
 	}
 
-	//IMGUI
-	UpdateImGui();
-
-
 	//CALCULATEPATH
 	//If we have nodes and the target is not the startNode, find a path!
 	if (m_UpdatePath
@@ -80,9 +81,11 @@ void App_PathfindingJPS::Update(float deltaTime)
 		auto endNode = m_pGridGraph->GetNode(endPathIdx);
 
 		auto pathfinder = JPS<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
+		pathfinder.SetMinClearance(m_MinClearance);
 		auto jumpPoints = pathfinder.FindPath(startNode, endNode);
 
 		auto aStarPathfinder = AStar<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
+		aStarPathfinder.SetMinClearance(m_MinClearance);
 		std::vector<GridTerrainNode*> JumpPath;
 		m_vPath.clear();
 		if (jumpPoints.size() >= 2)
@@ -96,6 +99,21 @@ void App_PathfindingJPS::Update(float deltaTime)
 
 		m_vJumpPoints = pathfinder.GetJumpPoints();
 
+		if (m_bUseThetaStar)
+		{
+			auto thetaStar = ThetaStar<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction, m_pLineOfSight);
+			thetaStar.SetLazy(true);
+			m_vWaypoints = thetaStar.FindPath(startNode, endNode);
+		}
+		else if (m_bSmoothPath)
+		{
+			m_vWaypoints = m_pLineOfSight->SmoothPath(m_vPath);
+		}
+		else
+		{
+			m_vWaypoints.clear();
+		}
+
 		m_UpdatePath = false;
 		std::cout << "New Path Calculated" << std::endl;
 	}
@@ -131,6 +149,12 @@ void App_PathfindingJPS::Render(float deltaTime) const
 		m_GraphRenderer.RenderHighlightedGrid(m_pGridGraph, m_vPath);
 	}
 
+	//render any-angle path
+	for (size_t idx = 1; idx < m_vWaypoints.size(); ++idx)
+	{
+		DEBUGRENDERER2D->DrawSegment(m_pGridGraph->GetNodeWorldPos(m_vWaypoints[idx - 1]), m_pGridGraph->GetNodeWorldPos(m_vWaypoints[idx]), Elite::Color{ 0.f, 0.f, 1.f });
+	}
+
 	//render jumpPoints
 	Elite::Color color{ 0,0,0 };
 	for(GridTerrainNode* node : m_vJumpPoints)
@@ -155,7 +179,7 @@ void App_PathfindingJPS::MakeGridGraph()
 	//m_pGridGraph->GetNode(7)->SetTerrainType(TerrainType::Mud);
 }
 
-void App_PathfindingJPS::UpdateImGui()
+void App_PathfindingJPS::UpdateUI()
 {
 #ifdef PLATFORM_WINDOWS
 #pragma region UI
@@ -184,6 +208,7 @@ void App_PathfindingJPS::UpdateImGui()
 		ImGui::Indent();
 		ImGui::Text("%.3f ms/frame", 1000.0f / ImGui::GetIO().Framerate);
 		ImGui::Text("%.1f FPS", ImGui::GetIO().Framerate);
+		ImGui::Text("Waypoints: %d", int(m_vWaypoints.size()));
 		ImGui::Unindent();
 
 		/*Spacing*/ImGui::Spacing(); ImGui::Separator(); ImGui::Spacing(); ImGui::Spacing();
@@ -208,6 +233,12 @@ void App_PathfindingJPS::UpdateImGui()
 		ImGui::Checkbox("NodeNumbers", &m_bDrawNodeNumbers);
 		ImGui::Checkbox("Connections", &m_bDrawConnections);
 		ImGui::Checkbox("Connections Costs", &m_bDrawConnectionsCosts);
+		if (ImGui::Checkbox("Smooth path", &m_bSmoothPath))
+			m_UpdatePath = true;
+		if (ImGui::Checkbox("Theta*", &m_bUseThetaStar))
+			m_UpdatePath = true;
+		if (ImGui::SliderInt("Min clearance", &m_MinClearance, 0, 4))
+			m_UpdatePath = true;
 		//if (ImGui::Combo("", &m_SelectedHeuristic, "Manhattan\0Euclidean\0SqrtEuclidean\0Octile\0Chebyshev", 4))
 		//{
 		//	switch (m_SelectedHeuristic)
@@ -6,6 +6,7 @@
 //-----------------------------------------------------------------
 #include "framework/EliteInterfaces/EIApp.h"
 #include "framework\EliteAI\EliteGraphs\EGridGraph.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EGridLineOfSight.h"
 #include "framework\EliteAI\EliteGraphs\EliteGraphUtilities\EGraphEditor.h"
 #include "framework\EliteAI\EliteGraphs\EliteGraphUtilities\EGraphRenderer.h"
 
@@ -23,6 +24,7 @@ public:
 	//App Functions
 	void Start() override;
 	void Update(float deltaTime) override;
+	void UpdateUI() override;
 	void Render(float deltaTime) const override;
 
 private:
@@ -43,7 +45,12 @@ private:
 	int endPathIdx = invalid_node_index;
 	std::vector<Elite::GridTerrainNode*> m_vPath;
 	std::vector<Elite::GridTerrainNode*> m_vJumpPoints;
+	std::vector<Elite::GridTerrainNode*> m_vWaypoints; // any-angle corners, only filled when smoothing or Theta* is on
 	bool m_UpdatePath = true;
+	Elite::GridLineOfSight<Elite::GridTerrainNode, Elite::GraphConnection>* m_pLineOfSight = nullptr;
+	bool m_bSmoothPath = false;
+	bool m_bUseThetaStar = false;
+	int m_MinClearance = 0; // agent size for JPS and A*, see GridGraph::GetClearance
 
 	//Editor and Visualisation
 	Elite::EGraphEditor m_GraphEditor{};
@@ -60,7 +67,6 @@ private:
 
 	//Functions
 	void MakeGridGraph();
-	void UpdateImGui();
 
 	//C++ make the class non-copyable
 	App_PathfindingJPS(const App_PathfindingJPS&) = delete;
@@ -11,6 +11,10 @@ using namespace Elite;
 //Destructor
 App_PathfindingAStar::~App_PathfindingAStar()
 {
+	SAFE_DELETE(m_pFlowField);
+	SAFE_DELETE(m_pHierarchicalPlanner);
+	SAFE_DELETE(m_pIncrementalPlanner);
+	SAFE_DELETE(m_pPathCache);
 	SAFE_DELETE(m_pGridGraph);
 }
 
@@ -26,6 +30,25 @@ void App_PathfindingAStar::Start()
 	//Create Graph
 	MakeGridGraph();
 
+	//Create path cache in front of A*, repeated queries are served from the cache until a region on their path is edited
+	m_pPathCache = new PathCache<GridTerrainNode, GraphConnection>(m_pGridGraph,
+		[this](GridTerrainNode* pStartNode, GridTerrainNode* pEndNode)
+		{
+			auto pathfinder = AStar<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
+			pathfinder.SetOpenList(m_bUseBucketQueue ? OpenList::bucketQueue : OpenList::linearScan);
+			pathfinder.SetBidirectional(m_bUseBidirectionalSearch);
+			return pathfinder.FindPath(pStartNode, pEndNode);
+		});
+
+	//Create incremental planner, keeps its search between calls and only repairs what the grid edits affected
+	m_pIncrementalPlanner = new DStarLite<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
+
+	//Create hierarchical planner, searches an abstract graph of 5x5 clusters and refines the result on the grid
+	m_pHierarchicalPlanner = new HPAStar<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction, 5);
+
+	//Create flow fields, every cell points towards the end node
+	m_pFlowField = new FlowField<GridTerrainNode, GraphConnection>(m_pGridGraph);
+
 	startPathIdx = 0;
 	endPathIdx = 7;
 }
@@ -62,24 +85,50 @@ void App_PathfindingAStar::Update(float deltaTime)
 		m_UpdatePath = true;
 	}
 
-	//IMGUI
-	UpdateImGui();
-
+	//Pick up a finished background search, it returns node indices because it ran on its own snapshot
+	if (m_BackgroundSearch.valid() && m_BackgroundSearch.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		m_vPath.clear();
+		for (int idx : m_BackgroundSearch.get())
+			m_vPath.push_back(m_pGridGraph->GetNode(idx));
+	}
 
 	//CALCULATEPATH
 	//If we have nodes and the target is not the startNode, find a path!
+	//Only one background search runs at a time, edits made while it runs start the next one once it's done
 	if (m_UpdatePath 
 		&& startPathIdx != invalid_node_index
 		&& endPathIdx != invalid_node_index
-		&& startPathIdx != endPathIdx)
+		&& startPathIdx != endPathIdx
+		&& !m_BackgroundSearch.valid())
 	{
 		//BFS Pathfinding
 		//auto pathfinder = BFS<GridTerrainNode, GraphConnection>(m_pGridGraph);
 		auto startNode = m_pGridGraph->GetNode(startPathIdx);
 		auto endNode = m_pGridGraph->GetNode(endPathIdx);
 
-		auto pathfinder = AStar<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
-		m_vPath = pathfinder.FindPath(startNode, endNode);
+		if (m_bUseIncrementalPlanner)
+			m_vPath = m_pIncrementalPlanner->FindPath(startNode, endNode);
+		else if (m_bUseHierarchicalPlanner)
+			m_vPath = m_pHierarchicalPlanner->FindPath(startNode, endNode);
+		else if (m_bUseBackgroundSearch)
+		{
+			//Cloning shares the grid's chunks, only the ones the editor touches while the search runs get copied
+			shared_ptr<IGraph<GridTerrainNode, GraphConnection>> pSnapshot = m_pGridGraph->Clone();
+			Heuristic heuristicFunction = m_pHeuristicFunction;
+			int startIdx = startPathIdx;
+			int endIdx = endPathIdx;
+			m_BackgroundSearch = std::async(std::launch::async, [pSnapshot, heuristicFunction, startIdx, endIdx]()
+			{
+				auto pathfinder = AStar<GridTerrainNode, GraphConnection>(pSnapshot.get(), heuristicFunction);
+				std::vector<int> path;
+				for (auto pNode : pathfinder.FindPath(pSnapshot->GetNode(startIdx), pSnapshot->GetNode(endIdx)))
+					path.push_back(pNode->GetIndex());
+				return path;
+			});
+		}
+		else
+			m_vPath = m_pPathCache->FindPath(startNode, endNode);
 
 
 		m_UpdatePath = false;
@@ -116,6 +165,17 @@ void App_PathfindingAStar::Render(float deltaTime) const
 	{
 		m_GraphRenderer.RenderHighlightedGrid(m_pGridGraph, m_vPath);
 	}
+
+	//Render flow field towards the end node
+	if (m_bDrawFlowField && endPathIdx != invalid_node_index)
+	{
+		const std::vector<Elite::Vector2>& directions = m_pFlowField->GetDirections(m_pGridGraph->GetNode(endPathIdx));
+		for (int idx = 0; idx < m_pGridGraph->GetNrOfNodes(); ++idx)
+		{
+			if (directions[idx] != Elite::ZeroVector2)
+				DEBUGRENDERER2D->DrawDirection(m_pGridGraph->GetNodeWorldPos(idx), directions[idx], m_SizeCell * 0.4f, Elite::Color{ 0.2f, 0.2f, 0.2f });
+		}
+	}
 	
 }
 
@@ -134,7 +194,7 @@ void App_PathfindingAStar::MakeGridGraph()
 	//m_pGridGraph->GetNode(7)->SetTerrainType(TerrainType::Mud);
 }
 
-void App_PathfindingAStar::UpdateImGui()
+void App_PathfindingAStar::UpdateUI()
 {
 #ifdef PLATFORM_WINDOWS
 #pragma region UI
@@ -163,6 +223,15 @@ void App_PathfindingAStar::UpdateImGui()
 		ImGui::Indent();
 		ImGui::Text("%.3f ms/frame", 1000.0f / ImGui::GetIO().Framerate);
 		ImGui::Text("%.1f FPS", ImGui::GetIO().Framerate);
+		ImGui::Text("Cache hits: %.0f%%", m_pPathCache->GetHitRate() * 100.f);
+		ImGui::Text("Cache: %.1f KB", m_pPathCache->GetMemoryUsage() / 1024.f);
+		ImGui::Text("Evicted: %u", m_pPathCache->GetEvictions());
+		ImGui::Text("Invalidated: %u", m_pPathCache->GetInvalidations());
+		ImGui::Text("D* expanded: %d", m_pIncrementalPlanner->GetNrOfExpandedNodes());
+		ImGui::Text("HPA* rebuild: %.3f ms", m_pHierarchicalPlanner->GetBuildTime());
+		ImGui::Text("HPA* clusters: %d", m_pHierarchicalPlanner->GetNrOfRebuiltClusters());
+		ImGui::Text("Streamed: %.1fk verts", DEBUGRENDERER2D->GetNrOfStreamedVertices() / 1000.f);
+		ImGui::Text("Stream stalls: %u", DEBUGRENDERER2D->GetNrOfStreamStalls());
 		ImGui::Unindent();
 
 		/*Spacing*/ImGui::Spacing(); ImGui::Separator(); ImGui::Spacing(); ImGui::Spacing();
@@ -187,6 +256,23 @@ void App_PathfindingAStar::UpdateImGui()
 		ImGui::Checkbox("NodeNumbers", &m_bDrawNodeNumbers);
 		ImGui::Checkbox("Connections", &m_bDrawConnections);
 		ImGui::Checkbox("Connections Costs", &m_bDrawConnectionsCosts);
+		ImGui::Checkbox("Flow Field", &m_bDrawFlowField);
+		if (ImGui::Checkbox("Incremental (D*)", &m_bUseIncrementalPlanner))
+			m_UpdatePath = true;
+		if (ImGui::Checkbox("Hierarchical (HPA*)", &m_bUseHierarchicalPlanner))
+			m_UpdatePath = true;
+		if (ImGui::Checkbox("Background search", &m_bUseBackgroundSearch))
+			m_UpdatePath = true;
+		if (ImGui::Checkbox("Bucket queue", &m_bUseBucketQueue))
+		{
+			m_pPathCache->Clear();
+			m_UpdatePath = true;
+		}
+		if (ImGui::Checkbox("Bidirectional", &m_bUseBidirectionalSearch))
+		{
+			m_pPathCache->Clear();
+			m_UpdatePath = true;
+		}
 		if (ImGui::Combo("", &m_SelectedHeuristic, "Manhattan\0Euclidean\0SqrtEuclidean\0Octile\0Chebyshev", 4))
 		{
 			switch (m_SelectedHeuristic)
@@ -210,6 +296,14 @@ void App_PathfindingAStar::UpdateImGui()
 				m_pHeuristicFunction = HeuristicFunctions::Chebyshev;
 				break;
 			}
+
+			//Cached paths and the incremental search were built with the previous heuristic
+			m_pPathCache->Clear();
+			SAFE_DELETE(m_pIncrementalPlanner);
+			m_pIncrementalPlanner = new DStarLite<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
+			SAFE_DELETE(m_pHierarchicalPlanner);
+			m_pHierarchicalPlanner = new HPAStar<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction, 5);
+			m_UpdatePath = true;
 		}
 		ImGui::Spacing();
 
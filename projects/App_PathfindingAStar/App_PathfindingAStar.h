@@ -5,8 +5,13 @@
 //-----------------------------------------------------------------
 #include "framework/EliteInterfaces/EIApp.h"
 #include "framework\EliteAI\EliteGraphs\EGridGraph.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EPathCache.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EDStarLite.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EHPAStar.h"
+#include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EFlowField.h"
 #include "framework\EliteAI\EliteGraphs\EliteGraphUtilities\EGraphEditor.h"
 #include "framework\EliteAI\EliteGraphs\EliteGraphUtilities\EGraphRenderer.h"
+#include <future>
 
 
 //-----------------------------------------------------------------
@@ -22,6 +27,7 @@ public:
 	//App Functions
 	void Start() override;
 	void Update(float deltaTime) override;
+	void UpdateUI() override;
 	void Render(float deltaTime) const override;
 
 private:
@@ -42,6 +48,17 @@ private:
 	int endPathIdx = invalid_node_index;
 	std::vector<Elite::GridTerrainNode*> m_vPath;
 	bool m_UpdatePath = true;
+	Elite::PathCache<Elite::GridTerrainNode, Elite::GraphConnection>* m_pPathCache = nullptr;
+	Elite::DStarLite<Elite::GridTerrainNode, Elite::GraphConnection>* m_pIncrementalPlanner = nullptr;
+	bool m_bUseIncrementalPlanner = false;
+	Elite::HPAStar<Elite::GridTerrainNode, Elite::GraphConnection>* m_pHierarchicalPlanner = nullptr;
+	bool m_bUseHierarchicalPlanner = false;
+	bool m_bUseBucketQueue = false;
+	bool m_bUseBidirectionalSearch = false;
+	Elite::FlowField<Elite::GridTerrainNode, Elite::GraphConnection>* m_pFlowField = nullptr;
+	//A* on a snapshot of the grid on another thread, the grid can be edited while it runs
+	bool m_bUseBackgroundSearch = false;
+	std::future<std::vector<int>> m_BackgroundSearch;
 
 	//Editor and Visualisation
 	Elite::EGraphEditor m_GraphEditor{};
@@ -52,13 +69,13 @@ private:
 	bool m_bDrawNodeNumbers = false;
 	bool m_bDrawConnections = false;
 	bool m_bDrawConnectionsCosts = false;
+	bool m_bDrawFlowField = false;
 	bool m_StartSelected = true;
 	int m_SelectedHeuristic = 4;
 	Elite::Heuristic m_pHeuristicFunction = Elite::HeuristicFunctions::Chebyshev;
 
 	//Functions
 	void MakeGridGraph();
-	void UpdateImGui();
 
 	//C++ make the class non-copyable
 	App_PathfindingAStar(const App_PathfindingAStar&) = delete;
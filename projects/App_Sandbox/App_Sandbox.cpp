@@ -3,33 +3,127 @@
 
 //Includes
 #include "App_Sandbox.h"
-#include "SandboxAgent.h"
+
+//Statics
+namespace
+{
+	//Crowd sizes to compare the kinematic mode against Box2D
+	const int NrOfAgentsOptions[] = { 100, 1000, 10000, 50000 };
+}
 
 //Destructor
 App_Sandbox::~App_Sandbox()
 {
-	SAFE_DELETE(m_pAgent);
+	SAFE_DELETE(m_pAgents);
 }
 
 //Functions
 void App_Sandbox::Start()
 {
-	m_pAgent = new SandboxAgent();
+	CreateAgents();
 }
 
 void App_Sandbox::Update(float deltaTime)
 {
+	const auto startTime = std::chrono::high_resolution_clock::now();
+
+	//Positions after this tick's physics step, kinematic agents take that step themselves
+	if (m_bKinematic)
+	{
+		m_pAgents->Integrate(deltaTime);
+		m_pAgents->Separate(1.f);
+	}
+	else
+		m_pAgents->ReadFromBodies();
+
 	if (INPUTMANAGER->IsMouseButtonUp(Elite::InputMouseButton::eLeft))
 	{
 		const auto mouseData = INPUTMANAGER->GetMouseData(Elite::InputType::eMouseButton, Elite::InputMouseButton::eLeft);
 		const Elite::Vector2  mousePos{ float(mouseData.X), float(mouseData.Y) };
-		m_pAgent->SetTarget(DEBUGRENDERER2D->GetActiveCamera()->ConvertScreenToWorld(mousePos));
+		const Elite::Vector2 target = DEBUGRENDERER2D->GetActiveCamera()->ConvertScreenToWorld(mousePos);
+		for (int agent = 0; agent < m_pAgents->GetNrOfAgents(); ++agent)
+			m_pAgents->SetTarget(agent, target + m_FormationOffsets[agent]);
 	}
 
-	m_pAgent->Update(deltaTime);
+	//Arrive for every agent in one pass, then one batch write to physics
+	m_pAgents->Arrive(15.f, 1.f);
+	if (!m_bKinematic)
+		m_pAgents->WriteToBodies();
+
+	m_AgentsUpdateTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
 }
 
 void App_Sandbox::Render(float deltaTime) const
 {
-	m_pAgent->Render(deltaTime);
+	m_pAgents->Render(TIMER->GetInterpolationAlpha(), { 1,1,0,1 });
+}
+
+void App_Sandbox::CreateAgents()
+{
+	SAFE_DELETE(m_pAgents);
+	m_pAgents = new Elite::AgentSystem(m_bKinematic ? Elite::AgentSimulation::eKinematic : Elite::AgentSimulation::ePhysics);
+
+	const int nrOfAgents = NrOfAgentsOptions[m_SelectedNrOfAgents];
+	const int nrOfAgentsPerSide = static_cast<int>(ceilf(sqrtf(static_cast<float>(nrOfAgents))));
+	const float spacing = 3.f;
+	const float offset = (nrOfAgentsPerSide - 1) * spacing * 0.5f;
+	m_FormationOffsets.clear();
+	for (int agent = 0; agent < nrOfAgents; ++agent)
+	{
+		m_FormationOffsets.push_back({ agent % nrOfAgentsPerSide * spacing - offset, agent / nrOfAgentsPerSide * spacing - offset });
+		m_pAgents->AddAgent(m_FormationOffsets.back(), 1.f, 50.f);
+	}
+}
+
+void App_Sandbox::UpdateUI()
+{
+#ifdef PLATFORM_WINDOWS
+#pragma region UI
+	//UI
+	{
+		//Setup
+		int menuWidth = 115;
+		int const width = DEBUGRENDERER2D->GetActiveCamera()->GetWidth();
+		int const height = DEBUGRENDERER2D->GetActiveCamera()->GetHeight();
+		bool windowActive = true;
+		ImGui::SetNextWindowPos(ImVec2((float)width - menuWidth - 10, 10));
+		ImGui::SetNextWindowSize(ImVec2((float)menuWidth, (float)height - 20));
+		ImGui::Begin("Gameplay Programming", &windowActive, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
+		ImGui::PushAllowKeyboardFocus(false);
+
+		//Elements
+		ImGui::Text("CONTROLS");
+		ImGui::Indent();
+		ImGui::Text("LMB: target");
+		ImGui::Unindent();
+
+		/*Spacing*/ImGui::Spacing();ImGui::Separator();ImGui::Spacing();ImGui::Spacing();
+
+		ImGui::Text("STATS");
+		ImGui::Indent();
+		ImGui::Text("%.3f ms/frame", 1000.0f / ImGui::GetIO().Framerate);
+		ImGui::Text("%.1f FPS", ImGui::GetIO().Framerate);
+		ImGui::Text("Agents: %d", m_pAgents->GetNrOfAgents());
+		ImGui::Text("Steering: %.3f ms", m_AgentsUpdateTime);
+		ImGui::Text("Physics: %.3f ms", PHYSICSWORLD->GetStepTime());
+		ImGui::Unindent();
+
+		/*Spacing*/ImGui::Spacing(); ImGui::Separator(); ImGui::Spacing(); ImGui::Spacing();
+
+		ImGui::Text("Crowd");
+		ImGui::Spacing();
+
+		//Both change the whole crowd
+		bool recreate = ImGui::Combo("", &m_SelectedNrOfAgents, "100\0" "1000\0" "10000\0" "50000\0", 4);
+		recreate |= ImGui::Checkbox("Kinematic", &m_bKinematic);
+		if (recreate)
+			CreateAgents();
+		ImGui::Spacing();
+
+		//End
+		ImGui::PopAllowKeyboardFocus();
+		ImGui::End();
+	}
+#pragma endregion
+#endif
 }
\ No newline at end of file
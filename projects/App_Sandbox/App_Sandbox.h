@@ -4,9 +4,9 @@
 // Includes & Forward Declarations
 //-----------------------------------------------------------------
 #include "framework/EliteInterfaces/EIApp.h"
+#include "framework/EliteAI/EliteAgents/EAgentSystem.h"
 
 class Renderer;
-class SandboxAgent;
 
 //-----------------------------------------------------------------
 // Application
@@ -21,10 +21,18 @@ public:
 	//App Functions
 	void Start() override;
 	void Update(float deltaTime) override;
+	void UpdateUI() override;
 	void Render(float deltaTime) const override;
 
 private:
-	SandboxAgent* m_pAgent = nullptr;
+	//Agents in a square formation, the formation arrives at the clicked position
+	Elite::AgentSystem* m_pAgents = nullptr;
+	std::vector<Elite::Vector2> m_FormationOffsets;
+	int m_SelectedNrOfAgents = 0;
+	bool m_bKinematic = false;
+	float m_AgentsUpdateTime = 0.f; //ms spent in the last Update
+
+	void CreateAgents();
 
 	//C++ make the class non-copyable
 	App_Sandbox(const App_Sandbox&) = delete;
@@ -26,19 +26,11 @@ void BaseAgent::Update(float dt)
 
 void BaseAgent::Render(float dt)
 {
-	auto o = GetRotation() - E_PI_2;
-	auto p = GetPosition();
-	auto r = Elite::ToRadians(150.f);
-
-	//EliteDebugRenderer2D::GetInstance()->DrawSolidCircle(GetPosition(), m_Radius, { 0,0 }, m_BodyColor);
-	DEBUGRENDERER2D->DrawSolidCircle(GetPosition(), m_Radius, { 0,0 }, m_BodyColor);
-
-	vector<Elite::Vector2> points;
-	points.push_back(Elite::Vector2(static_cast<float>(cos(o)), static_cast<float>(sin(o)) * m_Radius) + p);
-	points.push_back(Elite::Vector2(static_cast<float>(cos(o + r)), static_cast<float>(sin(o + r))*m_Radius) + p);
-	points.push_back(Elite::Vector2(static_cast<float>(cos(o - r)), static_cast<float>(sin(o - r))*m_Radius) + p);
-
-	DEBUGRENDERER2D->DrawSolidPolygon(&points[0], 3, { 0,0,0,1 }, DEBUGRENDERER2D->NextDepthSlice());
+	//Body and the arrow on top of it, both expanded on the GPU, in between the last two fixed ticks
+	const float alpha = TIMER->GetInterpolationAlpha();
+	const auto p = m_pRigidBody->GetInterpolatedPosition(alpha);
+	DEBUGRENDERER2D->DrawSolidCircleInstance(p, m_Radius, m_BodyColor, DEBUGRENDERER2D->NextDepthSlice());
+	DEBUGRENDERER2D->DrawArrowInstance(p, m_Radius, m_pRigidBody->GetInterpolatedRotation(alpha).x, { 0,0,0,1 }, DEBUGRENDERER2D->NextDepthSlice());
 }
 
 void BaseAgent::TrimToWorld(const Elite::Vector2& bounds) const
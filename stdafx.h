@@ -121,6 +121,7 @@ extern bool gRequestShutdown;
 /* --- DEFINES --- */
 #define USE_BOX2D
 #define USE_VLD
+//#define ELITE_HEADLESS //null window, frame and debug renderer: no display needed, draws are only counted. Args: [frames] [--fast-forward]
 
 /* --- PLATFORMS --- */
 #define PLATFORM_WINDOWS 0